@@ -6,7 +6,13 @@ Configuration::Configuration(
 		std::vector<int>& excluded_lines, std::string directory, int limit)
   :inputfile_name_(inputfile_name), mutant_database_filename_(mutation_db_filename), 
   mutation_range_start_loc_(start_loc), mutation_range_end_loc_(end_loc), 
-  output_directory_(directory), limit_num_of_mutant_(limit) 
+  output_directory_(directory), limit_num_of_mutant_(limit),
+  patch_output_(false), database_formats_{"csv"}, schemata_output_(false), tce_(false),
+  incremental_(false), use_changed_lines_(false), sample_seed_(0),
+  mutant_budget_(0), stratify_by_operator_(false),
+  stratify_by_function_(false), stratify_by_line_(false), count_only_(false),
+  sharded_layout_(false), pack_output_(false), pack_compressed_(false),
+  stable_ids_(false), mutation_options_hash_(0)
 { 
   excluded_lines_ = std::vector<int>(excluded_lines);
 } 
@@ -44,4 +50,180 @@ int Configuration::getLimitNumOfMutants()
 std::vector<int>& Configuration::getExcludedLines()
 {
   return excluded_lines_;
-}
\ No newline at end of file
+}
+
+bool Configuration::getPatchOutput() const
+{
+  return patch_output_;
+}
+
+void Configuration::setPatchOutput(bool patch_output)
+{
+  patch_output_ = patch_output;
+}
+
+const std::vector<std::string>& Configuration::getDatabaseFormats() const
+{
+  return database_formats_;
+}
+
+void Configuration::setDatabaseFormats(
+    const std::vector<std::string> &database_formats)
+{
+  database_formats_ = database_formats;
+}
+
+bool Configuration::getSchemataOutput() const
+{
+  return schemata_output_;
+}
+
+void Configuration::setSchemataOutput(bool schemata_output)
+{
+  schemata_output_ = schemata_output;
+}
+
+bool Configuration::getTce() const
+{
+  return tce_;
+}
+
+void Configuration::setTce(bool tce)
+{
+  tce_ = tce;
+}
+
+bool Configuration::getIncremental() const
+{
+  return incremental_;
+}
+
+void Configuration::setIncremental(bool incremental)
+{
+  incremental_ = incremental;
+}
+
+bool Configuration::getUseChangedLines() const
+{
+  return use_changed_lines_;
+}
+
+const std::vector<LineRange>& Configuration::getChangedLines() const
+{
+  return changed_lines_;
+}
+
+void Configuration::setChangedLines(const std::vector<LineRange> &changed_lines)
+{
+  use_changed_lines_ = true;
+  changed_lines_ = changed_lines;
+}
+
+uint64_t Configuration::getSampleSeed() const
+{
+  return sample_seed_;
+}
+
+void Configuration::setSampleSeed(uint64_t sample_seed)
+{
+  sample_seed_ = sample_seed;
+}
+
+unsigned Configuration::getMutantBudget() const
+{
+  return mutant_budget_;
+}
+
+void Configuration::setMutantBudget(unsigned mutant_budget)
+{
+  mutant_budget_ = mutant_budget;
+}
+
+bool Configuration::getStratifyByOperator() const
+{
+  return stratify_by_operator_;
+}
+
+bool Configuration::getStratifyByFunction() const
+{
+  return stratify_by_function_;
+}
+
+bool Configuration::getStratifyByLine() const
+{
+  return stratify_by_line_;
+}
+
+void Configuration::setStratification(bool by_operator, bool by_function,
+                                      bool by_line)
+{
+  stratify_by_operator_ = by_operator;
+  stratify_by_function_ = by_function;
+  stratify_by_line_ = by_line;
+}
+
+bool Configuration::getCountOnly() const
+{
+  return count_only_;
+}
+
+void Configuration::setCountOnly(bool count_only)
+{
+  count_only_ = count_only;
+}
+
+bool Configuration::getShardedLayout() const
+{
+  return sharded_layout_;
+}
+
+void Configuration::setShardedLayout(bool sharded_layout)
+{
+  sharded_layout_ = sharded_layout;
+}
+
+bool Configuration::getPackOutput() const
+{
+  return pack_output_;
+}
+
+bool Configuration::getPackCompressed() const
+{
+  return pack_compressed_;
+}
+
+void Configuration::setPackOutput(bool pack_output, bool compressed)
+{
+  pack_output_ = pack_output;
+  pack_compressed_ = compressed;
+}
+
+bool Configuration::getStableIds() const
+{
+  return stable_ids_;
+}
+
+void Configuration::setStableIds(bool stable_ids)
+{
+  stable_ids_ = stable_ids;
+}
+
+uint64_t Configuration::getMutationOptionsHash() const
+{
+  return mutation_options_hash_;
+}
+
+void Configuration::setMutationOptionsHash(uint64_t mutation_options_hash)
+{
+  mutation_options_hash_ = mutation_options_hash;
+}
+
+const std::string& Configuration::getInputFilePath() const
+{
+  return input_file_path_;
+}
+
+void Configuration::setInputFilePath(const std::string &input_file_path)
+{
+  input_file_path_ = input_file_path;
+}
@@ -1,10 +1,13 @@
 #ifndef CONFIGURATION_H_
 #define CONFIGURATION_H_
 
+#include <cstdint>
 #include <string>
 #include <vector>
 #include "clang/Basic/SourceLocation.h"
 
+#include "unified_diff.h"
+
 /**
   Contain the interpreted user input based on command option(s).
 
@@ -15,6 +18,35 @@
 		      output_directory_ output directory of generated files
 		      limit_num_of_mutant_ max number of mutants per mutation point 
 		      										 per mutant operator
+		      patch_output_ record mutants as edits in a patch file instead of
+		      							writing a full source file per mutant
+		      database_formats_ names of database sinks records are written to
+		      schemata_output_ write all mutants into one schematized source file
+		      								 whose active mutant is chosen at runtime
+		      tce_ compare object code of mutants after export (Trivial Compiler
+		      		 Equivalence)
+		      incremental_ reuse mutants of functions unchanged since the last
+		      						 run from the function cache
+		      use_changed_lines_ mutate only code in changed_lines_ (option -diff)
+		      changed_lines_ lines of input file changed since the last run
+		      sample_seed_ seed of the selection of mutants by -l and -budget
+		      mutant_budget_ max number of mutants of input file, 0 if none
+		      stratify_by_operator_ stratify_by_function_ stratify_by_line_
+		      		share mutant_budget_ evenly between mutation operators,
+		      		functions and/or lines (option -stratify)
+		      count_only_ print number of mutants instead of writing them
+		      sharded_layout_ put mutant files in directories by mutation
+		      								operator and id (option -layout sharded)
+		      pack_output_ write full mutant files into one pack archive
+		      pack_compressed_ zlib-compress mutants in the pack archive
+		      stable_ids_ derive mutant ids from the mutants instead of
+		      						numbering them (option -stable-ids)
+		      mutation_options_hash_ hash of the options that decide which
+		      								 mutants are generated, recorded in the
+		      								 function cache
+		      input_file_path_ path of input file relative to the directory of
+		      								 its compile command, absolute if the file is
+		      								 outside of it
 */
 class Configuration
 {
@@ -26,6 +58,25 @@ private:
   std::string output_directory_;
   int limit_num_of_mutant_;
   std::vector<int> excluded_lines_;
+  bool patch_output_;
+  std::vector<std::string> database_formats_;
+  bool schemata_output_;
+  bool tce_;
+  bool incremental_;
+  bool use_changed_lines_;
+  std::vector<LineRange> changed_lines_;
+  uint64_t sample_seed_;
+  unsigned mutant_budget_;
+  bool stratify_by_operator_;
+  bool stratify_by_function_;
+  bool stratify_by_line_;
+  bool count_only_;
+  bool sharded_layout_;
+  bool pack_output_;
+  bool pack_compressed_;
+  bool stable_ids_;
+  uint64_t mutation_options_hash_;
+  std::string input_file_path_;
 
 public:
   Configuration(std::string inputfile_name, std::string mutation_db_filename, 
@@ -41,6 +92,42 @@ public:
 	std::string getOutputDir();
 	int getLimitNumOfMutants();
   std::vector<int>& getExcludedLines();
+  bool getPatchOutput() const;
+  const std::vector<std::string>& getDatabaseFormats() const;
+  bool getSchemataOutput() const;
+  bool getTce() const;
+  bool getIncremental() const;
+  bool getUseChangedLines() const;
+  const std::vector<LineRange>& getChangedLines() const;
+  uint64_t getSampleSeed() const;
+  unsigned getMutantBudget() const;
+  bool getStratifyByOperator() const;
+  bool getStratifyByFunction() const;
+  bool getStratifyByLine() const;
+  bool getCountOnly() const;
+  bool getShardedLayout() const;
+  bool getPackOutput() const;
+  bool getPackCompressed() const;
+  bool getStableIds() const;
+  uint64_t getMutationOptionsHash() const;
+  const std::string& getInputFilePath() const;
+
+  // Setters
+  void setPatchOutput(bool patch_output);
+  void setDatabaseFormats(const std::vector<std::string> &database_formats);
+  void setSchemataOutput(bool schemata_output);
+  void setTce(bool tce);
+  void setIncremental(bool incremental);
+  void setChangedLines(const std::vector<LineRange> &changed_lines);
+  void setSampleSeed(uint64_t sample_seed);
+  void setMutantBudget(unsigned mutant_budget);
+  void setStratification(bool by_operator, bool by_function, bool by_line);
+  void setCountOnly(bool count_only);
+  void setShardedLayout(bool sharded_layout);
+  void setPackOutput(bool pack_output, bool compressed);
+  void setStableIds(bool stable_ids);
+  void setMutationOptionsHash(uint64_t mutation_options_hash);
+  void setInputFilePath(const std::string &input_file_path);
 };
 
 #endif	// CONFIGURATION_H_
\ No newline at end of file
@@ -0,0 +1,216 @@
+#include "music_utility.h"
+#include "music_context.h"
+#include "expr_analysis.h"
+
+ExprAnalysis::ExprAnalysis(MusicContext *context)
+  : context_(context), e_(nullptr)
+{
+  Reset(nullptr);
+}
+
+void ExprAnalysis::Reset(Expr *e)
+{
+  e_ = e;
+  has_end_loc_ = false;
+  has_token_ = false;
+  has_type_class_ = false;
+  known_flags_ = 0;
+  flags_ = 0;
+}
+
+Expr* ExprAnalysis::getExpr() const
+{
+  return e_;
+}
+
+SourceLocation ExprAnalysis::getStartLoc() const
+{
+  return e_->getLocStart();
+}
+
+SourceLocation ExprAnalysis::getEndLoc()
+{
+  if (!has_end_loc_)
+  {
+    end_loc_ = GetEndLocOfExpr(e_, context_->comp_inst_);
+    has_end_loc_ = true;
+  }
+
+  return end_loc_;
+}
+
+const string& ExprAnalysis::getToken()
+{
+  if (!has_token_)
+  {
+    token_ = ConvertToString(e_, context_->comp_inst_->getLangOpts());
+    has_token_ = true;
+  }
+
+  return token_;
+}
+
+bool ExprAnalysis::IsScalar()
+{
+  return HasTypeClass(kScalar);
+}
+
+bool ExprAnalysis::IsPointer()
+{
+  return HasTypeClass(kPointer);
+}
+
+bool ExprAnalysis::IsArray()
+{
+  return HasTypeClass(kArray);
+}
+
+bool ExprAnalysis::IsStruct()
+{
+  return HasTypeClass(kStruct);
+}
+
+bool ExprAnalysis::IsFloating()
+{
+  return HasTypeClass(kFloating);
+}
+
+bool ExprAnalysis::IsIntegral()
+{
+  return HasTypeClass(kIntegral);
+}
+
+bool ExprAnalysis::IsInMutationRange()
+{
+  return GetContextFlag(kInMutationRange);
+}
+
+bool ExprAnalysis::IsInLhsOfAssignmentRange()
+{
+  return GetContextFlag(kInLhsOfAssignment);
+}
+
+bool ExprAnalysis::IsInAddressOpRange()
+{
+  return GetContextFlag(kInAddressOp);
+}
+
+bool ExprAnalysis::IsInUnaryIncrementDecrementRange()
+{
+  return GetContextFlag(kInUnaryIncrementDecrement);
+}
+
+bool ExprAnalysis::IsInFieldDeclRange()
+{
+  return GetContextFlag(kInFieldDecl);
+}
+
+bool ExprAnalysis::IsInCurrentlyParsedFunctionRange()
+{
+  return GetContextFlag(kInCurrentlyParsedFunction);
+}
+
+bool ExprAnalysis::IsInSwitchStmtConditionRange()
+{
+  return GetContextFlag(kInSwitchStmtCondition);
+}
+
+bool ExprAnalysis::IsInArraySubscriptRange()
+{
+  return GetContextFlag(kInArraySubscript);
+}
+
+bool ExprAnalysis::IsInSwitchCaseRange()
+{
+  return GetContextFlag(kInSwitchCase);
+}
+
+bool ExprAnalysis::IsInNonFloatingExprRange()
+{
+  return GetContextFlag(kInNonFloatingExpr);
+}
+
+bool ExprAnalysis::IsInTypedefRange()
+{
+  return GetContextFlag(kInTypedef);
+}
+
+bool ExprAnalysis::HasTypeClass(TypeClass type_class)
+{
+  if (!has_type_class_)
+  {
+    const Type *type = e_->getType().getCanonicalType().getTypePtr();
+
+    type_class_ = 0;
+
+    if (type->isPointerType())
+      type_class_ |= kPointer;
+    else if (type->isScalarType())
+      type_class_ |= kScalar;
+
+    if (type->isArrayType())
+      type_class_ |= kArray;
+
+    if (type->isStructureType())
+      type_class_ |= kStruct;
+
+    if (type->isFloatingType())
+      type_class_ |= kFloating;
+
+    if (type->isIntegralType(context_->comp_inst_->getASTContext()))
+      type_class_ |= kIntegral;
+
+    has_type_class_ = true;
+  }
+
+  return (type_class_ & type_class) != 0;
+}
+
+bool ExprAnalysis::GetContextFlag(ContextFlag flag)
+{
+  unsigned bit = 1u << flag;
+
+  if ((known_flags_ & bit) == 0)
+  {
+    if (ComputeContextFlag(flag))
+      flags_ |= bit;
+
+    known_flags_ |= bit;
+  }
+
+  return (flags_ & bit) != 0;
+}
+
+bool ExprAnalysis::ComputeContextFlag(ContextFlag flag)
+{
+  StmtContext &stmt_context = context_->getStmtContext();
+
+  switch (flag)
+  {
+    case kInMutationRange:
+      return context_->IsRangeInMutationRange(
+          SourceRange(getStartLoc(), getEndLoc()));
+    case kInLhsOfAssignment:
+      return stmt_context.IsInLhsOfAssignmentRange(e_);
+    case kInAddressOp:
+      return stmt_context.IsInAddressOpRange(e_);
+    case kInUnaryIncrementDecrement:
+      return stmt_context.IsInUnaryIncrementDecrementRange(e_);
+    case kInFieldDecl:
+      return stmt_context.IsInFieldDeclRange(e_);
+    case kInCurrentlyParsedFunction:
+      return stmt_context.IsInCurrentlyParsedFunctionRange(e_);
+    case kInSwitchStmtCondition:
+      return stmt_context.IsInSwitchStmtConditionRange(e_);
+    case kInArraySubscript:
+      return stmt_context.IsInArraySubscriptRange(e_);
+    case kInSwitchCase:
+      return stmt_context.IsInSwitchCaseRange(e_);
+    case kInNonFloatingExpr:
+      return stmt_context.IsInNonFloatingExprRange(e_);
+    case kInTypedef:
+      return stmt_context.IsInTypedefRange(e_);
+  }
+
+  return false;
+}
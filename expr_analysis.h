@@ -0,0 +1,107 @@
+#ifndef MUSIC_EXPR_ANALYSIS_H_
+#define MUSIC_EXPR_ANALYSIS_H_
+
+#include <string>
+
+#include "clang/AST/Expr.h"
+#include "clang/Basic/SourceLocation.h"
+
+class MusicContext;
+
+/**
+  Facts about the expression being visited that most expression mutation
+  operators need: end location, source text, type class, whether it is in
+  the mutation range, and where it sits relative to the ranges tracked by
+  StmtContext.
+
+  Each fact is computed the first time an operator asks for it and reused
+  by the following operators, until Reset is called for the next
+  expression.
+*/
+class ExprAnalysis
+{
+public:
+  ExprAnalysis(MusicContext *context);
+
+  // Forget all facts and analyze e from now on.
+  void Reset(clang::Expr *e);
+
+  clang::Expr* getExpr() const;
+  clang::SourceLocation getStartLoc() const;
+
+  // Same as GetEndLocOfExpr and ConvertToString.
+  clang::SourceLocation getEndLoc();
+  const std::string& getToken();
+
+  // Canonical type of the expression, same as the ExprIs* functions.
+  bool IsScalar();
+  bool IsPointer();
+  bool IsArray();
+  bool IsStruct();
+  bool IsFloating();
+  bool IsIntegral();
+
+  // Range from start to end location is in the mutation range.
+  bool IsInMutationRange();
+
+  // Same as the StmtContext::IsIn*Range functions.
+  bool IsInLhsOfAssignmentRange();
+  bool IsInAddressOpRange();
+  bool IsInUnaryIncrementDecrementRange();
+  bool IsInFieldDeclRange();
+  bool IsInCurrentlyParsedFunctionRange();
+  bool IsInSwitchStmtConditionRange();
+  bool IsInArraySubscriptRange();
+  bool IsInSwitchCaseRange();
+  bool IsInNonFloatingExprRange();
+  bool IsInTypedefRange();
+
+private:
+  enum TypeClass
+  {
+    kScalar = 1 << 0,
+    kPointer = 1 << 1,
+    kArray = 1 << 2,
+    kStruct = 1 << 3,
+    kFloating = 1 << 4,
+    kIntegral = 1 << 5
+  };
+
+  enum ContextFlag
+  {
+    kInMutationRange,
+    kInLhsOfAssignment,
+    kInAddressOp,
+    kInUnaryIncrementDecrement,
+    kInFieldDecl,
+    kInCurrentlyParsedFunction,
+    kInSwitchStmtCondition,
+    kInArraySubscript,
+    kInSwitchCase,
+    kInNonFloatingExpr,
+    kInTypedef
+  };
+
+  MusicContext *context_;
+  clang::Expr *e_;
+
+  bool has_end_loc_;
+  clang::SourceLocation end_loc_;
+
+  bool has_token_;
+  std::string token_;
+
+  bool has_type_class_;
+  unsigned type_class_;
+
+  // Bit i of known_flags_ is set once flag i is computed, and its value is
+  // then bit i of flags_.
+  unsigned known_flags_;
+  unsigned flags_;
+
+  bool HasTypeClass(TypeClass type_class);
+  bool GetContextFlag(ContextFlag flag);
+  bool ComputeContextFlag(ContextFlag flag);
+};
+
+#endif  // MUSIC_EXPR_ANALYSIS_H_
@@ -0,0 +1,131 @@
+#include <fstream>
+#include <sstream>
+
+#include "function_cache.h"
+
+namespace {
+
+const char kFunctionCacheMagic[] = "MUSIC-FUNCTION-CACHE 2";
+
+// Read size bytes followed by a newline. Sizes are read from the file, so
+// they are checked against the rest of the file (of file_size bytes)
+// before anything is allocated.
+bool ReadSizedString(std::istream &in, uint64_t file_size, uint64_t size,
+                     std::string &s)
+{
+  std::streamoff pos = in.tellg();
+
+  if (pos < 0 || size >= file_size - static_cast<uint64_t>(pos))
+    return false;
+
+  s.resize(size);
+  in.read(&s[0], size);
+
+  return in.gcount() == static_cast<std::streamsize>(size) &&
+         in.get() == '\n';
+}
+
+}  // namespace
+
+bool WriteFunctionCache(const std::string &filename,
+                        const FunctionCache &cache)
+{
+  std::ofstream out(filename.data(), std::ios::trunc | std::ios::binary);
+
+  if (!out.is_open())
+    return false;
+
+  out << kFunctionCacheMagic << "\n";
+  out << cache.next_mutant_id_ << "\n";
+  out << cache.file_scope_hash_ << " " << cache.options_hash_ << "\n";
+
+  for (auto &function: cache.functions_)
+  {
+    out << "F " << function.hash_ << " " << function.mutants_.size() << " "
+        << function.key_.length() << "\n" << function.key_ << "\n";
+
+    for (auto &mutant: function.mutants_)
+    {
+      out << "M " << mutant.mutant_id_ << " " << mutant.operator_name_ << " "
+          << mutant.offset_ << " " << mutant.length_ << " "
+          << mutant.proteum_line_delta_ << " " << mutant.token_.length()
+          << " " << mutant.mutated_token_.length() << "\n";
+      out << mutant.token_ << mutant.mutated_token_ << "\n";
+    }
+  }
+
+  out.close();
+  return !out.fail();
+}
+
+bool ReadFunctionCache(const std::string &filename, FunctionCache &cache)
+{
+  std::ifstream in(filename.data(), std::ios::binary);
+
+  if (!in.is_open())
+    return false;
+
+  in.seekg(0, std::ios::end);
+  uint64_t file_size = in.tellg();
+  in.seekg(0, std::ios::beg);
+
+  std::string line;
+
+  if (!std::getline(in, line) || line != kFunctionCacheMagic)
+    return false;
+
+  if (!std::getline(in, line) ||
+      !(std::istringstream(line) >> cache.next_mutant_id_))
+    return false;
+
+  if (!std::getline(in, line) ||
+      !(std::istringstream(line) >> cache.file_scope_hash_ >>
+                                    cache.options_hash_))
+    return false;
+
+  cache.functions_.clear();
+
+  while (std::getline(in, line))
+  {
+    std::istringstream function_line(line);
+    std::string tag;
+    CachedFunction function;
+    size_t num_mutants;
+    uint64_t key_size;
+
+    if (!(function_line >> tag >> function.hash_ >> num_mutants >>
+                           key_size) || tag != "F" ||
+        !ReadSizedString(in, file_size, key_size, function.key_))
+      return false;
+
+    for (size_t i = 0; i < num_mutants; i++)
+    {
+      CachedMutant mutant;
+      uint64_t token_size, mutated_token_size;
+
+      if (!std::getline(in, line))
+        return false;
+
+      std::istringstream mutant_line(line);
+      std::string tokens;
+
+      if (!(mutant_line >> tag >> mutant.mutant_id_ >>
+                           mutant.operator_name_ >> mutant.offset_ >>
+                           mutant.length_ >> mutant.proteum_line_delta_ >>
+                           token_size >> mutated_token_size) ||
+          tag != "M" || token_size >= file_size ||
+          mutated_token_size >= file_size ||
+          !ReadSizedString(in, file_size, token_size + mutated_token_size,
+                           tokens))
+        return false;
+
+      mutant.token_ = tokens.substr(0, token_size);
+      mutant.mutated_token_ = tokens.substr(token_size);
+      function.mutants_.push_back(mutant);
+    }
+
+    cache.functions_.push_back(function);
+  }
+
+  return true;
+}
@@ -0,0 +1,88 @@
+#ifndef MUSIC_FUNCTION_CACHE_H_
+#define MUSIC_FUNCTION_CACHE_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+  A mutant exported in a previous run, located relative to the start of
+  the function it mutates so that it can be reused after the function moved.
+
+  @param  mutant_id_ id of mutant (e.g. 12 for test.MUT12.c)
+          operator_name_ name of mutation operator
+          offset_ byte offset of mutated token from start of function
+          length_ number of bytes of the original token
+          proteum_line_delta_ Proteum style line number minus line number
+                              of start of function
+          token_ token before mutation
+          mutated_token_ token after mutation
+*/
+struct CachedMutant
+{
+  uint64_t mutant_id_;
+  std::string operator_name_;
+  uint64_t offset_;
+  uint64_t length_;
+  int proteum_line_delta_;
+  std::string token_;
+  std::string mutated_token_;
+};
+
+/**
+  @param  key_ name and type of function, unique within its input file
+          hash_ FNV-1a hash of text of function definition
+          mutants_ mutants exported for the function
+*/
+struct CachedFunction
+{
+  std::string key_;
+  uint64_t hash_;
+  std::vector<CachedMutant> mutants_;
+};
+
+/**
+  Mutants exported for each function definition of an input file, read
+  again by the next run with option -incremental.
+
+  Mutants of a function also depend on the code outside of function
+  definitions (e.g. global variables and constants offered as replacements)
+  and on the options selecting operators, lines and samples, so the cache
+  is only valid for the same file-scope text and options.
+
+  @param  next_mutant_id_ smallest id never given to a mutant of the file
+          file_scope_hash_ FNV-1a hash of the text outside of function
+                           definitions
+          options_hash_ FNV-1a hash of the mutation options of the run
+*/
+struct FunctionCache
+{
+  uint64_t next_mutant_id_;
+  uint64_t file_scope_hash_;
+  uint64_t options_hash_;
+  std::vector<CachedFunction> functions_;
+};
+
+/**
+  Function cache file layout (all numbers in decimal):
+
+    MUSIC-FUNCTION-CACHE 2
+    <next mutant id>
+    <file scope hash> <options hash>
+    F <hash> <number of mutants> <key size>
+    <key bytes>
+    M <mutant id> <operator> <offset> <length> <proteum line delta>
+      <token size> <mutated token size>            (on one line)
+    <token bytes><mutated token bytes>
+    ... (one F record per function, followed by its M records)
+
+  Like replacements in patch files, keys and tokens are length-prefixed and
+  followed by a single newline.
+*/
+bool WriteFunctionCache(const std::string &filename,
+                        const FunctionCache &cache);
+
+// Return false if the file cannot be opened or is malformed.
+bool ReadFunctionCache(const std::string &filename, FunctionCache &cache);
+
+#endif  // MUSIC_FUNCTION_CACHE_H_
@@ -0,0 +1,259 @@
+#include <algorithm>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "indexed_mutant_database.h"
+
+namespace {
+
+// Return true if [offset, offset + count * elem_size) lies within size.
+bool SectionFits(uint64_t offset, uint64_t count, uint64_t elem_size,
+                 uint64_t size)
+{
+  if (offset > size)
+    return false;
+
+  return count <= (size - offset) / elem_size;
+}
+
+}  // namespace
+
+IndexedMutantDatabase::IndexedMutantDatabase()
+  : data_(nullptr), size_(0), header_(nullptr), records_(nullptr),
+    id_index_(nullptr), line_index_(nullptr), operator_index_(nullptr),
+    string_pool_(nullptr)
+{}
+
+IndexedMutantDatabase::~IndexedMutantDatabase()
+{
+  Close();
+}
+
+bool IndexedMutantDatabase::Open(const std::string &filename)
+{
+  Close();
+
+  int fd = open(filename.data(), O_RDONLY);
+
+  if (fd < 0)
+    return false;
+
+  struct stat file_stat;
+
+  if (fstat(fd, &file_stat) != 0 ||
+      static_cast<size_t>(file_stat.st_size) < sizeof(IndexedDbHeader))
+  {
+    close(fd);
+    return false;
+  }
+
+  void *mapping = mmap(nullptr, file_stat.st_size, PROT_READ, MAP_SHARED,
+                       fd, 0);
+  close(fd);
+
+  if (mapping == MAP_FAILED)
+    return false;
+
+  data_ = static_cast<const char *>(mapping);
+  size_ = file_stat.st_size;
+  header_ = reinterpret_cast<const IndexedDbHeader *>(data_);
+
+  if (!Validate())
+  {
+    Close();
+    return false;
+  }
+
+  records_ = reinterpret_cast<const IndexedDbRecord *>(
+      data_ + header_->records_offset_);
+  id_index_ = reinterpret_cast<const uint32_t *>(
+      data_ + header_->id_index_offset_);
+  line_index_ = reinterpret_cast<const uint32_t *>(
+      data_ + header_->line_index_offset_);
+  operator_index_ = reinterpret_cast<const uint32_t *>(
+      data_ + header_->operator_index_offset_);
+  string_pool_ = data_ + header_->string_pool_offset_;
+  return true;
+}
+
+void IndexedMutantDatabase::Close()
+{
+  if (data_ != nullptr)
+    munmap(const_cast<char *>(data_), size_);
+
+  data_ = nullptr;
+  size_ = 0;
+  header_ = nullptr;
+  records_ = nullptr;
+  id_index_ = nullptr;
+  line_index_ = nullptr;
+  operator_index_ = nullptr;
+  string_pool_ = nullptr;
+}
+
+bool IndexedMutantDatabase::Validate() const
+{
+  if (memcmp(header_->magic_, kIndexedDbMagic, sizeof(kIndexedDbMagic)) != 0 ||
+      header_->version_ != kIndexedDbVersion ||
+      header_->endian_tag_ != kIndexedDbEndianTag ||
+      header_->record_size_ != sizeof(IndexedDbRecord))
+    return false;
+
+  uint64_t count = header_->record_count_;
+
+  if (header_->records_offset_ % alignof(IndexedDbRecord) != 0 ||
+      header_->id_index_offset_ % alignof(uint32_t) != 0 ||
+      header_->line_index_offset_ % alignof(uint32_t) != 0 ||
+      header_->operator_index_offset_ % alignof(uint32_t) != 0 ||
+      !SectionFits(header_->records_offset_, count, sizeof(IndexedDbRecord),
+                   size_) ||
+      !SectionFits(header_->id_index_offset_, count, sizeof(uint32_t),
+                   size_) ||
+      !SectionFits(header_->line_index_offset_, count, sizeof(uint32_t),
+                   size_) ||
+      !SectionFits(header_->operator_index_offset_, count, sizeof(uint32_t),
+                   size_) ||
+      !SectionFits(header_->string_pool_offset_, header_->string_pool_size_,
+                   1, size_))
+    return false;
+
+  // Lookups use index entries and string offsets unchecked, so every one of
+  // them must point within its section.
+  const uint32_t *indexes[] = {
+      reinterpret_cast<const uint32_t *>(data_ + header_->id_index_offset_),
+      reinterpret_cast<const uint32_t *>(data_ + header_->line_index_offset_),
+      reinterpret_cast<const uint32_t *>(
+          data_ + header_->operator_index_offset_)};
+
+  for (const uint32_t *index: indexes)
+    for (uint64_t i = 0; i < count; i++)
+      if (index[i] >= count)
+        return false;
+
+  const IndexedDbRecord *records = reinterpret_cast<const IndexedDbRecord *>(
+      data_ + header_->records_offset_);
+  const char *string_pool = data_ + header_->string_pool_offset_;
+
+  for (uint64_t i = 0; i < count; i++)
+    if (!StringFits(string_pool, records[i].mutant_filename_) ||
+        !StringFits(string_pool, records[i].operator_name_) ||
+        !StringFits(string_pool, records[i].token_) ||
+        !StringFits(string_pool, records[i].mutated_token_))
+      return false;
+
+  return true;
+}
+
+bool IndexedMutantDatabase::StringFits(const char *string_pool,
+                                       uint32_t pool_offset) const
+{
+  uint64_t pool_size = header_->string_pool_size_;
+
+  // Length prefix and terminating '\0' must lie within the pool.
+  if (pool_size < sizeof(uint32_t) ||
+      pool_offset > pool_size - sizeof(uint32_t))
+    return false;
+
+  uint32_t length;
+  memcpy(&length, string_pool + pool_offset, sizeof(length));
+
+  if (length >= pool_size - pool_offset - sizeof(uint32_t))
+    return false;
+
+  return string_pool[pool_offset + sizeof(uint32_t) + length] == '\0';
+}
+
+uint32_t IndexedMutantDatabase::getRecordCount() const
+{
+  return header_ == nullptr ? 0 : header_->record_count_;
+}
+
+const IndexedDbRecord& IndexedMutantDatabase::getRecord(
+    uint32_t record_idx) const
+{
+  return records_[record_idx];
+}
+
+const char* IndexedMutantDatabase::getString(uint32_t pool_offset) const
+{
+  // Offsets of records are checked by Validate; others, e.g. given by a
+  // caller, are checked here.
+  if (!StringFits(string_pool_, pool_offset))
+    return "";
+
+  return string_pool_ + pool_offset + sizeof(uint32_t);
+}
+
+uint32_t IndexedMutantDatabase::getStringLength(uint32_t pool_offset) const
+{
+  if (!StringFits(string_pool_, pool_offset))
+    return 0;
+
+  uint32_t length;
+  memcpy(&length, string_pool_ + pool_offset, sizeof(length));
+  return length;
+}
+
+const IndexedDbRecord* IndexedMutantDatabase::FindById(
+    uint64_t mutant_id) const
+{
+  const uint32_t *end = id_index_ + getRecordCount();
+  const uint32_t *it = std::lower_bound(
+      id_index_, end, mutant_id,
+      [this](uint32_t record_idx, uint64_t id)
+      { return records_[record_idx].mutant_id_ < id; });
+
+  if (it == end || records_[*it].mutant_id_ != mutant_id)
+    return nullptr;
+
+  return &records_[*it];
+}
+
+IndexedMutantDatabase::IndexRange IndexedMutantDatabase::FindByLine(
+    int32_t line) const
+{
+  const uint32_t *end = line_index_ + getRecordCount();
+  const uint32_t *first = std::lower_bound(
+      line_index_, end, line,
+      [this](uint32_t record_idx, int32_t l)
+      { return records_[record_idx].start_line_ < l; });
+  const uint32_t *last = std::upper_bound(
+      first, end, line,
+      [this](int32_t l, uint32_t record_idx)
+      { return l < records_[record_idx].start_line_; });
+
+  return IndexRange(first - line_index_, last - line_index_);
+}
+
+const IndexedDbRecord& IndexedMutantDatabase::getRecordByLineIndex(
+    uint32_t position) const
+{
+  return records_[line_index_[position]];
+}
+
+IndexedMutantDatabase::IndexRange IndexedMutantDatabase::FindByOperator(
+    const std::string &operator_name) const
+{
+  const uint32_t *end = operator_index_ + getRecordCount();
+  const uint32_t *first = std::lower_bound(
+      operator_index_, end, operator_name,
+      [this](uint32_t record_idx, const std::string &name)
+      { return name.compare(
+            getString(records_[record_idx].operator_name_)) > 0; });
+  const uint32_t *last = std::upper_bound(
+      first, end, operator_name,
+      [this](const std::string &name, uint32_t record_idx)
+      { return name.compare(
+            getString(records_[record_idx].operator_name_)) < 0; });
+
+  return IndexRange(first - operator_index_, last - operator_index_);
+}
+
+const IndexedDbRecord& IndexedMutantDatabase::getRecordByOperatorIndex(
+    uint32_t position) const
+{
+  return records_[operator_index_[position]];
+}
@@ -0,0 +1,118 @@
+#ifndef MUSIC_INDEXED_MUTANT_DATABASE_H_
+#define MUSIC_INDEXED_MUTANT_DATABASE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+
+/**
+  Layout of <name>_mut_db.idx, written by the "indexed" database sink.
+  All numbers are in host byte order; endian_tag_ lets a reader detect a
+  file written on a machine with different byte order.
+
+    IndexedDbHeader
+    IndexedDbRecord x record_count_      records in export order
+    uint32_t x record_count_             record indexes sorted by mutant id
+    uint32_t x record_count_             record indexes sorted by
+                                         (start line, mutant id)
+    uint32_t x record_count_             record indexes sorted by
+                                         (operator name, mutant id)
+    string pool                          each string stored once as
+                                         uint32_t length + bytes + '\0'
+
+  String fields of a record hold the offset of the string in the pool.
+*/
+
+const char kIndexedDbMagic[8] = {'M', 'U', 'S', 'I', 'C', 'I', 'D', 'X'};
+const uint32_t kIndexedDbVersion = 2;
+const uint32_t kIndexedDbEndianTag = 0x01020304;
+
+struct IndexedDbHeader
+{
+  char magic_[8];
+  uint32_t version_;
+  uint32_t endian_tag_;
+  uint32_t record_count_;
+  uint32_t record_size_;
+  uint64_t records_offset_;
+  uint64_t id_index_offset_;
+  uint64_t line_index_offset_;
+  uint64_t operator_index_offset_;
+  uint64_t string_pool_offset_;
+  uint64_t string_pool_size_;
+};
+
+struct IndexedDbRecord
+{
+  uint64_t mutant_id_;
+  uint32_t mutant_filename_;
+  uint32_t operator_name_;
+  int32_t proteum_line_num_;
+  int32_t start_line_;
+  int32_t start_col_;
+  int32_t end_line_;
+  int32_t end_col_;
+  int32_t mutated_end_line_;
+  int32_t mutated_end_col_;
+  uint32_t token_;
+  uint32_t mutated_token_;
+  uint32_t reserved_;
+};
+
+/**
+  Read-only view of an indexed mutant database. The file is mapped into
+  memory and records are accessed in place, so opening is O(1) and every
+  lookup is a binary search over one of the indexes.
+*/
+class IndexedMutantDatabase
+{
+public:
+  // Range of positions [first, second) in one of the indexes.
+  typedef std::pair<uint32_t, uint32_t> IndexRange;
+
+  IndexedMutantDatabase();
+  ~IndexedMutantDatabase();
+
+  // Return false if file cannot be mapped or is not a valid database.
+  bool Open(const std::string &filename);
+  void Close();
+
+  uint32_t getRecordCount() const;
+  const IndexedDbRecord& getRecord(uint32_t record_idx) const;
+
+  // Return string at given offset of string pool. The pointer is valid
+  // until Close.
+  const char* getString(uint32_t pool_offset) const;
+  uint32_t getStringLength(uint32_t pool_offset) const;
+
+  // Return nullptr if there is no mutant with given id.
+  const IndexedDbRecord* FindById(uint64_t mutant_id) const;
+
+  // Records starting on given line, in mutant id order.
+  IndexRange FindByLine(int32_t line) const;
+  const IndexedDbRecord& getRecordByLineIndex(uint32_t position) const;
+
+  // Records of given mutation operator, in mutant id order.
+  IndexRange FindByOperator(const std::string &operator_name) const;
+  const IndexedDbRecord& getRecordByOperatorIndex(uint32_t position) const;
+
+private:
+  const char *data_;
+  size_t size_;
+
+  const IndexedDbHeader *header_;
+  const IndexedDbRecord *records_;
+  const uint32_t *id_index_;
+  const uint32_t *line_index_;
+  const uint32_t *operator_index_;
+  const char *string_pool_;
+
+  bool Validate() const;
+
+  // Return true if a whole string, length prefix to '\0', lies at given
+  // offset of string pool.
+  bool StringFits(const char *string_pool, uint32_t pool_offset) const;
+};
+
+#endif  // MUSIC_INDEXED_MUTANT_DATABASE_H_
@@ -6,6 +6,7 @@ void InformationGatherer::HandleTranslationUnit(clang::ASTContext &Context)
   /* we can use ASTContext to get the TranslationUnitDecl, which is
   a single Decl that collectively represents the entire source file */
   Visitor.TraverseDecl(Context.getTranslationUnitDecl());
+  Visitor.BuildLabelIndex();
 }
 
 LabelStmtToGotoStmtListMap* InformationGatherer::getLabelToGotoListMap()
@@ -13,6 +14,11 @@ LabelStmtToGotoStmtListMap* InformationGatherer::getLabelToGotoListMap()
   return Visitor.getLabelToGotoListMap();
 }
 
+LabelIndex* InformationGatherer::getLabelIndex()
+{
+  return Visitor.getLabelIndex();
+}
+
 SymbolTable* InformationGatherer::getSymbolTable()
 {
 	return Visitor.getSymbolTable();
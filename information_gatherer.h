@@ -6,14 +6,16 @@
 class InformationGatherer : public clang::ASTConsumer
 {
 public:
-  InformationGatherer(clang::CompilerInstance *CI)
-    :Visitor(CI)
+  InformationGatherer(clang::CompilerInstance *CI, Configuration *config)
+    :Visitor(CI, config)
   {}
 
   virtual void HandleTranslationUnit(clang::ASTContext &Context);
 
   LabelStmtToGotoStmtListMap* getLabelToGotoListMap();
 
+  LabelIndex* getLabelIndex();
+
   SymbolTable* getSymbolTable();
   
 private:
@@ -2,8 +2,8 @@
 #include "information_visitor.h"
 
 InformationVisitor::InformationVisitor(
-    CompilerInstance *CI)
-  : comp_inst_(CI), 
+    CompilerInstance *CI, Configuration *config)
+  : comp_inst_(CI), config_(config),
     src_mgr_(CI->getSourceManager()), lang_option_(CI->getLangOpts())
 {
   SourceLocation start_of_file = src_mgr_.getLocForStartOfFile(src_mgr_.getMainFileID());
@@ -40,6 +40,15 @@ void InformationVisitor::addGotoLocToMap(LabelStmtLocation label_loc,
   }
 }
 
+bool InformationVisitor::TraverseDecl(Decl *d)
+{
+  if (d != nullptr && isa<FunctionDecl>(d) &&
+      DeclIsOutsideMutationRange(src_mgr_, d, config_))
+    return true;
+
+  return RecursiveASTVisitor<InformationVisitor>::TraverseDecl(d);
+}
+
 bool InformationVisitor::VisitLabelStmt(LabelStmt *ls)
 {
   string labelName{ls->getName()};
@@ -125,12 +134,8 @@ bool InformationVisitor::VisitFunctionDecl(FunctionDecl *fd)
     local_array_vardecl_list_.push_back(VarDeclList());
     local_struct_vardecl_list_.push_back(VarDeclList());
     local_pointer_vardecl_list_.push_back(VarDeclList());
-    local_stringliteral_list_.push_back(ExprList());
-    local_scalarconstant_list_.push_back(ExprList());
-
-    // clear the constants of the previously parsed function
-    // get ready to contain constants of the new function
-    local_scalar_constant_cache_.clear(); 
+    local_stringliteral_list_.push_back(LiteralPool());
+    local_scalarconstant_list_.push_back(LiteralPool());
   }
   else 
   {
@@ -160,6 +165,46 @@ LabelStmtToGotoStmtListMap* InformationVisitor::getLabelToGotoListMap()
   return &label_to_gotolist_map_;
 }
 
+LabelIndex* InformationVisitor::getLabelIndex()
+{
+  return &label_index_;
+}
+
+void InformationVisitor::BuildLabelIndex()
+{
+  FileID main_file_id = src_mgr_.getMainFileID();
+
+  for (auto &label: label_to_gotolist_map_)
+  {
+    SourceLocation label_loc = src_mgr_.translateLineCol(
+        main_file_id, label.first.first, label.first.second);
+    uint32_t first_goto_offset = UINT32_MAX;
+    uint32_t last_goto_offset = 0;
+
+    for (auto goto_loc: label.second)
+    {
+      goto_loc = src_mgr_.getExpansionLoc(goto_loc);
+
+      // A goto outside the main file is outside any range of it.
+      if (src_mgr_.getFileID(goto_loc) != main_file_id)
+      {
+        first_goto_offset = 0;
+        last_goto_offset = UINT32_MAX;
+        break;
+      }
+
+      uint32_t offset = src_mgr_.getFileOffset(goto_loc);
+      first_goto_offset = min(first_goto_offset, offset);
+      last_goto_offset = max(last_goto_offset, offset);
+    }
+
+    label_index_.AddLabel(src_mgr_.getFileOffset(label_loc),
+                          first_goto_offset, last_goto_offset);
+  }
+
+  label_index_.Build();
+}
+
 void InformationVisitor::CollectVarDecl(VarDecl *vd)
 {
   SourceLocation start_loc = vd->getLocStart();
@@ -218,77 +263,52 @@ void InformationVisitor::CollectScalarConstant(Expr* e)
   //     src_mgr_.getMainFileID())
   //   return;
 
-  string token{ConvertToString(e, comp_inst_->getLangOpts())};
+  Literal literal;
+  literal.expr_ = e;
+  literal.spelling_ = ConvertToString(e, comp_inst_->getLangOpts());
+  literal.value_ = GetNormalizedLiteralValue(e, literal.spelling_);
+  literal.is_floating_ = ExprIsFloat(e);
 
-  // convert to int value if it is a char literal
-  if (token.front() == '\'' && token.back() == '\'')
-    token = ConvertCharStringToIntString(token);
+  // char literals are replaced with their int value
+  if (isa<CharacterLiteral>(e))
+    literal.token_ = literal.value_;
+  else
+    literal.token_ = literal.spelling_;
 
   // local constants
   if (LocationIsInRange(src_mgr_.getExpansionLoc(e->getLocStart()), 
                         *currently_parsed_function_range_))  
   {
-    // If the constant is not in the cache, add this new entity into
-    // the cache and the vector storing local consts.
-    // Else, do nothing.
-    if (local_scalar_constant_cache_.find(token) == local_scalar_constant_cache_.end())
-    {
-      local_scalar_constant_cache_.insert(token);
-      local_scalarconstant_list_.back().push_back(e);
-    }
+    literal.function_id_ = local_scalarconstant_list_.size() - 1;
+    local_scalarconstant_list_.back().Add(literal);
   }
-  // If the constant is not in the cache, add this new entity into
-  // the cache and the vector storing global consts.
-  // Else, do nothing.
-  else if (
-    global_scalar_constant_cache_.find(token) == global_scalar_constant_cache_.end())
+  else
   {
-    // cout << "found " << token << " at\n";
-    // cout << e->getLocStart().isMacroID() << endl;
-    // cout << src_mgr_.getMainFileID().getHashValue() << endl;
-    // cout << e->getLocStart().printToString(src_mgr_) << endl;
-    // cout << src_mgr_.getFileID(e->getLocStart()).getHashValue() << endl;
-    // cout << src_mgr_.getExpansionLoc(e->getLocStart()).printToString(src_mgr_) << endl;
-    // cout << src_mgr_.getFileID(src_mgr_.getExpansionLoc(e->getLocStart())).getHashValue() << endl;
-    // cout << src_mgr_.getSpellingLoc(e->getLocStart()).printToString(src_mgr_) << endl;
-    // cout << src_mgr_.getFileID(src_mgr_.getSpellingLoc(e->getLocStart())).getHashValue() << endl;
-
-    global_scalar_constant_cache_.insert(token);
-    global_scalarconstant_list_.push_back(e);
+    literal.function_id_ = -1;
+    global_scalarconstant_list_.Add(literal);
   }
 }
 
 void InformationVisitor::CollectStringLiteral(Expr *e)
 {
   SourceLocation start_loc = e->getLocStart();
-  string string_literal{ConvertToString(e, comp_inst_->getLangOpts())};
 
+  Literal literal;
+  literal.expr_ = e;
+  literal.spelling_ = ConvertToString(e, comp_inst_->getLangOpts());
+  literal.value_ = literal.spelling_;
+  literal.token_ = literal.spelling_;
+  literal.is_floating_ = false;
+
+  // The SAME string is added once per function, and once for global scope.
   if (LocationIsInRange(start_loc, *currently_parsed_function_range_))
   {
-    // local string literal
-    // if there is the SAME string in the SAME function,
-    // then dont add
-    auto it = local_stringliteral_list_.back().begin();
-
-    while (it != local_stringliteral_list_.back().end() &&
-           string_literal.compare(
-               ConvertToString(*it, comp_inst_->getLangOpts())) != 0)
-      ++it;
-
-    if (it == local_stringliteral_list_.back().end())
-      local_stringliteral_list_.back().push_back(e);
+    literal.function_id_ = local_stringliteral_list_.size() - 1;
+    local_stringliteral_list_.back().Add(literal);
   }
   else
   {
-    // global string literal
-    // Insert if global string vector does not contain this literal
-    for (auto it: global_stringliteral_list_)
-    {
-      if (string_literal.compare(
-              ConvertToString(it, comp_inst_->getLangOpts())) == 0)
-        return;
-    }
-
-    global_stringliteral_list_.push_back(e);
+    literal.function_id_ = -1;
+    global_stringliteral_list_.Add(literal);
   }
-}
\ No newline at end of file
+}
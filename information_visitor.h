@@ -1,16 +1,15 @@
 #ifndef MUSIC_INFORMATION_VISITOR_H_
 #define MUSIC_INFORMATION_VISITOR_H_
 
-#include <set>
-
 #include "clang/Rewrite/Core/Rewriter.h"
 
+#include "label_index.h"
 #include "music_context.h"
 
 class InformationVisitor : public clang::RecursiveASTVisitor<InformationVisitor>
 {
 public:
-  InformationVisitor(clang::CompilerInstance *CI);
+  InformationVisitor(clang::CompilerInstance *CI, Configuration *config);
   ~InformationVisitor();
 
   // Add a new Goto statement location to LabelStmtToGotoStmtListMap.
@@ -19,6 +18,10 @@ public:
   void addGotoLocToMap(LabelStmtLocation label_loc, 
                        clang::SourceLocation goto_stmt_loc);
   
+  // Skip functions that cannot hold mutants, as MusicASTVisitor does.
+  // Other declarations are kept for their global variables and constants.
+  bool TraverseDecl(clang::Decl *d);
+
   bool VisitLabelStmt(clang::LabelStmt *ls);
   bool VisitGotoStmt(clang::GotoStmt * gs);
   bool VisitExpr(clang::Expr *e);
@@ -28,9 +31,14 @@ public:
 
   SymbolTable* getSymbolTable();
   LabelStmtToGotoStmtListMap* getLabelToGotoListMap();
+  LabelIndex* getLabelIndex();
+
+  // Index labels of LabelStmtToGotoStmtListMap by offset, after traversal.
+  void BuildLabelIndex();
 
 private:
 	clang::CompilerInstance *comp_inst_;
+  Configuration *config_;
 
   clang::SourceManager &src_mgr_;
   clang::LangOptions &lang_option_;
@@ -43,12 +51,6 @@ private:
   clang::SourceRange *typedefdecl_range_;
   clang::SourceRange *function_prototype_range_;
 
-  // A set holding all distinguished consts in currently/last parsed fuction.
-  std::set<std::string> local_scalar_constant_cache_;
-
-  // A set holding all distinguished consts with global scope
-  std::set<std::string> global_scalar_constant_cache_;
-
   // global/local scalar variables (char, int, double, float)
   // local_scalar_vardecl_list_ follows the same nesting rule as ScopeRangeList
   VarDeclList global_scalar_vardecl_list_;
@@ -69,21 +71,23 @@ private:
   VarDeclList global_pointer_vardecl_list_;
   std::vector<VarDeclList> local_pointer_vardecl_list_;
 
-  // Global/Local numbers, chars
+  // Distinct global/local numbers, chars
   GlobalScalarConstantList global_scalarconstant_list_;
   LocalScalarConstantList local_scalarconstant_list_;
 
-  // A vector holding string literals used outside a function (global scope)
+  // Distinct string literals used outside a function (global scope)
   GlobalStringLiteralList global_stringliteral_list_;
 
-  // A vector holding string literals used inside a function (local scope)
-  // and their location.
+  // Distinct string literals used inside each function (local scope)
   LocalStringLiteralList local_stringliteral_list_;
 
   // Map from label declaration location to locations of Goto statements
   // pointing to that label.
   LabelStmtToGotoStmtListMap label_to_gotolist_map_;
 
+  // Labels of label_to_gotolist_map_ with the offsets of their gotos.
+  LabelIndex label_index_;
+
   void CollectVarDecl(clang::VarDecl *vd);
   void CollectScalarConstant(clang::Expr *e);
   void CollectStringLiteral(clang::Expr *e);
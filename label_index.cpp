@@ -0,0 +1,80 @@
+#include <algorithm>
+
+#include "label_index.h"
+
+void LabelIndex::AddLabel(uint32_t offset, uint32_t first_goto_offset,
+                          uint32_t last_goto_offset)
+{
+  labels_.push_back(LabelInterval{offset, first_goto_offset,
+                                  last_goto_offset});
+}
+
+void LabelIndex::Build()
+{
+  std::sort(labels_.begin(), labels_.end(),
+            [](const LabelInterval &a, const LabelInterval &b)
+            { return a.offset_ < b.offset_; });
+
+  first_goto_offsets_.clear();
+  last_goto_offsets_.clear();
+
+  if (labels_.empty())
+    return;
+
+  first_goto_offsets_.push_back(std::vector<uint32_t>());
+  last_goto_offsets_.push_back(std::vector<uint32_t>());
+
+  for (auto &label: labels_)
+  {
+    first_goto_offsets_[0].push_back(label.first_goto_offset_);
+    last_goto_offsets_[0].push_back(label.last_goto_offset_);
+  }
+
+  for (size_t k = 1; (size_t(1) << k) <= labels_.size(); k++)
+  {
+    const std::vector<uint32_t> &first = first_goto_offsets_[k - 1];
+    const std::vector<uint32_t> &last = last_goto_offsets_[k - 1];
+    size_t half = size_t(1) << (k - 1);
+    std::vector<uint32_t> next_first, next_last;
+
+    for (size_t i = 0; i + 2 * half <= labels_.size(); i++)
+    {
+      next_first.push_back(std::min(first[i], first[i + half]));
+      next_last.push_back(std::max(last[i], last[i + half]));
+    }
+
+    first_goto_offsets_.push_back(next_first);
+    last_goto_offsets_.push_back(next_last);
+  }
+}
+
+bool LabelIndex::HasLabelTargetedFromOutside(uint32_t start_offset,
+                                             uint32_t end_offset) const
+{
+  // Labels [begin, end) are inside the range.
+  size_t begin = std::lower_bound(
+      labels_.begin(), labels_.end(), start_offset,
+      [](const LabelInterval &label, uint32_t offset)
+      { return label.offset_ < offset; }) - labels_.begin();
+  size_t end = std::upper_bound(
+      labels_.begin(), labels_.end(), end_offset,
+      [](uint32_t offset, const LabelInterval &label)
+      { return offset < label.offset_; }) - labels_.begin();
+
+  if (begin >= end)
+    return false;
+
+  // Two overlapping blocks of 2^k labels cover [begin, end).
+  size_t k = 0;
+
+  while ((size_t(1) << (k + 1)) <= end - begin)
+    k++;
+
+  size_t second = end - (size_t(1) << k);
+  uint32_t first_goto_offset = std::min(first_goto_offsets_[k][begin],
+                                        first_goto_offsets_[k][second]);
+  uint32_t last_goto_offset = std::max(last_goto_offsets_[k][begin],
+                                       last_goto_offsets_[k][second]);
+
+  return first_goto_offset < start_offset || last_goto_offset > end_offset;
+}
@@ -0,0 +1,51 @@
+#ifndef MUSIC_LABEL_INDEX_H_
+#define MUSIC_LABEL_INDEX_H_
+
+#include <cstdint>
+#include <vector>
+
+/**
+  Labels of the main file by byte offset, each with the smallest and
+  largest offset of the gotos targeting it, to tell in logarithmic time
+  whether a range holds a label that a goto outside the range jumps to.
+*/
+class LabelIndex
+{
+public:
+  /**
+    Add a label at offset, targeted by gotos between first_goto_offset and
+    last_goto_offset. A label without goto has first_goto_offset greater
+    than last_goto_offset.
+  */
+  void AddLabel(uint32_t offset, uint32_t first_goto_offset,
+                uint32_t last_goto_offset);
+
+  // Sort the labels and build the range tables. Call after the last
+  // AddLabel.
+  void Build();
+
+  /**
+    @return True if a label in [start_offset, end_offset] is targeted by
+            a goto outside of [start_offset, end_offset]
+  */
+  bool HasLabelTargetedFromOutside(uint32_t start_offset,
+                                   uint32_t end_offset) const;
+
+private:
+  struct LabelInterval
+  {
+    uint32_t offset_;
+    uint32_t first_goto_offset_;
+    uint32_t last_goto_offset_;
+  };
+
+  std::vector<LabelInterval> labels_;
+
+  // Sparse tables: first_goto_offsets_[k][i] is the smallest
+  // first_goto_offset_ of labels i to i + 2^k - 1, last_goto_offsets_[k][i]
+  // the largest last_goto_offset_.
+  std::vector<std::vector<uint32_t>> first_goto_offsets_;
+  std::vector<std::vector<uint32_t>> last_goto_offsets_;
+};
+
+#endif  // MUSIC_LABEL_INDEX_H_
@@ -0,0 +1,62 @@
+#include <algorithm>
+
+#include "line_table.h"
+
+LineTable::LineTable()
+  : data_(nullptr), size_(0)
+{}
+
+void LineTable::Build(const char *data, size_t size)
+{
+  data_ = data;
+  size_ = size;
+  line_starts_.assign(1, 0);
+
+  for (size_t i = 0; i < size; i++)
+  {
+    if (data[i] != '\n' && data[i] != '\r')
+      continue;
+
+    // "\r\n" and "\n\r" end a single line.
+    if (i + 1 < size && (data[i + 1] == '\n' || data[i + 1] == '\r') &&
+        data[i + 1] != data[i])
+      i++;
+
+    line_starts_.push_back(i + 1);
+  }
+}
+
+bool LineTable::IsBuilt() const
+{
+  return !line_starts_.empty();
+}
+
+void LineTable::GetLineColumn(uint32_t offset, int &line_num,
+                              int &col_num) const
+{
+  // Last line starting at or before offset.
+  auto it = std::upper_bound(line_starts_.begin(), line_starts_.end(),
+                             offset) - 1;
+
+  line_num = static_cast<int>(it - line_starts_.begin()) + 1;
+  col_num = offset - *it + 1;
+}
+
+int LineTable::ClampColumn(int line_num, int col_num) const
+{
+  size_t line_start = line_starts_[line_num - 1];
+
+  if (line_start >= size_)
+    return 1;
+
+  // Same scan as SourceManager::translateLineCol.
+  size_t remaining = size_ - line_start;
+  const char *line = data_ + line_start;
+  size_t i = 0;
+
+  while (i < remaining - 1 && i < static_cast<size_t>(col_num - 1) &&
+         line[i] != '\n' && line[i] != '\r')
+    i++;
+
+  return static_cast<int>(i) + 1;
+}
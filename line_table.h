@@ -0,0 +1,42 @@
+#ifndef MUSIC_LINE_TABLE_H_
+#define MUSIC_LINE_TABLE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+  Start offset of every line of a file, to turn byte offsets into line and
+  column numbers without going through clang's SourceManager.
+
+  Lines end at "\n", "\r\n" or a lone "\r", and columns count bytes from 1,
+  as for SourceManager::getExpansionLineNumber/getExpansionColumnNumber.
+*/
+class LineTable
+{
+public:
+  LineTable();
+
+  // Index the lines of [data, data + size), which must outlive the table.
+  void Build(const char *data, size_t size);
+
+  bool IsBuilt() const;
+
+  // Line and column of byte offset. Offsets past the end of data are
+  // counted on the last line.
+  void GetLineColumn(uint32_t offset, int &line_num, int &col_num) const;
+
+  /**
+    Column on line_num that SourceManager::translateLineCol gives for
+    col_num: col_num, or the column of the end of the line (or of the last
+    byte of the file) if the line is shorter.
+  */
+  int ClampColumn(int line_num, int col_num) const;
+
+private:
+  const char *data_;
+  size_t size_;
+  std::vector<uint32_t> line_starts_;
+};
+
+#endif  // MUSIC_LINE_TABLE_H_
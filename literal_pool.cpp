@@ -0,0 +1,238 @@
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+
+#include "literal_pool.h"
+
+namespace {
+
+/**
+  Positions of a sorted list of literal indices, without the one at
+  excluded_ (if any), as if that literal had been erased.
+*/
+class NumberView
+{
+public:
+  NumberView(const std::vector<uint32_t> &sorted, size_t excluded,
+             const std::vector<long long> &numbers)
+    : sorted_(sorted), excluded_(excluded), numbers_(numbers)
+  {}
+
+  size_t getSize() const
+  {
+    return sorted_.size() - (excluded_ < sorted_.size() ? 1 : 0);
+  }
+
+  long long getNumber(size_t pos) const
+  {
+    return numbers_[sorted_[pos < excluded_ ? pos : pos + 1]];
+  }
+
+  // First position with a number not less than n.
+  size_t LowerBound(long long n) const
+  {
+    auto it = std::lower_bound(sorted_.begin(), sorted_.end(), n,
+                               [this](uint32_t i, long long n)
+                               { return numbers_[i] < n; });
+
+    return ToViewPosition(it - sorted_.begin());
+  }
+
+  // First position with a number greater than n.
+  size_t UpperBound(long long n) const
+  {
+    auto it = std::upper_bound(sorted_.begin(), sorted_.end(), n,
+                               [this](long long n, uint32_t i)
+                               { return n < numbers_[i]; });
+
+    return ToViewPosition(it - sorted_.begin());
+  }
+
+private:
+  const std::vector<uint32_t> &sorted_;
+  size_t excluded_;
+  const std::vector<long long> &numbers_;
+
+  size_t ToViewPosition(size_t pos) const
+  {
+    return excluded_ < pos ? pos - 1 : pos;
+  }
+};
+
+// Parse the integer s starts with, as stoll does.
+bool ParseLeadingInteger(const std::string &s, long long &n)
+{
+  const char *start = s.c_str();
+  char *end;
+
+  errno = 0;
+  n = strtoll(start, &end, 10);
+
+  return end != start && errno == 0;
+}
+
+}  // namespace
+
+ConstantSelectors::ConstantSelectors()
+  : choose_max_(false), choose_min_(false), choose_median_(false),
+    close_less_(false), close_more_(false)
+{}
+
+void ConstantSelectors::TakeFromRange(std::set<std::string> &range)
+{
+  for (auto it = range.begin(); it != range.end(); )
+  {
+    if (it->compare("MAX") == 0)
+      choose_max_ = true;
+    else if (it->compare("MIN") == 0)
+      choose_min_ = true;
+    else if (it->compare("MEDIAN") == 0)
+      choose_median_ = true;
+    else if (it->compare("CLOSE_LESS") == 0)
+      close_less_ = true;
+    else if (it->compare("CLOSE_MORE") == 0)
+      close_more_ = true;
+    else
+    {
+      ++it;
+      continue;
+    }
+
+    it = range.erase(it);
+  }
+}
+
+bool ConstantSelectors::IsEmpty() const
+{
+  return !(choose_max_ || choose_min_ || choose_median_ || close_less_ ||
+           close_more_);
+}
+
+LiteralPool::LiteralPool()
+  : is_sorted_(true)
+{}
+
+bool LiteralPool::Add(const Literal &literal)
+{
+  if (values_.Intern(literal.value_) < literals_.size())
+    return false;
+
+  long long number;
+  bool has_number = ParseLeadingInteger(literal.value_, number);
+
+  literals_.push_back(literal);
+  numbers_.push_back(has_number ? number : 0);
+  has_number_.push_back(has_number);
+
+  if (has_number)
+    is_sorted_ = false;
+
+  return true;
+}
+
+size_t LiteralPool::getSize() const
+{
+  return literals_.size();
+}
+
+LiteralPool::const_iterator LiteralPool::begin() const
+{
+  return literals_.begin();
+}
+
+LiteralPool::const_iterator LiteralPool::end() const
+{
+  return literals_.end();
+}
+
+void LiteralPool::SortNumbers()
+{
+  sorted_.clear();
+  sorted_integral_.clear();
+
+  for (uint32_t i = 0; i < literals_.size(); i++)
+    if (has_number_[i])
+      sorted_.push_back(i);
+
+  std::stable_sort(sorted_.begin(), sorted_.end(),
+                   [this](uint32_t i, uint32_t j)
+                   { return numbers_[i] < numbers_[j]; });
+
+  for (auto i: sorted_)
+    if (!literals_[i].is_floating_)
+      sorted_integral_.push_back(i);
+
+  is_sorted_ = true;
+}
+
+void LiteralPool::SelectConstants(
+    const ConstantSelectors &selectors, const std::string &value,
+    bool skip_floating, const LiteralFilter &filter,
+    std::vector<std::string> *range)
+{
+  if (!is_sorted_)
+    SortNumbers();
+
+  const std::vector<uint32_t> &sorted = skip_floating ? sorted_integral_ :
+                                                        sorted_;
+  uint32_t own_index;
+  bool has_own = values_.Find(value, own_index);
+
+  // Without filter, candidates are the sorted literals but the one with
+  // the value being mutated. Otherwise list the candidates left.
+  std::vector<uint32_t> candidates;
+  size_t excluded = sorted.size();
+
+  if (filter)
+  {
+    for (auto i: sorted)
+      if (!(has_own && i == own_index) && filter(literals_[i]))
+        candidates.push_back(i);
+
+    excluded = candidates.size();
+  }
+  else if (has_own && has_number_[own_index])
+  {
+    // Equal numbers are sorted by index.
+    auto it = std::lower_bound(sorted.begin(), sorted.end(), own_index,
+                               [this](uint32_t i, uint32_t own_index)
+                               {
+                                 return numbers_[i] < numbers_[own_index] ||
+                                        (numbers_[i] == numbers_[own_index] &&
+                                         i < own_index);
+                               });
+
+    if (it != sorted.end() && *it == own_index)
+      excluded = it - sorted.begin();
+  }
+
+  NumberView view(filter ? candidates : sorted, excluded, numbers_);
+  size_t size = view.getSize();
+
+  if (size == 0)
+    return;
+
+  if (selectors.choose_max_)
+    range->push_back(std::to_string(view.getNumber(size - 1)));
+
+  if (selectors.choose_min_)
+    range->push_back(std::to_string(view.getNumber(0)));
+
+  if (selectors.choose_median_)
+    range->push_back(std::to_string(view.getNumber(size / 2)));
+
+  long long token_number;
+
+  if (!ParseLeadingInteger(value, token_number))
+    return;
+
+  // The closest smaller constant exists only if the literal is above the
+  // smallest one, the closest larger one if it is below the largest one.
+  if (selectors.close_less_ && token_number > view.getNumber(0))
+    range->push_back(std::to_string(
+        view.getNumber(view.UpperBound(token_number) - 1)));
+
+  if (selectors.close_more_ && token_number < view.getNumber(size - 1))
+    range->push_back(std::to_string(
+        view.getNumber(view.LowerBound(token_number))));
+}
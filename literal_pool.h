@@ -0,0 +1,123 @@
+#ifndef MUSIC_LITERAL_POOL_H_
+#define MUSIC_LITERAL_POOL_H_
+
+#include <functional>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "mutant_entry.h"
+
+namespace clang {
+class Expr;
+}
+
+/**
+  A literal collected from the input file, with the strings mutation
+  operators need so they do not have to print the expression again.
+
+  @param  expr_ first occurrence of the literal
+          spelling_ source text of the literal
+          value_ normalized value: char literals and integer literals in
+                 hexadecimal, octal or binary as decimal (suffix kept),
+                 spelling_ otherwise
+          token_ text a replaced token becomes: value_ for char literals,
+                 spelling_ otherwise
+          function_id_ id of the function using the literal, -1 if global
+          is_floating_ True for floating literals
+*/
+struct Literal
+{
+  clang::Expr *expr_;
+  std::string spelling_;
+  std::string value_;
+  std::string token_;
+  int function_id_;
+  bool is_floating_;
+};
+
+/**
+  Predefined values of the range of CGCR and CLCR, picked among the
+  constants a literal can be replaced with:
+
+  @param  choose_max_ largest constant (MAX)
+          choose_min_ smallest constant (MIN)
+          choose_median_ median constant (MEDIAN)
+          close_less_ largest constant not above the literal (CLOSE_LESS)
+          close_more_ smallest constant not below the literal (CLOSE_MORE)
+*/
+struct ConstantSelectors
+{
+  bool choose_max_;
+  bool choose_min_;
+  bool choose_median_;
+  bool close_less_;
+  bool close_more_;
+
+  ConstantSelectors();
+
+  // Move the predefined values out of range into the flags.
+  void TakeFromRange(std::set<std::string> &range);
+
+  bool IsEmpty() const;
+};
+
+/**
+  Literals of one scope (global scope or a function), each value stored
+  once, in order of first occurrence.
+
+  Literals whose value_ starts with an integer are also kept sorted by
+  that integer, so ConstantSelectors are answered by binary search.
+*/
+class LiteralPool
+{
+public:
+  typedef std::vector<Literal>::const_iterator const_iterator;
+
+  // Return True if a literal can replace the one being mutated.
+  typedef std::function<bool(const Literal&)> LiteralFilter;
+
+  LiteralPool();
+
+  // Add literal unless the pool holds one with the same value_.
+  // Return True if it was added.
+  bool Add(const Literal &literal);
+
+  size_t getSize() const;
+  const_iterator begin() const;
+  const_iterator end() const;
+
+  /**
+    Append to range the values selectors pick among the integers of the
+    literals of the pool, as decimal strings.
+
+    @param  value normalized value of the literal being mutated. The
+                  literal of the pool with this value is not a candidate.
+            skip_floating True if floating literals are not candidates
+            filter other candidates to leave out, may be empty
+  */
+  void SelectConstants(const ConstantSelectors &selectors,
+                       const std::string &value, bool skip_floating,
+                       const LiteralFilter &filter,
+                       std::vector<std::string> *range);
+
+private:
+  // Literal i has value i in values_.
+  StringPool values_;
+  std::vector<Literal> literals_;
+
+  // numbers_[i] is the integer value_ of literal i starts with, if
+  // has_number_[i].
+  std::vector<long long> numbers_;
+  std::vector<bool> has_number_;
+
+  // Indices of the literals with an integer, sorted by it: all of them,
+  // and the non-floating ones. Sorted on first use after Add.
+  std::vector<uint32_t> sorted_;
+  std::vector<uint32_t> sorted_integral_;
+  bool is_sorted_;
+
+  void SortNumbers();
+};
+
+#endif  // MUSIC_LITERAL_POOL_H_
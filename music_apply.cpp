@@ -0,0 +1,215 @@
+#include <cerrno>
+#include <cstdlib>
+#include <iostream>
+#include <fstream>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "pack_file.h"
+#include "patch_file.h"
+
+using namespace std;
+
+/**
+  Turn mutants recorded in a patch file (MUSIC option -patch) back into
+  full source files, or extract them from a pack file (MUSIC option -pack).
+
+  Usage: music-apply <patch file> <original source> [mutant filename ...]
+                     [-o <directory>]
+         music-apply -pack <pack file> [mutant id ...] [-o <directory>]
+
+  If no mutant filename or id is given, every mutant in the patch or pack
+  file is written.
+*/
+
+void PrintUsage()
+{
+  cout << "Usage: music-apply <patch file> <original source> "
+       << "[mutant filename ...] [-o <directory>]\n"
+       << "       music-apply -pack <pack file> [mutant id ...] "
+       << "[-o <directory>]\n";
+}
+
+// Write mutant under its name in output_dir, creating its directories
+// (mutant files of MUSIC option -layout sharded).
+void WriteMutant(const string &output_dir, const string &name,
+                 const string &mutant)
+{
+  string mutant_filename{output_dir};
+  mutant_filename += name;
+
+  CreateParentDirectories(mutant_filename);
+  ofstream output(mutant_filename.data(), ios::binary);
+
+  if (!output.is_open())
+  {
+    cout << "Cannot write " << mutant_filename << endl;
+    exit(1);
+  }
+
+  output << mutant;
+  output.close();
+}
+
+// Extract mutants with given ids (all if none) from pack file.
+int ExtractPack(const string &pack_filename, const vector<string> &ids,
+                const string &output_dir)
+{
+  PackFile pack;
+
+  if (!pack.Open(pack_filename))
+  {
+    cout << "Invalid pack file: " << pack_filename << endl;
+    exit(1);
+  }
+
+  vector<const PackIndexEntry *> members;
+
+  for (uint32_t i = 0; ids.empty() && i < pack.getMemberCount(); i++)
+    members.push_back(&pack.getMember(i));
+
+  for (auto &id: ids)
+  {
+    // Ids of -stable-ids use all 64 bits.
+    errno = 0;
+    uint64_t mutant_id = strtoull(id.c_str(), nullptr, 10);
+
+    if (id.empty() || id.find_first_not_of("0123456789") != string::npos ||
+        errno == ERANGE)
+    {
+      cout << "Invalid mutant id: " << id << endl;
+      exit(1);
+    }
+
+    const PackIndexEntry *member = pack.FindById(mutant_id);
+
+    if (member == nullptr)
+    {
+      cout << "Mutant not found in pack file: " << id << endl;
+      exit(1);
+    }
+
+    members.push_back(member);
+  }
+
+  string mutant;
+
+  for (auto member: members)
+  {
+    if (!pack.Extract(*member, mutant))
+    {
+      cout << "Mutant " << member->mutant_id_ << " is corrupted\n";
+      exit(1);
+    }
+
+    WriteMutant(output_dir, pack.getName(*member), mutant);
+  }
+
+  cout << "wrote " << members.size() << " mutants\n";
+  return 0;
+}
+
+int main(int argc, const char *argv[])
+{
+  vector<string> positional_args;
+  string output_dir = "./";
+  bool use_pack = false;
+
+  for (int i = 1; i < argc; i++)
+  {
+    string arg{argv[i]};
+
+    if (arg == "-o")
+    {
+      if (i + 1 == argc)
+      {
+        PrintUsage();
+        exit(1);
+      }
+
+      output_dir = argv[++i];
+    }
+    else if (arg == "-pack")
+      use_pack = true;
+    else
+      positional_args.push_back(arg);
+  }
+
+  if (positional_args.size() < (use_pack ? 1 : 2))
+  {
+    PrintUsage();
+    exit(1);
+  }
+
+  if (output_dir.back() != '/')
+    output_dir += "/";
+
+  if (use_pack)
+    return ExtractPack(positional_args[0],
+                       vector<string>(positional_args.begin() + 1,
+                                      positional_args.end()),
+                       output_dir);
+
+  PatchFileHeader header;
+  vector<PatchRecord> records;
+
+  if (!ReadPatchFile(positional_args[0], header, records))
+  {
+    cout << "Invalid patch file: " << positional_args[0] << endl;
+    exit(1);
+  }
+
+  string original;
+
+  if (!ReadWholeFile(positional_args[1], original))
+  {
+    cout << "Cannot open original source: " << positional_args[1] << endl;
+    exit(1);
+  }
+
+  // Edits are byte offsets, so they are only meaningful against the exact
+  // content mutants were generated from.
+  if (original.length() != header.original_size_ ||
+      HashFileContent(original) != header.original_hash_)
+  {
+    cout << positional_args[1] << " does not match " <<
+            header.original_filename_ << " recorded in patch file\n";
+    exit(1);
+  }
+
+  set<string> wanted_mutants(positional_args.begin() + 2,
+                             positional_args.end());
+  set<string> written_mutants;
+  string mutant;
+  int count = 0;
+
+  for (auto &record: records)
+  {
+    if (!wanted_mutants.empty() &&
+        wanted_mutants.find(record.mutant_filename_) == wanted_mutants.end())
+      continue;
+
+    if (!ApplyPatchRecord(original, record, mutant))
+    {
+      cout << "Edit of " << record.mutant_filename_ << " is out of range\n";
+      exit(1);
+    }
+
+    WriteMutant(output_dir, record.mutant_filename_, mutant);
+    written_mutants.insert(record.mutant_filename_);
+    count++;
+  }
+
+  if (written_mutants.size() != wanted_mutants.size() &&
+      !wanted_mutants.empty())
+  {
+    for (auto &name: wanted_mutants)
+      if (written_mutants.find(name) == written_mutants.end())
+        cout << "Mutant not found in patch file: " << name << endl;
+    exit(1);
+  }
+
+  cout << "wrote " << count << " mutants\n";
+  return 0;
+}
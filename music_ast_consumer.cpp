@@ -1,6 +1,34 @@
 #include "music_ast_consumer.h"
 #include "music_utility.h"
 
+namespace {
+
+// Apply mutant_operator to node as the visitor does, recording the time of
+// IsMutationTarget and Mutate and the mutants generated (option
+// -phase-stats).
+template <typename OperatorType, typename NodeType>
+void MutateWithStats(OperatorType *mutant_operator, NodeType *node,
+                     MusicContext *context, MusicStats *stats)
+{
+  StatsClock::time_point start = StatsClock::now();
+  bool is_target = mutant_operator->IsMutationTarget(node, context);
+  StatsClock::time_point target_end = StatsClock::now();
+
+  stats->AddIsMutationTarget(mutant_operator->getName(), target_end - start);
+
+  if (!is_target)
+    return;
+
+  uint64_t num_mutants = context->mutant_database_.getNumGeneratedEntries();
+  mutant_operator->Mutate(node, context);
+
+  stats->AddMutate(
+      mutant_operator->getName(), StatsClock::now() - target_end,
+      context->mutant_database_.getNumGeneratedEntries() - num_mutants);
+}
+
+}  // namespace
+
 void MusicASTVisitor::UpdateAddressOfRange(
     UnaryOperator *uo, SourceLocation *start_loc, SourceLocation *end_loc)
 {
@@ -24,25 +52,6 @@ void MusicASTVisitor::UpdateAddressOfRange(
   }
 }
 
-/**
-  @param  scalarref_name: string of name of a declaration reference
-  @return True if reference name is not in the prohibited list
-      False otherwise
-*/
-bool MusicASTVisitor::IsScalarRefMutatableByVtwd(string scalarref_name)
-{
-  // cout << "IsScalarRefMutatableByVtwd called\n";
-  // if reference name is in the nonMutatableList then it is not mutatable
-  for (auto it = non_VTWD_mutatable_scalarref_list_.begin(); 
-        it != non_VTWD_mutatable_scalarref_list_.end(); ++it)
-  {
-    if (scalarref_name.compare(*it) == 0)
-      return false;
-  }
-
-  return true;
-}
-
 /**
   if there are addition of multiple scalar reference
   then only mutate one, put all the other inside the nonMutatableList
@@ -72,28 +81,14 @@ bool MusicASTVisitor::CollectNonVtwdMutatableScalarRef(
       if (!exclude_last_scalarref)  // collect all references possible
       {
         if (ExprIsScalarReference(rhs))
-        {
-          string reference_name{
-              ConvertToString(rhs, comp_inst_->getLangOpts())};
-
-          // if this scalar reference is mutatable then block it
-          if (IsScalarRefMutatableByVtwd(reference_name))
-            non_VTWD_mutatable_scalarref_list_.push_back(reference_name);
-        }
+          non_VTWD_mutatable_scalarref_set_.insert(rhs);
         else if (ParenExpr *pe = dyn_cast<ParenExpr>(rhs))
           CollectNonVtwdMutatableScalarRef(pe->getSubExpr(), false);
         else
           ;   // do nothing
 
         if (ExprIsScalarReference(lhs))
-        {
-          string reference_name{
-              ConvertToString(lhs, comp_inst_->getLangOpts())};
-
-          // if this scalar reference is mutatable then block it
-          if (IsScalarRefMutatableByVtwd(reference_name))
-            non_VTWD_mutatable_scalarref_list_.push_back(reference_name);
-        }
+          non_VTWD_mutatable_scalarref_set_.insert(lhs);
         else if (ParenExpr *pe = dyn_cast<ParenExpr>(lhs))
           CollectNonVtwdMutatableScalarRef(pe->getSubExpr(), false);
         else
@@ -116,14 +111,7 @@ bool MusicASTVisitor::CollectNonVtwdMutatableScalarRef(
         if (ExprIsScalarReference(lhs))
         {
           if (scalarref_excluded)
-          {
-            string reference_name{
-                ConvertToString(lhs, comp_inst_->getLangOpts())};
-
-            // if this scalar reference is mutatable then block it
-            if (IsScalarRefMutatableByVtwd(reference_name))
-              non_VTWD_mutatable_scalarref_list_.push_back(reference_name);
-          }
+            non_VTWD_mutatable_scalarref_set_.insert(lhs);
           else
             scalarref_excluded = true;
         }
@@ -228,6 +216,74 @@ void MusicASTVisitor::HandleBinaryOperatorExpr(Expr *e)
   }
 }
 
+bool MusicASTVisitor::IsInSchemaExcludedRange(SourceLocation loc)
+{
+  for (auto range: schema_excluded_range_list_)
+    if (LocationIsInRange(loc, range))
+      return true;
+
+  return false;
+}
+
+void MusicASTVisitor::AddExprSchemaRegion(Expr *e)
+{
+  SourceLocation start_loc = e->getLocStart();
+  SourceLocation end_loc = e->getLocEnd();
+
+  // Expressions with an unevaluated or constant operand exclude the operand.
+  // The expression itself is still evaluated at runtime.
+  bool excludes_operand = isa<UnaryExprOrTypeTraitExpr>(e) || 
+                          isa<OffsetOfExpr>(e) || isa<ChooseExpr>(e) ||
+                          isa<GenericSelectionExpr>(e);
+
+  if (start_loc.isMacroID() || end_loc.isMacroID() ||
+      !src_mgr_.isInMainFile(start_loc) ||
+      !stmt_context_.IsInCurrentlyParsedFunctionRange(start_loc) ||
+      IsInSchemaExcludedRange(start_loc))
+    return;
+
+  end_loc = GetEndLocOfExpr(e, comp_inst_);
+
+  if (excludes_operand)
+    schema_excluded_range_list_.push_back(SourceRange(start_loc, end_loc));
+
+  if (!e->isRValue() || !e->getType()->isScalarType() || 
+      stmt_context_.IsInArrayDeclSize() || 
+      stmt_context_.IsInSwitchCaseRange(e) || 
+      stmt_context_.IsInFieldDeclRange(e))
+    return;
+
+  context_.mutant_database_.AddSchemaRegion(kSchemaExprRegion, 
+                                            start_loc, end_loc);
+}
+
+void MusicASTVisitor::AddStmtSchemaRegion(Stmt *s, bool gives_stmtexpr_value)
+{
+  // Wrapping a declaration in braces ends its scope early.
+  // Labels are handled by the statement right after them.
+  if (gives_stmtexpr_value || isa<DeclStmt>(s) || isa<NullStmt>(s) ||
+      isa<LabelStmt>(s) || isa<SwitchCase>(s))
+    return;
+
+  SourceLocation start_loc = s->getLocStart();
+  SourceLocation end_loc = s->getLocEnd();
+
+  if (start_loc.isMacroID() || end_loc.isMacroID() ||
+      !src_mgr_.isInMainFile(start_loc) ||
+      !stmt_context_.IsInCurrentlyParsedFunctionRange(start_loc))
+    return;
+
+  // Same range SSDL deletes, including the trailing semicolon.
+  end_loc = GetLocationAfterSemicolon(
+      src_mgr_, GetEndLocOfStmt(end_loc, comp_inst_));
+
+  if (end_loc.isInvalid())
+    return;
+
+  context_.mutant_database_.AddSchemaRegion(kSchemaStmtRegion, 
+                                            start_loc, end_loc);
+}
+
 MusicASTVisitor::MusicASTVisitor(
     clang::CompilerInstance *CI, 
     LabelStmtToGotoStmtListMap *label_to_gotolist_map, 
@@ -237,7 +293,8 @@ MusicASTVisitor::MusicASTVisitor(
   : src_mgr_(CI->getSourceManager()),
     comp_inst_(CI), context_(context), stmt_context_(context.getStmtContext()),
     stmt_mutant_operator_list_(stmt_operator_list),
-    expr_mutant_operator_list_(expr_operator_list)
+    expr_mutant_operator_list_(expr_operator_list),
+    dispatch_table_(stmt_operator_list, expr_operator_list)
 {
   proteumstyle_stmt_end_line_num_ = 0;
 
@@ -253,7 +310,7 @@ MusicASTVisitor::MusicASTVisitor(
   array_decl_range_ = new SourceRange(start_of_file, start_of_file);
 
   context_.switchstmt_info_list_ = &switchstmt_info_list_;
-  context_.non_VTWD_mutatable_scalarref_list_ = &non_VTWD_mutatable_scalarref_list_;
+  context_.non_VTWD_mutatable_scalarref_set_ = &non_VTWD_mutatable_scalarref_set_;
 
   context_.scope_list_ = &scope_list_;
 }
@@ -329,8 +386,16 @@ bool MusicASTVisitor::VisitStmt(clang::Stmt *s)
   if (isa<ForStmt>(s))
     scope_list_.push_back(SourceRange(start_loc, end_loc));
 
-  for (auto mutant_operator: stmt_mutant_operator_list_)
-    if (mutant_operator->IsMutationTarget(s, &context_))
+  // A label must not be duplicated into the arms of a mutant schema.
+  if (isa<LabelStmt>(s) && context_.getConfiguration()->getSchemataOutput())
+    context_.mutant_database_.AddSchemaBarrier(start_loc, SourceRange());
+
+  MusicStats *stats = context_.getStats();
+
+  for (auto mutant_operator: dispatch_table_.getStmtOperators(s))
+    if (stats != nullptr)
+      MutateWithStats(mutant_operator, s, &context_, stats);
+    else if (mutant_operator->IsMutationTarget(s, &context_))
       mutant_operator->Mutate(s, &context_);
 
   return true;
@@ -357,6 +422,29 @@ bool MusicASTVisitor::VisitCompoundStmt(clang::CompoundStmt *c)
   // entering a new scope
   scope_list_.push_back(SourceRange(c->getLocStart(), c->getLocEnd()));
 
+  if (context_.getConfiguration()->getSchemataOutput())
+  {
+    bool is_stmtexpr_body = stmtexpr_body_set_.count(c) > 0;
+
+    for (auto it = c->body_begin(); it != c->body_end(); ++it)
+    {
+      Stmt *sub_stmt = *it;
+
+      // Statement right after labels is also followed by a statement
+      // of this compound, never by an else.
+      while (isa<LabelStmt>(sub_stmt) || isa<SwitchCase>(sub_stmt))
+      {
+        if (LabelStmt *ls = dyn_cast<LabelStmt>(sub_stmt))
+          sub_stmt = ls->getSubStmt();
+        else
+          sub_stmt = cast<SwitchCase>(sub_stmt)->getSubStmt();
+      }
+
+      AddStmtSchemaRegion(sub_stmt, 
+                          is_stmtexpr_body && it + 1 == c->body_end());
+    }
+  }
+
   return true;
 }
 
@@ -458,6 +546,12 @@ bool MusicASTVisitor::VisitSwitchCase(clang::SwitchCase *sc)
              sc->getLocStart(), switchstmt_info_list_.back().first))
     switchstmt_info_list_.pop_back();
 
+  // A case label can only be duplicated together with its switch.
+  if (context_.getConfiguration()->getSchemataOutput() &&
+      !switchstmt_info_list_.empty())
+    context_.mutant_database_.AddSchemaBarrier(
+        sc->getLocStart(), switchstmt_info_list_.back().first);
+
   return true;
 }
 
@@ -490,12 +584,22 @@ bool MusicASTVisitor::VisitExpr(clang::Expr *e)
   //   return true;
   // }
 
+  // Facts about e computed by one operator are reused by the others.
+  context_.ResetExprAnalysis(e);
+
   // Do not mutate or consider anything inside a typedef definition
-  if (stmt_context_.IsInTypedefRange(e))
+  if (context_.getExprAnalysis(e).IsInTypedefRange())
     return true;
 
-  for (auto mutant_operator: expr_mutant_operator_list_)
-    if (mutant_operator->IsMutationTarget(e, &context_))
+  if (context_.getConfiguration()->getSchemataOutput())
+    AddExprSchemaRegion(e);
+
+  MusicStats *stats = context_.getStats();
+
+  for (auto mutant_operator: dispatch_table_.getExprOperators(e))
+    if (stats != nullptr)
+      MutateWithStats(mutant_operator, e, &context_, stats);
+    else if (mutant_operator->IsMutationTarget(e, &context_))
     {
       // if (GetLineNumber(src_mgr_, e->getLocStart()) == 49)
       //   cout << "yes\n";
@@ -507,6 +611,8 @@ bool MusicASTVisitor::VisitExpr(clang::Expr *e)
   {
     // set boolean variable signals following stmt are inside stmt expr
     stmt_context_.setIsInStmtExpr(true);
+
+    stmtexpr_body_set_.insert(se->getSubStmt());
   }
   else if (ArraySubscriptExpr *ase = dyn_cast<ArraySubscriptExpr>(e))
   {
@@ -526,6 +632,10 @@ bool MusicASTVisitor::VisitExpr(clang::Expr *e)
 bool MusicASTVisitor::VisitEnumDecl(clang::EnumDecl *ed)
 {
   stmt_context_.setIsInEnumDecl(true);
+
+  // enumerator values must be constant
+  schema_excluded_range_list_.push_back(
+      SourceRange(ed->getLocStart(), ed->getLocEnd()));
   return true;
 }
 
@@ -575,6 +685,10 @@ bool MusicASTVisitor::VisitVarDecl(clang::VarDecl *vd)
 
   stmt_context_.setIsInEnumDecl(false);
 
+  // initializer of static local variable must be constant
+  if (vd->isStaticLocal())
+    schema_excluded_range_list_.push_back(SourceRange(start_loc, end_loc));
+
   if (stmt_context_.IsInTypedefRange(start_loc))
     return true;
 
@@ -598,6 +712,35 @@ bool MusicASTVisitor::VisitVarDecl(clang::VarDecl *vd)
   return true;
 }
 
+bool MusicASTVisitor::TraverseDecl(clang::Decl *d)
+{
+  // InformationVisitor skips the same FunctionDecls, so both count function
+  // ids over the same functions.
+  if (d != nullptr && !isa<TranslationUnitDecl>(d) &&
+      (isa<FunctionDecl>(d) ||
+       d->getLexicalDeclContext()->getRedeclContext()->isFileContext()) &&
+      DeclIsOutsideMutationRange(src_mgr_, d, context_.getConfiguration()))
+    return true;
+
+  MusicStats *stats = context_.getStats();
+  FunctionDecl *f = dyn_cast_or_null<FunctionDecl>(d);
+
+  if (stats == nullptr || f == nullptr ||
+      !f->doesThisDeclarationHaveABody())
+    return RecursiveASTVisitor<MusicASTVisitor>::TraverseDecl(d);
+
+  // Cost of generating the mutants of each function definition.
+  StatsClock::time_point start = StatsClock::now();
+  uint64_t num_mutants = context_.mutant_database_.getNumGeneratedEntries();
+  bool result = RecursiveASTVisitor<MusicASTVisitor>::TraverseDecl(d);
+
+  stats->AddFunction(
+      f->getQualifiedNameAsString(), GetLineNumber(src_mgr_, f->getLocStart()),
+      start, StatsClock::now(),
+      context_.mutant_database_.getNumGeneratedEntries() - num_mutants);
+  return result;
+}
+
 bool MusicASTVisitor::VisitFunctionDecl(clang::FunctionDecl *f) 
 {   
   // Function with nobody, and function declaration within 
@@ -622,6 +765,20 @@ bool MusicASTVisitor::VisitFunctionDecl(clang::FunctionDecl *f)
     stmt_context_.setCurrentlyParsedFunctionRange(
         new SourceRange(f->getLocStart(), f->getLocEnd()));
 
+    // Only the function body can hold mutant schemata, not expressions
+    // in parameter declarations.
+    schema_excluded_range_list_.clear();
+    schema_excluded_range_list_.push_back(
+        SourceRange(f->getLocStart(), f->getBody()->getLocStart()));
+    stmtexpr_body_set_.clear();
+
+    // Option -incremental reuses mutants of functions whose text has not
+    // changed since the last run.
+    if (f->doesThisDeclarationHaveABody())
+      context_.mutant_database_.AddFunction(
+          f->getQualifiedNameAsString() + " " + f->getType().getAsString(),
+          f->getLocStart(), f->getLocEnd());
+
     // if (f->getName().compare("read_field_headers") == 0 ||
     //     f->getName().compare("formparse") == 0)
     // {
@@ -639,7 +796,7 @@ MusicASTConsumer::MusicASTConsumer(
     std::vector<ExprMutantOperator*> &expr_operator_list,
     MusicContext &context)
   : Visitor(CI, label_to_gotolist_map, stmt_operator_list, 
-            expr_operator_list, context) 
+            expr_operator_list, context), context_(context)
 { 
 }
 
@@ -647,5 +804,7 @@ void MusicASTConsumer::HandleTranslationUnit(clang::ASTContext &Context)
 {
   /* we can use ASTContext to get the TranslationUnitDecl, which is
   a single Decl that collectively represents the entire source file */
+  context_.mutant_database_.CheckFileScopeOfFunctionCache(
+      Context.getTranslationUnitDecl());
   Visitor.TraverseDecl(Context.getTranslationUnitDecl());
 }
\ No newline at end of file
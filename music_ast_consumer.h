@@ -3,6 +3,7 @@
 
 #include <vector>
 #include <string>
+#include <unordered_set>
 
 #include "clang/AST/ASTConsumer.h"
 #include "clang/AST/RecursiveASTVisitor.h"
@@ -15,6 +16,7 @@
 #include "mutation_operators/expr_mutant_operator.h"
 #include "mutation_operators/stmt_mutant_operator.h"
 #include "music_context.h"
+#include "operator_dispatch_table.h"
 
 class MusicASTVisitor : public clang::RecursiveASTVisitor<MusicASTVisitor>
 {
@@ -35,24 +37,29 @@ private:
 
   SwitchStmtInfoList switchstmt_info_list_;
 
-  ScalarReferenceNameList non_VTWD_mutatable_scalarref_list_;
+  ScalarReferenceSet non_VTWD_mutatable_scalarref_set_;
+
+  // Ranges inside current function whose expressions must stay constant
+  // or unevaluated (case labels, sizeof, static initializers, ...).
+  // Used only in schemata output mode.
+  std::vector<clang::SourceRange> schema_excluded_range_list_;
+
+  // Compound statements that are the body of a statement expression.
+  // Their last statement gives the value of the statement expression.
+  std::unordered_set<clang::Stmt*> stmtexpr_body_set_;
 
   MusicContext &context_;
   StmtContext &stmt_context_;
   std::vector<StmtMutantOperator*> &stmt_mutant_operator_list_;
   std::vector<ExprMutantOperator*> &expr_mutant_operator_list_;
 
+  // Operators of the lists above by kind of node they can mutate.
+  OperatorDispatchTable dispatch_table_;
+
   void UpdateAddressOfRange(clang::UnaryOperator *uo, 
                             clang::SourceLocation *start_loc, 
                             clang::SourceLocation *end_loc);
 
-  /**
-    @param  scalarref_name: string of name of a declaration reference
-    @return True if reference name is not in the prohibited list
-        False otherwise
-  */
-  bool IsScalarRefMutatableByVtwd(std::string scalarref_name);
-
   /**
     if there are addition of multiple scalar reference
     then only mutate one, put all the other inside the nonMutatableList
@@ -72,6 +79,27 @@ private:
 
   void HandleBinaryOperatorExpr(clang::Expr *e);
 
+  bool IsInSchemaExcludedRange(clang::SourceLocation loc);
+
+  /**
+    Record e as a schema region if its text can be replaced by
+    (__music_id == N ? (mutant) : (original)): a scalar rvalue evaluated at
+    runtime, inside a function body and outside of any macro.
+  */
+  void AddExprSchemaRegion(clang::Expr *e);
+
+  /**
+    Record s as a schema region if its text can be replaced by
+    if (__music_id == N) {mutant} else {original}.
+    s must be a statement directly inside a compound statement or right
+    after a label.
+
+    @param  s statement to record
+            gives_stmtexpr_value True if s is the last statement of a 
+                                 statement expression
+  */
+  void AddStmtSchemaRegion(clang::Stmt *s, bool gives_stmtexpr_value);
+
 public:
   MusicASTVisitor(clang::CompilerInstance *CI, 
                   LabelStmtToGotoStmtListMap *label_to_gotolist_map, 
@@ -79,6 +107,13 @@ public:
                   std::vector<ExprMutantOperator*> &expr_operator_list,
                   MusicContext &context);
 
+  /**
+    Skip functions, and declarations at file scope, that are outside the
+    main file or the mutation range. Their mutants would be discarded
+    anyway, and headers are often most of the translation unit.
+  */
+  bool TraverseDecl(clang::Decl *d);
+
   bool VisitStmt(clang::Stmt *s);
   bool VisitCompoundStmt(clang::CompoundStmt *c);
   bool VisitSwitchStmt(clang::SwitchStmt *ss);
@@ -104,6 +139,7 @@ public:
 
 private:
   MusicASTVisitor Visitor;
+  MusicContext &context_;
 };
 
 #endif    // MUSIC_AST_CONSUMER_H_  
\ No newline at end of file
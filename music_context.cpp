@@ -4,12 +4,14 @@
 
 MusicContext::MusicContext(
     clang::CompilerInstance *CI, Configuration *config,
-    LabelStmtToGotoStmtListMap *label_map, 
+    LabelStmtToGotoStmtListMap *label_map, LabelIndex *label_index,
     SymbolTable *symbol_table, MutantDatabase &mutant_database)
   : comp_inst_(CI), config_(config),
-    label_to_gotolist_map_(label_map), function_id_(-1),
+    label_to_gotolist_map_(label_map), label_index_(label_index),
+    function_id_(-1),
     mutant_database_(mutant_database),
-    symbol_table_(symbol_table), stmt_context_(CI)
+    symbol_table_(symbol_table), stmt_context_(CI), expr_analysis_(this),
+    stats_(nullptr)
 {
 	/*std::string input_filename{config->getInputFilename()};
 	mutant_filename.assign(input_filename, 0, input_filename.length()-2);
@@ -29,7 +31,21 @@ bool MusicContext::IsRangeInMutationRange(clang::SourceRange range)
       std::find(excluded_list.begin(), excluded_list.end(), start_line) != excluded_list.end())
     excluded = true;
 
-	return !excluded && Range1IsPartOfRange2(range, mutation_range);
+	return !excluded && Range1IsPartOfRange2(range, mutation_range) &&
+         mutant_database_.IsInMutatedCode(range.getBegin());
+}
+
+ExprAnalysis& MusicContext::getExprAnalysis(clang::Expr *e)
+{
+  if (expr_analysis_.getExpr() != e)
+    expr_analysis_.Reset(e);
+
+  return expr_analysis_;
+}
+
+void MusicContext::ResetExprAnalysis(clang::Expr *e)
+{
+  expr_analysis_.Reset(e);
 }
 
 int MusicContext::getFunctionId()
@@ -55,4 +71,14 @@ Configuration* MusicContext::getConfiguration() const
 void MusicContext::IncrementFunctionId()
 {
   function_id_++;
+}
+
+MusicStats* MusicContext::getStats() const
+{
+  return stats_;
+}
+
+void MusicContext::setStats(MusicStats *stats)
+{
+  stats_ = stats;
 }
\ No newline at end of file
@@ -5,6 +5,7 @@
 #include <string>
 #include <utility>
 #include <map>
+#include <unordered_set>
 
 #include "clang/Frontend/CompilerInstance.h"
 #include "clang/AST/ASTConsumer.h"
@@ -12,11 +13,16 @@
 #include "clang/AST/ASTContext.h"
 
 #include "configuration.h"
+#include "expr_analysis.h"
+#include "label_index.h"
 #include "symbol_table.h"
 #include "stmt_context.h"
 #include "mutant_database.h"
+#include "music_stats.h"
 
-typedef std::vector<std::string> ScalarReferenceNameList;
+// Scalar references VTWD must not mutate, as the expression nodes
+// visited by the operator (implicit casts stripped).
+typedef std::unordered_set<const clang::Expr*> ScalarReferenceSet;
 
 // Block scope are bounded by curly braces {}.
 // The closer the scope is to the end_loc of vector, the smaller it is.
@@ -35,9 +41,10 @@ public:
   clang::CompilerInstance *comp_inst_;
   
   LabelStmtToGotoStmtListMap *label_to_gotolist_map_;
+  LabelIndex *label_index_;
   SwitchStmtInfoList *switchstmt_info_list_;
 
-  ScalarReferenceNameList *non_VTWD_mutatable_scalarref_list_;
+  ScalarReferenceSet *non_VTWD_mutatable_scalarref_set_;
 
   ScopeRangeList *scope_list_;
 
@@ -45,11 +52,15 @@ public:
 
   MusicContext(
       clang::CompilerInstance *CI, Configuration *config,
-      LabelStmtToGotoStmtListMap *label_map, 
+      LabelStmtToGotoStmtListMap *label_map, LabelIndex *label_index,
       SymbolTable* symbol_table, MutantDatabase &mutant_database);
 
   bool IsRangeInMutationRange(clang::SourceRange range);
 
+  // Cached facts about e, shared by all operators mutating e.
+  ExprAnalysis& getExprAnalysis(clang::Expr *e);
+  void ResetExprAnalysis(clang::Expr *e);
+
   int getFunctionId();
   SymbolTable* getSymbolTable();
   StmtContext& getStmtContext();
@@ -57,12 +68,18 @@ public:
 
   void IncrementFunctionId();
 
+  // Stats of option -phase-stats, nullptr without it.
+  MusicStats* getStats() const;
+  void setStats(MusicStats *stats);
+
 private:
   int function_id_;
 
   SymbolTable *symbol_table_;
   StmtContext stmt_context_;
   Configuration *config_;
+  ExprAnalysis expr_analysis_;
+  MusicStats *stats_;
 };
 
 #endif	// MUSIC_CONTEXT_H_
\ No newline at end of file
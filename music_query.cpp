@@ -0,0 +1,119 @@
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#include "indexed_mutant_database.h"
+
+using namespace std;
+
+/**
+  Look up mutants in an indexed mutant database (MUSIC option
+  -db-format indexed) without scanning the whole database.
+
+  Usage: music-query <database file> id <mutant id>
+         music-query <database file> line <line number>
+         music-query <database file> operator <operator name>
+         music-query <database file> all
+
+  Matching mutants are printed in the same layout as the csv database.
+*/
+
+void PrintUsage()
+{
+  cout << "Usage: music-query <database file> "
+       << "(id <mutant id> | line <line number> | operator <name> | all)\n";
+}
+
+void PrintRecord(const IndexedMutantDatabase &db, const IndexedDbRecord &record)
+{
+  cout << db.getString(record.mutant_filename_) << ",";
+  cout << db.getString(record.operator_name_) << ",";
+
+  // information about token BEFORE mutation
+  cout << record.proteum_line_num_ << ",";
+  cout << record.start_line_ << ",";
+  cout << record.start_col_ << ",";
+  cout << record.end_line_ << ",";
+  cout << record.end_col_ << ",";
+  cout << db.getString(record.token_) << ",";
+
+  // information about token AFTER mutation
+  cout << record.start_line_ << ",";
+  cout << record.start_col_ << ",";
+  cout << record.mutated_end_line_ << ",";
+  cout << record.mutated_end_col_ << ",";
+  cout << db.getString(record.mutated_token_) << "\n";
+}
+
+// Return true if s is a (possibly negative) decimal integer.
+bool IsInteger(const string &s)
+{
+  if (s.empty())
+    return false;
+
+  size_t start = (s[0] == '-') ? 1 : 0;
+
+  if (start == s.length())
+    return false;
+
+  return s.find_first_not_of("0123456789", start) == string::npos;
+}
+
+int main(int argc, const char *argv[])
+{
+  if (argc < 3)
+  {
+    PrintUsage();
+    exit(1);
+  }
+
+  IndexedMutantDatabase db;
+
+  if (!db.Open(argv[1]))
+  {
+    cout << "Invalid indexed mutant database: " << argv[1] << endl;
+    exit(1);
+  }
+
+  string query{argv[2]};
+
+  if (query == "all" && argc == 3)
+  {
+    for (uint32_t i = 0; i < db.getRecordCount(); i++)
+      PrintRecord(db, db.getRecord(i));
+  }
+  else if (query == "id" && argc == 4 && IsInteger(argv[3]) &&
+           argv[3][0] != '-')
+  {
+    const IndexedDbRecord *record = db.FindById(strtoull(argv[3], NULL, 10));
+
+    if (record == nullptr)
+    {
+      cout << "Mutant not found: " << argv[3] << endl;
+      exit(1);
+    }
+
+    PrintRecord(db, *record);
+  }
+  else if (query == "line" && argc == 4 && IsInteger(argv[3]))
+  {
+    IndexedMutantDatabase::IndexRange range = db.FindByLine(atoi(argv[3]));
+
+    for (uint32_t i = range.first; i < range.second; i++)
+      PrintRecord(db, db.getRecordByLineIndex(i));
+  }
+  else if (query == "operator" && argc == 4)
+  {
+    IndexedMutantDatabase::IndexRange range = db.FindByOperator(argv[3]);
+
+    for (uint32_t i = range.first; i < range.second; i++)
+      PrintRecord(db, db.getRecordByOperatorIndex(i));
+  }
+  else
+  {
+    PrintUsage();
+    exit(1);
+  }
+
+  return 0;
+}
@@ -0,0 +1,472 @@
+#include <atomic>
+#include <cctype>
+#include <cerrno>
+#include <chrono>
+#include <climits>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <iostream>
+#include <signal.h>
+#include <string>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+#include "indexed_mutant_database.h"
+#include "runtime/music_runtime.h"
+
+using namespace std;
+
+/**
+  Run mutants of a program built from MUSIC schema files (option -schemata)
+  and linked with runtime/music_runtime.c.
+
+  Usage: music-run -db <database file> [-db <database file> ...]
+                   [-j <numjobs>] [-t <timeout ms>] [-r <results file>]
+                   [-show-output] -- <program> [args ...]
+
+  Mutants listed in the database files (csv or indexed) are dispatched
+  across numjobs fork servers, each one an instance of program started once
+  and forking a child per mutant at music_fork_server(). Results are
+  written to the results file (default music_run_results.csv), one row per
+  mutant, in database order.
+*/
+
+struct MutantToRun
+{
+  string mutant_filename_;
+  string source_filename_;
+  unsigned long long mutant_id_;
+};
+
+struct MutantRunResult
+{
+  string status_;
+  int value_;
+  long elapsed_ms_;
+};
+
+void PrintUsage()
+{
+  cout << "Usage: music-run -db <database file> [-db <database file> ...] "
+       << "[-j <numjobs>] [-t <timeout ms>] [-r <results file>] "
+       << "[-show-output] -- <program> [args ...]\n";
+}
+
+/**
+  Split a mutant filename (e.g. test.MUT12.c, or SSDL/0/test.MUT12.c with
+  MUSIC option -layout sharded) into the name of the source file it was
+  generated from (test.c) and its mutant id (12).
+
+  @return False if mutant_filename is not a MUSIC mutant filename
+*/
+bool ParseMutantFilename(const string &mutant_filename, MutantToRun &mutant)
+{
+  size_t mut_pos = mutant_filename.rfind(".MUT");
+
+  if (mut_pos == string::npos)
+    return false;
+
+  size_t id_start = mut_pos + 4;
+  size_t id_end = id_start;
+
+  while (id_end < mutant_filename.length() &&
+         isdigit(mutant_filename[id_end]))
+    id_end++;
+
+  if (id_end == id_start)
+    return false;
+
+  // Directories of the sharded layout are not part of the source name
+  // schema files register.
+  size_t name_start = mutant_filename.rfind('/', mut_pos);
+  name_start = name_start == string::npos ? 0 : name_start + 1;
+
+  mutant.mutant_filename_ = mutant_filename;
+  mutant.source_filename_ = mutant_filename.substr(
+      name_start, mut_pos - name_start) + mutant_filename.substr(id_end);
+  mutant.mutant_id_ = strtoull(mutant_filename.substr(
+      id_start, id_end - id_start).data(), nullptr, 10);
+  return true;
+}
+
+/**
+  Parse value of a numeric option. Only decimal digits are accepted, so
+  signs, trailing characters and empty values are rejected.
+
+  @return False if value is not a number no larger than max
+*/
+bool ParseNumber(const string &value, unsigned long max,
+                 unsigned long &number)
+{
+  if (value.empty() || value.find_first_not_of("0123456789") != string::npos)
+    return false;
+
+  errno = 0;
+  number = strtoul(value.data(), nullptr, 10);
+  return errno != ERANGE && number <= max;
+}
+
+bool HasExtension(const string &filename, const string &extension)
+{
+  return filename.length() >= extension.length() &&
+         filename.compare(filename.length() - extension.length(),
+                          extension.length(), extension) == 0;
+}
+
+// Read mutant filenames from a csv or indexed mutation database file.
+bool ReadMutantsFromDatabase(const string &db_filename,
+                             vector<MutantToRun> &mutants)
+{
+  vector<string> mutant_filenames;
+
+  if (HasExtension(db_filename, ".idx"))
+  {
+    IndexedMutantDatabase db;
+
+    if (!db.Open(db_filename))
+      return false;
+
+    for (uint32_t i = 0; i < db.getRecordCount(); i++)
+      mutant_filenames.push_back(db.getString(db.getRecord(i).mutant_filename_));
+  }
+  else
+  {
+    ifstream db_file(db_filename.data());
+
+    if (!db_file.is_open())
+      return false;
+
+    string line;
+    int line_num = 0;
+
+    while (getline(db_file, line))
+    {
+      // skip 2 header rows
+      if (++line_num <= 2 || line.empty())
+        continue;
+
+      mutant_filenames.push_back(line.substr(0, line.find(',')));
+    }
+  }
+
+  for (auto &mutant_filename: mutant_filenames)
+  {
+    MutantToRun mutant;
+
+    if (!ParseMutantFilename(mutant_filename, mutant))
+    {
+      cout << "Invalid mutant filename " << mutant_filename << " in " <<
+              db_filename << endl;
+      return false;
+    }
+
+    mutants.push_back(mutant);
+  }
+
+  return true;
+}
+
+/**
+  One instance of the program under test, started once, running mutants
+  through the fork server in runtime/music_runtime.c.
+*/
+class ForkServer
+{
+public:
+  ForkServer(const vector<string> &program_args, bool show_output)
+    : program_args_(program_args), show_output_(show_output), pid_(-1),
+      to_server_(nullptr), from_server_(nullptr)
+  {}
+
+  ~ForkServer()
+  {
+    Stop();
+  }
+
+  bool Start()
+  {
+    int command_pipe[2];
+    int result_pipe[2];
+
+    // Close-on-exec, so that servers started by other threads do not keep
+    // these pipes open.
+    if (pipe2(command_pipe, O_CLOEXEC) != 0)
+      return false;
+
+    if (pipe2(result_pipe, O_CLOEXEC) != 0)
+    {
+      close(command_pipe[0]);
+      close(command_pipe[1]);
+      return false;
+    }
+
+    vector<char *> argv;
+
+    for (auto &arg: program_args_)
+      argv.push_back(const_cast<char *>(arg.data()));
+
+    argv.push_back(nullptr);
+
+    pid_ = fork();
+
+    if (pid_ == 0)
+    {
+      // Only async-signal-safe calls until exec: other threads may hold
+      // locks in the parent.
+      dup2(command_pipe[0], MUSIC_FORK_SERVER_COMMAND_FD);
+      dup2(result_pipe[1], MUSIC_FORK_SERVER_RESULT_FD);
+
+      int null_fd = open("/dev/null", O_RDWR);
+      dup2(null_fd, STDIN_FILENO);
+
+      if (!show_output_)
+      {
+        dup2(null_fd, STDOUT_FILENO);
+        dup2(null_fd, STDERR_FILENO);
+      }
+
+      execvp(argv[0], argv.data());
+      _exit(127);
+    }
+
+    close(command_pipe[0]);
+    close(result_pipe[1]);
+
+    if (pid_ < 0)
+    {
+      close(command_pipe[1]);
+      close(result_pipe[0]);
+      return false;
+    }
+
+    to_server_ = fdopen(command_pipe[1], "w");
+    from_server_ = fdopen(result_pipe[0], "r");
+
+    char line[64];
+
+    return fgets(line, sizeof(line), from_server_) != nullptr &&
+           strcmp(line, "ready\n") == 0;
+  }
+
+  void Stop()
+  {
+    if (to_server_ != nullptr)
+      fclose(to_server_);
+
+    if (from_server_ != nullptr)
+      fclose(from_server_);
+
+    if (pid_ > 0)
+    {
+      kill(pid_, SIGKILL);
+      waitpid(pid_, nullptr, 0);
+    }
+
+    to_server_ = nullptr;
+    from_server_ = nullptr;
+    pid_ = -1;
+  }
+
+  // Return false if the fork server died.
+  bool Run(const MutantToRun &mutant, long timeout_ms,
+           MutantRunResult &result)
+  {
+    if (fprintf(to_server_, "%s %llu %ld\n", mutant.source_filename_.data(),
+                mutant.mutant_id_, timeout_ms) < 0 ||
+        fflush(to_server_) != 0)
+      return false;
+
+    char line[256];
+    char status[32];
+    unsigned long long mutant_id;
+
+    if (fgets(line, sizeof(line), from_server_) == nullptr ||
+        sscanf(line, "%llu %31s %d %ld", &mutant_id, status, &result.value_,
+               &result.elapsed_ms_) != 4 ||
+        mutant_id != mutant.mutant_id_)
+      return false;
+
+    result.status_ = status;
+    return true;
+  }
+
+private:
+  vector<string> program_args_;
+  bool show_output_;
+  pid_t pid_;
+  FILE *to_server_;
+  FILE *from_server_;
+};
+
+int main(int argc, const char *argv[])
+{
+  vector<string> db_filenames;
+  vector<string> program_args;
+  string results_filename = "music_run_results.csv";
+  unsigned int num_jobs = 1;
+  long timeout_ms = 0;
+  bool show_output = false;
+
+  for (int i = 1; i < argc; i++)
+  {
+    string arg{argv[i]};
+
+    if (arg == "--")
+    {
+      program_args.assign(argv + i + 1, argv + argc);
+      break;
+    }
+
+    if (arg == "-show-output")
+    {
+      show_output = true;
+      continue;
+    }
+
+    if (i + 1 == argc ||
+        (arg != "-db" && arg != "-j" && arg != "-t" && arg != "-r"))
+    {
+      PrintUsage();
+      exit(1);
+    }
+
+    string value{argv[++i]};
+
+    if (arg == "-db")
+      db_filenames.push_back(value);
+    else if (arg == "-r")
+      results_filename = value;
+    else if (arg == "-j")
+    {
+      unsigned long number;
+
+      if (!ParseNumber(value, UINT_MAX, number) || number == 0)
+      {
+        cout << "Invalid input for -j option, must be an positive integer smaller than 4294967296\n";
+        cout << "Usage: -j <numjobs>\n";
+        exit(1);
+      }
+
+      num_jobs = number;
+    }
+    else
+    {
+      unsigned long number;
+
+      if (!ParseNumber(value, LONG_MAX, number))
+      {
+        cout << "Invalid input for -t option, must be a non-negative integer (0 means no limit)\n";
+        cout << "Usage: -t <timeout ms>\n";
+        exit(1);
+      }
+
+      timeout_ms = number;
+    }
+  }
+
+  if (db_filenames.empty() || program_args.empty())
+  {
+    PrintUsage();
+    exit(1);
+  }
+
+  vector<MutantToRun> mutants;
+
+  for (auto &db_filename: db_filenames)
+    if (!ReadMutantsFromDatabase(db_filename, mutants))
+    {
+      cout << "Cannot read mutation database file: " << db_filename << endl;
+      exit(1);
+    }
+
+  // Inherited by every fork server, so that no environment has to be
+  // built between fork and exec.
+  setenv(MUSIC_FORK_SERVER_ENV, "1", 1);
+  signal(SIGPIPE, SIG_IGN);
+
+  vector<MutantRunResult> results(mutants.size());
+  atomic<size_t> next_mutant_idx{0};
+  atomic<bool> failed{false};
+
+  auto start_time = chrono::steady_clock::now();
+
+  auto worker = [&]()
+  {
+    ForkServer server(program_args, show_output);
+
+    if (!server.Start())
+    {
+      failed = true;
+      return;
+    }
+
+    for (size_t idx = next_mutant_idx++; idx < mutants.size();
+         idx = next_mutant_idx++)
+    {
+      if (server.Run(mutants[idx], timeout_ms, results[idx]))
+        continue;
+
+      // The server itself crashed (e.g. it was killed): report the mutant
+      // and continue with a fresh server.
+      results[idx] = MutantRunResult{"error", 0, 0};
+      server.Stop();
+
+      if (!server.Start())
+      {
+        failed = true;
+        return;
+      }
+    }
+  };
+
+  vector<thread> workers;
+
+  for (unsigned int i = 0; i < num_jobs && i < mutants.size(); i++)
+    workers.push_back(thread(worker));
+
+  for (auto &t: workers)
+    t.join();
+
+  if (failed)
+  {
+    cout << program_args[0] << " did not start a fork server. "
+         << "Is it linked with music_runtime.c and calling "
+         << "music_fork_server()?\n";
+    exit(1);
+  }
+
+  double elapsed_sec = chrono::duration<double>(
+      chrono::steady_clock::now() - start_time).count();
+
+  ofstream results_file(results_filename.data());
+
+  if (!results_file.is_open())
+  {
+    cout << "Cannot write " << results_filename << endl;
+    exit(1);
+  }
+
+  results_file << "Mutant Filename,Source File,Mutant Id,Status,Value,"
+               << "Time (ms)\n";
+
+  for (size_t i = 0; i < mutants.size(); i++)
+    results_file << mutants[i].mutant_filename_ << ","
+                 << mutants[i].source_filename_ << ","
+                 << mutants[i].mutant_id_ << "," << results[i].status_ << ","
+                 << results[i].value_ << "," << results[i].elapsed_ms_ << "\n";
+
+  results_file.close();
+
+  cout << "ran " << mutants.size() << " mutants in " << elapsed_sec << "s";
+
+  if (elapsed_sec > 0)
+    cout << " (" << mutants.size() / elapsed_sec << " mutants/s)";
+
+  cout << endl;
+  return 0;
+}
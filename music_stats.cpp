@@ -0,0 +1,277 @@
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <unordered_map>
+
+#include "mutant_database_sink.h"
+#include "music_stats.h"
+
+namespace {
+
+// Whole microseconds, for the JSON stats.
+long long ToMicroseconds(StatsClock::duration time)
+{
+  return std::chrono::duration_cast<std::chrono::microseconds>(time).count();
+}
+
+// Fractional microseconds, for trace events, in which small functions would
+// otherwise take no time.
+double ToTraceTime(StatsClock::duration time)
+{
+  return std::chrono::duration<double, std::micro>(time).count();
+}
+
+void WriteTraceEvent(std::ostream &out, const MusicStats::Interval &interval,
+                     const char *category, const std::string &filename,
+                     StatsClock::time_point origin, int tid,
+                     bool &first_event)
+{
+  out << (first_event ? "" : ",\n");
+  first_event = false;
+
+  out << "{\"name\":";
+  WriteJsonString(out, interval.name_);
+  out << ",\"cat\":\"" << category << "\",\"ph\":\"X\",\"ts\":"
+      << ToTraceTime(interval.start_ - origin) << ",\"dur\":"
+      << ToTraceTime(interval.end_ - interval.start_)
+      << ",\"pid\":1,\"tid\":" << tid << ",\"args\":{";
+
+  if (!filename.empty())
+  {
+    out << "\"file\":";
+    WriteJsonString(out, filename);
+  }
+
+  if (interval.line_ > 0)
+    out << (filename.empty() ? "" : ",") << "\"line\":" << interval.line_
+        << ",\"mutants\":" << interval.mutants_;
+
+  out << "}}";
+}
+
+}  // namespace
+
+MusicStats::MusicStats(const std::string &input_filename)
+  : input_filename_(input_filename), thread_id_(std::this_thread::get_id()),
+    in_phase_(false)
+{}
+
+const std::string& MusicStats::getInputFilename() const
+{
+  return input_filename_;
+}
+
+std::thread::id MusicStats::getThreadId() const
+{
+  return thread_id_;
+}
+
+void MusicStats::AddPhase(const std::string &name,
+                          StatsClock::time_point start,
+                          StatsClock::time_point end)
+{
+  phases_.push_back(Interval{name, 0, start, end, 0});
+}
+
+void MusicStats::BeginPhase(const std::string &name)
+{
+  StatsClock::time_point now = StatsClock::now();
+
+  if (in_phase_)
+    AddPhase(phase_name_, phase_start_, now);
+
+  in_phase_ = true;
+  phase_name_ = name;
+  phase_start_ = now;
+}
+
+void MusicStats::EndPhase()
+{
+  if (in_phase_)
+    AddPhase(phase_name_, phase_start_, StatsClock::now());
+
+  in_phase_ = false;
+}
+
+void MusicStats::AddIsMutationTarget(const std::string &operator_name,
+                                     StatsClock::duration time)
+{
+  OperatorStats &stats = operators_[operator_name];
+  stats.target_calls_++;
+  stats.target_time_ += time;
+}
+
+void MusicStats::AddMutate(const std::string &operator_name,
+                           StatsClock::duration time, uint64_t num_mutants)
+{
+  OperatorStats &stats = operators_[operator_name];
+  stats.mutate_calls_++;
+  stats.mutate_time_ += time;
+  stats.mutants_ += num_mutants;
+}
+
+void MusicStats::AddFunction(const std::string &name, int line,
+                             StatsClock::time_point start,
+                             StatsClock::time_point end,
+                             uint64_t num_mutants)
+{
+  functions_.push_back(Interval{name, line, start, end, num_mutants});
+}
+
+void MusicStats::WriteJson(std::ostream &out) const
+{
+  out << "{\"file\":";
+  WriteJsonString(out, input_filename_);
+  out << ",\"phases\":";
+  WritePhaseTimes(out);
+  out << ",\"operators\":{";
+
+  for (auto it = operators_.begin(); it != operators_.end(); ++it)
+  {
+    if (it != operators_.begin())
+      out << ",";
+
+    WriteJsonString(out, it->first);
+    out << ":{\"is_mutation_target_calls\":" << it->second.target_calls_
+        << ",\"is_mutation_target_us\":"
+        << ToMicroseconds(it->second.target_time_)
+        << ",\"mutate_calls\":" << it->second.mutate_calls_
+        << ",\"mutate_us\":" << ToMicroseconds(it->second.mutate_time_)
+        << ",\"mutants\":" << it->second.mutants_ << "}";
+  }
+
+  out << "},\"functions\":[";
+
+  for (size_t i = 0; i < functions_.size(); i++)
+  {
+    if (i > 0)
+      out << ",";
+
+    out << "{\"name\":";
+    WriteJsonString(out, functions_[i].name_);
+    out << ",\"line\":" << functions_[i].line_ << ",\"us\":"
+        << ToMicroseconds(functions_[i].end_ - functions_[i].start_)
+        << ",\"mutants\":" << functions_[i].mutants_ << "}";
+  }
+
+  out << "]}";
+}
+
+void MusicStats::WritePhaseTimes(std::ostream &out) const
+{
+  // Phases in the order they first ran.
+  std::vector<std::string> names;
+  std::map<std::string, StatsClock::duration> times;
+
+  for (auto &phase: phases_)
+  {
+    if (times.count(phase.name_) == 0)
+      names.push_back(phase.name_);
+
+    times[phase.name_] += phase.end_ - phase.start_;
+  }
+
+  out << "{";
+
+  for (size_t i = 0; i < names.size(); i++)
+  {
+    if (i > 0)
+      out << ",";
+
+    WriteJsonString(out, names[i]);
+    out << ":" << ToMicroseconds(times[names[i]]);
+  }
+
+  out << "}";
+}
+
+void MusicStats::WriteTraceEvents(std::ostream &out,
+                                  StatsClock::time_point origin, int tid,
+                                  bool &first_event) const
+{
+  for (auto &phase: phases_)
+    WriteTraceEvent(out, phase, "phase", input_filename_, origin, tid,
+                    first_event);
+
+  for (auto &function: functions_)
+    WriteTraceEvent(out, function, "function", input_filename_, origin, tid,
+                    first_event);
+}
+
+MusicStatsCollector::MusicStatsCollector(StatsClock::time_point origin)
+  : origin_(origin), run_stats_("")
+{}
+
+void MusicStatsCollector::AddPhase(const std::string &name,
+                                   StatsClock::time_point start,
+                                   StatsClock::time_point end)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  run_stats_.AddPhase(name, start, end);
+}
+
+void MusicStatsCollector::AddFile(const MusicStats &stats)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  files_.push_back(stats);
+}
+
+bool MusicStatsCollector::WriteJson(const std::string &filename) const
+{
+  std::ofstream out(filename.data());
+
+  if (!out.is_open())
+    return false;
+
+  // Files in name order, whatever order the workers finished them in.
+  std::vector<const MusicStats *> files;
+
+  for (auto &stats: files_)
+    files.push_back(&stats);
+
+  std::stable_sort(files.begin(), files.end(),
+                   [](const MusicStats *a, const MusicStats *b)
+                   { return a->getInputFilename() < b->getInputFilename(); });
+
+  out << "{\"phases\":";
+  run_stats_.WritePhaseTimes(out);
+  out << ",\"files\":[";
+
+  for (size_t i = 0; i < files.size(); i++)
+  {
+    out << (i > 0 ? ",\n" : "\n");
+    files[i]->WriteJson(out);
+  }
+
+  out << "]}\n";
+  return true;
+}
+
+bool MusicStatsCollector::WriteTrace(const std::string &filename) const
+{
+  std::ofstream out(filename.data());
+
+  if (!out.is_open())
+    return false;
+
+  out << std::fixed << std::setprecision(3);
+  out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+
+  bool first_event = true;
+  run_stats_.WriteTraceEvents(out, origin_, 0, first_event);
+
+  // Thread ids of trace are workers numbered from 1, in the order they
+  // finished their first file.
+  std::unordered_map<std::thread::id, int> tids;
+
+  for (auto &stats: files_)
+  {
+    auto tid = tids.insert(std::make_pair(stats.getThreadId(),
+                                          static_cast<int>(tids.size() + 1)));
+
+    stats.WriteTraceEvents(out, origin_, tid.first->second, first_event);
+  }
+
+  out << "\n]}\n";
+  return true;
+}
@@ -0,0 +1,132 @@
+#ifndef MUSIC_MUSIC_STATS_H_
+#define MUSIC_MUSIC_STATS_H_
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+typedef std::chrono::steady_clock StatsClock;
+
+/**
+  Where MUSIC spends its time on one input file (options -phase-stats and
+  -phase-stats-trace): wall time of each phase, time spent by each mutation
+  operator and time spent on each function definition.
+
+  Phases started with BeginPhase follow each other: starting a phase ends
+  the previous one.
+*/
+class MusicStats
+{
+public:
+  /**
+    @param  name_ name of phase or function
+            line_ start line of function, 0 for phases
+            mutants_ number of mutants generated for function
+  */
+  struct Interval
+  {
+    std::string name_;
+    int line_;
+    StatsClock::time_point start_;
+    StatsClock::time_point end_;
+    uint64_t mutants_;
+  };
+
+  /**
+    Cumulative cost of one mutation operator.
+
+    @param  target_calls_ target_time_ calls of IsMutationTarget
+            mutate_calls_ mutate_time_ calls of Mutate
+            mutants_ number of mutants generated by Mutate
+  */
+  struct OperatorStats
+  {
+    uint64_t target_calls_;
+    StatsClock::duration target_time_;
+    uint64_t mutate_calls_;
+    StatsClock::duration mutate_time_;
+    uint64_t mutants_;
+  };
+
+  explicit MusicStats(const std::string &input_filename);
+
+  const std::string& getInputFilename() const;
+  std::thread::id getThreadId() const;
+
+  void AddPhase(const std::string &name, StatsClock::time_point start,
+                StatsClock::time_point end);
+  void BeginPhase(const std::string &name);
+  void EndPhase();
+
+  void AddIsMutationTarget(const std::string &operator_name,
+                           StatsClock::duration time);
+  void AddMutate(const std::string &operator_name, StatsClock::duration time,
+                 uint64_t num_mutants);
+  void AddFunction(const std::string &name, int line,
+                   StatsClock::time_point start, StatsClock::time_point end,
+                   uint64_t num_mutants);
+
+  // {"file":...,"phases":{...},"operators":{...},"functions":[...]},
+  // times in microseconds.
+  void WriteJson(std::ostream &out) const;
+
+  // {"phase":time,...}, times of phases with the same name added up.
+  void WritePhaseTimes(std::ostream &out) const;
+
+  /**
+    Write phases and functions as Chrome trace events on thread tid, times
+    from origin. Events are separated by commas.
+
+    @param  first_event True if no event is written before, updated
+  */
+  void WriteTraceEvents(std::ostream &out, StatsClock::time_point origin,
+                        int tid, bool &first_event) const;
+
+private:
+  std::string input_filename_;
+  std::thread::id thread_id_;
+
+  std::vector<Interval> phases_;
+  bool in_phase_;
+  std::string phase_name_;
+  StatsClock::time_point phase_start_;
+
+  std::map<std::string, OperatorStats> operators_;
+  std::vector<Interval> functions_;
+};
+
+/**
+  Stats of all input files of a run, written once all files are done.
+  Files can be added from several threads.
+*/
+class MusicStatsCollector
+{
+public:
+  // Times in the trace are counted from origin.
+  explicit MusicStatsCollector(StatsClock::time_point origin);
+
+  // Record a phase of the whole run, such as loading the compilation
+  // database.
+  void AddPhase(const std::string &name, StatsClock::time_point start,
+                StatsClock::time_point end);
+  void AddFile(const MusicStats &stats);
+
+  // Return false if file cannot be opened. Only called once no file is
+  // added anymore.
+  bool WriteJson(const std::string &filename) const;
+  bool WriteTrace(const std::string &filename) const;
+
+private:
+  StatsClock::time_point origin_;
+  MusicStats run_stats_;
+
+  std::mutex mutex_;
+  std::vector<MusicStats> files_;
+};
+
+#endif  // MUSIC_MUSIC_STATS_H_
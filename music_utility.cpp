@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <iostream>
 
 #include "music_utility.h"
@@ -178,6 +179,25 @@ string ConvertCharStringToIntString(const string s)
   return s;
 }
 
+string GetNormalizedLiteralValue(Expr *e, const string &token)
+{
+  if (token.empty())
+    return token;
+
+  if (token.front() == '\'' && token.back() == '\'')
+    return ConvertCharStringToIntString(token);
+
+  IntegerLiteral *il = dyn_cast<IntegerLiteral>(e->IgnoreImpCasts());
+
+  // Decimal integers do not start with 0 (except 0 itself).
+  if (il == nullptr || token.length() < 2 || token.front() != '0')
+    return token;
+
+  size_t suffix_start = token.find_last_not_of("uUlL") + 1;
+
+  return il->getValue().toString(10, false) + token.substr(suffix_start);
+}
+
 bool IsStringElementOfVector(string s, vector<string> &string_vector)
 {
   auto it = string_vector.begin();
@@ -191,12 +211,7 @@ bool IsStringElementOfVector(string s, vector<string> &string_vector)
 
 bool IsStringElementOfSet(string s, set<string> &string_set)
 {
-  auto it = string_set.begin();
-
-  while (it != string_set.end() && (*it).compare(s) != 0)
-    ++it;
-
-  return it != string_set.end();
+  return string_set.find(s) != string_set.end();
 }
 
 bool ConvertStringToInt(string s, int &n)
@@ -716,6 +731,44 @@ bool Range1IsPartOfRange2(SourceRange range1, SourceRange range2)
          LocationIsInRange(range1.getEnd(), range2);
 }
 
+bool DeclIsOutsideMutationRange(SourceManager &src_mgr, Decl *d,
+                                Configuration *config)
+{
+  SourceLocation start_loc = src_mgr.getExpansionLoc(d->getLocStart());
+  SourceLocation end_loc = src_mgr.getExpansionLoc(d->getLocEnd());
+  FileID main_file_id = src_mgr.getMainFileID();
+
+  if (src_mgr.getFileID(start_loc) != main_file_id &&
+      src_mgr.getFileID(end_loc) != main_file_id)
+    return true;
+
+  // Declarations opened in one file and closed in another are traversed.
+  if (src_mgr.getFileID(start_loc) != main_file_id ||
+      src_mgr.getFileID(end_loc) != main_file_id)
+    return false;
+
+  SourceRange mutation_range(*(config->getStartOfMutationRange()),
+                             *(config->getEndOfMutationRange()));
+
+  if (LocationBeforeRangeStart(end_loc, mutation_range) ||
+      LocationAfterRangeEnd(start_loc, mutation_range))
+    return true;
+
+  vector<int> &excluded_lines = config->getExcludedLines();
+  int start_line = GetLineNumber(src_mgr, start_loc);
+  int end_line = GetLineNumber(src_mgr, end_loc);
+
+  if (end_line - start_line + 1 > static_cast<int>(excluded_lines.size()))
+    return false;
+
+  for (int line = start_line; line <= end_line; line++)
+    if (std::find(excluded_lines.begin(), excluded_lines.end(), line) ==
+        excluded_lines.end())
+      return false;
+
+  return true;
+}
+
 int CountNonNullStmtInCompoundStmt(CompoundStmt *c)
 {
   int res{0};
@@ -1538,34 +1591,40 @@ Expr* GetRightOperandAfterMutation(
   return rhs;
 }
 
-ostream& operator<<(ostream &stream, const MutantEntry &entry)
+ostream& operator<<(ostream &stream, MutantDatabase &database)
 {
-  stream << "============ entry =============" << endl;
-  stream << "proteum line num: " << entry.getProteumStyleLineNum() << endl;
-  stream << "start location: "; PrintLocation(entry.src_mgr_, entry.getStartLocation());
-  stream << "end location: "; PrintLocation(entry.src_mgr_, entry.getTokenEndLocation());
-  stream << "token: " << entry.getToken() << endl;
-  stream << "mutated token: " << entry.getMutatedToken() << endl;
-  stream << "================================";
+  const MutantEntryTable &table = database.getEntryTable();
+  const MutantEntry *prev = nullptr;
+  int prev_line_num = 0;
 
-  return stream;
-}
-
-ostream& operator<<(ostream &stream, const MutantDatabase &database)
-{
-  for (auto line_map_iter: database.getEntryTable())
+  for (auto idx: database.getSortedEntryOrder())
   {
-    cout << "LINE " << line_map_iter.first << endl;
-    for (auto column_map_iter: line_map_iter.second)
-    {
-      cout << "\tCOL " << column_map_iter.first << endl;
-      for (auto mutantname_map_iter: column_map_iter.second)
-      {
-        cout << "\t\t" << mutantname_map_iter.first << endl;
-        for (auto entry: mutantname_map_iter.second)
-          cout << entry << endl;
-      }
-    }
+    const MutantEntry &entry = table[idx];
+    int line_num, col_num, end_line_num, end_col_num;
+
+    database.GetLineColumn(entry.start_offset_, line_num, col_num);
+    database.GetLineColumn(entry.end_offset_, end_line_num, end_col_num);
+
+    if (prev == nullptr || prev_line_num != line_num)
+      cout << "LINE " << line_num << endl;
+
+    if (prev == nullptr || prev->start_offset_ != entry.start_offset_)
+      cout << "\tCOL " << col_num << endl;
+
+    if (prev == nullptr || prev->start_offset_ != entry.start_offset_ ||
+        prev->operator_id_ != entry.operator_id_)
+      cout << "\t\t" << database.getOperatorName(entry) << endl;
+
+    cout << "============ entry =============" << endl;
+    cout << "proteum line num: " << entry.proteum_style_line_num_ << endl;
+    cout << "start location: " << line_num << ":" << col_num << endl;
+    cout << "end location: " << end_line_num << ":" << end_col_num << endl;
+    cout << "token: " << database.getToken(entry) << endl;
+    cout << "mutated token: " << database.getMutatedToken(entry) << endl;
+    cout << "================================" << endl;
+
+    prev = &entry;
+    prev_line_num = line_num;
   }
 
   return stream;
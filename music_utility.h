@@ -71,6 +71,14 @@ string ConvertHexaStringToIntString(const string hexa_str);
 
 string ConvertCharStringToIntString(const string s);
 
+/**
+  Return the value of scalar literal e with source text token, written so
+  that equal values give equal strings: char literals as their int value,
+  integer literals in hexadecimal, octal or binary as decimal (suffix
+  kept). Other literals are returned as written.
+*/
+string GetNormalizedLiteralValue(Expr *e, const string &token);
+
 bool IsStringElementOfVector(string s, vector<string> &string_vector);
 
 bool IsStringElementOfSet(string s, set<string> &set);
@@ -156,6 +164,15 @@ bool LocationIsInRange(SourceLocation loc, SourceRange range);
 
 bool Range1IsPartOfRange2(SourceRange range1, SourceRange range2);
 
+/**
+  Return True if no expression or statement of decl d can be mutated, so
+  traversal can skip d: d is not expanded in the main file, or it ends
+  before the mutation range of config starts, starts after it ends, or lies
+  on excluded lines only.
+*/
+bool DeclIsOutsideMutationRange(SourceManager &src_mgr, Decl *d,
+                                Configuration *config);
+
 int CountNonNullStmtInCompoundStmt(CompoundStmt *c);
 
 SourceLocation GetLocationAfterSemicolon(SourceManager &src_mgr_, 
@@ -248,8 +265,7 @@ Expr* GetLeftOperandAfterMutation(
 Expr* GetRightOperandAfterMutation(
     Expr *rhs, const BinaryOperator::Opcode mutated_opcode);
 
-ostream& operator<<(ostream &stream, const MutantEntry &entry);
-ostream& operator<<(ostream &stream, const MutantDatabase &database);
+ostream& operator<<(ostream &stream, MutantDatabase &database);
 
 Expr* IgnoreParenExpr(Expr *e);
 
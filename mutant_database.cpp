@@ -1,197 +1,819 @@
-#include <time.h>
 #include <algorithm>
-
-#include "clang/Rewrite/Core/Rewriter.h"
+#include <mutex>
 
 #include "music_utility.h"
 #include "mutant_database.h"
 
-void GenerateRandomNumbers(set<int> &s, int desired_size, int cap)
+namespace {
+
+// Mutant files are written by this many threads, while at most
+// kMaxPendingMutantFiles wait to be written.
+const unsigned kMutantFileWriterThreads = 4;
+const size_t kMaxPendingMutantFiles = 256;
+
+// With -layout sharded, a directory holds mutants of one mutation operator
+// whose ids are the same when divided by kMutantsPerShard. Stable ids are
+// spread over 64 bits, so they are divided by kStableIdsPerShard instead.
+const uint64_t kMutantsPerShard = 1000;
+const uint64_t kStableIdsPerShard = uint64_t(1) << 54;
+
+}  // namespace
+
+bool MutantEntryKey::operator==(const MutantEntryKey &rhs) const
 {
-  while (s.size() != desired_size)
-    s.insert(rand() % cap);
+  return start_offset_ == rhs.start_offset_ && 
+         operator_id_ == rhs.operator_id_ && token_id_ == rhs.token_id_ &&
+         mutated_token_id_ == rhs.mutated_token_id_;
+}
+
+size_t MutantEntryKeyHash::operator()(const MutantEntryKey &key) const
+{
+  size_t seed = std::hash<uint32_t>()(key.start_offset_);
+
+  auto combine = [&seed](size_t value)
+  {
+    seed ^= value + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+  };
+
+  combine(std::hash<uint16_t>()(key.operator_id_));
+  combine(std::hash<uint32_t>()(key.token_id_));
+  combine(std::hash<uint32_t>()(key.mutated_token_id_));
+  return seed;
 }
 
 MutantDatabase::MutantDatabase(clang::CompilerInstance *comp_inst, 
-               std::string input_filename, std::string output_dir, int limit)
-: comp_inst_(comp_inst), input_filename_(input_filename),
-output_dir_(output_dir), next_mutantfile_id_(1), num_mutant_limit_(limit),
+                               Configuration *config)
+: comp_inst_(comp_inst), config_(config),
+input_filename_(config->getInputFilename()),
+output_dir_(config->getOutputDir()), next_mutantfile_id_(1),
+num_generated_entries_(0), file_scope_hash_(0),
+sampler_(static_cast<uint32_t>(config->getLimitNumOfMutants()),
+         config->getMutantBudget()),
 src_mgr_(comp_inst->getSourceManager()), lang_opts_(comp_inst->getLangOpts())
 {
-  // set database filename with output directory prepended
-  database_filename_ = output_dir;
-  database_filename_.append(input_filename_, 0, input_filename_.length()-2);
-  database_filename_ += "_mut_db.csv";
+  // set database path with output directory prepended.
+  // Each sink appends its own extension.
+  database_path_prefix_ = output_dir_;
+  database_path_prefix_.append(input_filename_, 0, input_filename_.length()-2);
+  database_path_prefix_ += "_mut_db";
+
+  // patch file is named <inputfilename>_mut.patch
+  patch_filename_ = output_dir_;
+  patch_filename_.append(input_filename_, 0, input_filename_.length()-2);
+  patch_filename_ += "_mut.patch";
+
+  // schema file is named <inputfilename>.SCHEMA.c
+  schema_filename_ = output_dir_;
+  schema_filename_.append(input_filename_, 0, input_filename_.length()-2);
+  schema_filename_ += ".SCHEMA.c";
+
+  // pack file is named <inputfilename>_mut.pack
+  pack_filename_ = output_dir_;
+  pack_filename_.append(input_filename_, 0, input_filename_.length()-2);
+  pack_filename_ += "_mut.pack";
+
+  // function cache is named <inputfilename>_mut_db.fcache
+  if (config_->getIncremental())
+  {
+    function_cache_filename_ = database_path_prefix_ + ".fcache";
+
+    if (ReadFunctionCache(function_cache_filename_, previous_function_cache_))
+    {
+      next_mutantfile_id_ = previous_function_cache_.next_mutant_id_;
+
+      // Mutants of the previous run were selected by other options.
+      if (previous_function_cache_.options_hash_ != 
+          config_->getMutationOptionsHash())
+      {
+        cout << "Function cache " << function_cache_filename_ << 
+                " was written with other options, not reused\n";
+        previous_function_cache_.functions_.clear();
+      }
+
+      for (size_t i = 0; i < previous_function_cache_.functions_.size(); i++)
+        previous_function_index_[
+            previous_function_cache_.functions_[i].key_] = i;
+    }
+    else
+      previous_function_cache_.functions_.clear();
+  }
 }
 
 void MutantDatabase::AddMutantEntry(MutantName name, clang::SourceLocation start_loc,
                     clang::SourceLocation end_loc, std::string token,
                     std::string mutated_token, int proteum_style_line_num)
 {
-  int line_num = GetLineNumber(src_mgr_, start_loc);
-  int col_num = GetColumnNumber(src_mgr_, start_loc);
-  MutantEntry new_entry(token, mutated_token, start_loc, 
-                        end_loc, src_mgr_, proteum_style_line_num);
+  // Mutants of functions reused from the previous run are already in
+  // the table.
+  if (!IsInMutatedCode(start_loc))
+    return;
+
+  start_loc = src_mgr_.getExpansionLoc(start_loc);
+  end_loc = src_mgr_.getExpansionLoc(end_loc);
+
+  // Mutants are edits of the main file.
+  if (src_mgr_.getFileID(start_loc) != src_mgr_.getMainFileID() ||
+      src_mgr_.getFileID(end_loc) != src_mgr_.getMainFileID())
+    return;
 
-  auto line_map_iter = mutant_entry_table_.find(line_num);
+  MutantEntry entry;
+  entry.start_offset_ = src_mgr_.getFileOffset(start_loc);
+  entry.end_offset_ = src_mgr_.getFileOffset(end_loc);
+  entry.token_id_ = token_pool_.Intern(token);
+  entry.mutated_token_id_ = token_pool_.Intern(mutated_token);
+  entry.proteum_style_line_num_ = proteum_style_line_num;
+  entry.operator_id_ = GetOperatorId(name);
 
-  // if this is the first mutant on this line to be recorded,
-  // add new entries all the way down 3 levels.
-  if (line_map_iter == mutant_entry_table_.end())
+  // Skip if another mutant at this mutation point already makes the same
+  // replacement.
+  MutantEntryKey key{entry.start_offset_, entry.operator_id_, 
+                     entry.token_id_, entry.mutated_token_id_};
+
+  if (!mutant_entry_keys_.insert(key).second)
+    return;
+
+  num_generated_entries_++;
+
+  // Entries that can never be selected by -l or -budget are not kept.
+  if (sampler_.IsSampling())
   {
-    mutant_entry_table_[line_num] = ColumnNumToEntryMap();
-    mutant_entry_table_[line_num][col_num] = MutantNameToEntryMap();
-    mutant_entry_table_[line_num][col_num][name] = MutantEntryList();
-    mutant_entry_table_[line_num][col_num][name].push_back(new_entry);
+    MutantSampler::Candidate candidate;
+    candidate.key_ = GetSampleKey(config_->getSampleSeed(),
+                                  entry.start_offset_, name, token,
+                                  mutated_token);
+    candidate.point_ = (static_cast<uint64_t>(entry.start_offset_) << 16) |
+                       entry.operator_id_;
+
+    if (!sampler_.Offer(candidate.key_, candidate.point_))
+      return;
+
+    candidate.stratum_ = GetSampleStratum(entry, start_loc);
+    sample_candidates_.push_back(candidate);
   }
-  // if this is not the first mutant on this line, check if it is the first
-  // on this column
-  else
+
+  mutant_entry_table_.push_back(entry);
+
+  if (sampler_.ShouldSelect(mutant_entry_table_.size() - 
+                            cached_mutant_ids_.size()))
+    SelectSampledEntries();
+}
+
+uint64_t MutantDatabase::GetSampleStratum(const MutantEntry &entry,
+                                          SourceLocation start_loc)
+{
+  // Operator id in bits 0-15, function in bits 16-39 (0 outside of
+  // function definitions), line in bits 40-63.
+  uint64_t stratum = 0;
+
+  if (config_->getStratifyByOperator())
+    stratum |= entry.operator_id_;
+
+  if (config_->getStratifyByFunction())
   {
-    auto column_map_iter = mutant_entry_table_[line_num].find(col_num);
+    FunctionCacheItem *function = FindFunction(entry.start_offset_);
+
+    if (function != nullptr)
+      stratum |= (static_cast<uint64_t>(function - functions_.data() + 1) &
+                  0xffffff) << 16;
+  }
 
-    // Similar for column
-    if (column_map_iter == mutant_entry_table_[line_num].end())
+  if (config_->getStratifyByLine())
+    stratum |= (static_cast<uint64_t>(GetLineNumber(src_mgr_, start_loc)) &
+                0xffffff) << 40;
+
+  return stratum;
+}
+
+void MutantDatabase::SelectSampledEntries()
+{
+  vector<MutantSampler::Candidate> candidates;
+  vector<size_t> positions;
+
+  for (size_t i = 0; i < mutant_entry_table_.size(); i++)
+    if (cached_mutant_ids_.count(i) == 0)
     {
-      mutant_entry_table_[line_num][col_num] = MutantNameToEntryMap();
-      mutant_entry_table_[line_num][col_num][name] = MutantEntryList();
-      mutant_entry_table_[line_num][col_num][name].push_back(new_entry);
+      candidates.push_back(sample_candidates_[i]);
+      positions.push_back(i);
     }
-    else
-    {
-      auto mutantname_map_iter = \
-          mutant_entry_table_[line_num][col_num].find(name);
 
-      // Similar for mutant name
-      if (mutantname_map_iter == mutant_entry_table_[line_num][col_num].end())
-      {
-        mutant_entry_table_[line_num][col_num][name] = MutantEntryList();
-        mutant_entry_table_[line_num][col_num][name].push_back(new_entry);
-      }
-      else
-      {
-        // Check if there is already another mutant with the same replacement inside.
-        // If yes, then skip. Otherwise push new entry in.
-
-        // All these entries will have the same line and column number and
-        // mutant name, so if they make the same replacement then they are
-        // duplicated.
-        for (auto entry: mutant_entry_table_[line_num][col_num][name])
-        {
-          if (new_entry == entry)
-            return;
-        }
-
-        mutant_entry_table_[line_num][col_num][name].push_back(new_entry);
-      }
+  vector<bool> selected;
+  sampler_.Select(candidates, selected);
+
+  vector<bool> kept(mutant_entry_table_.size(), true);
+
+  for (size_t i = 0; i < positions.size(); i++)
+    kept[positions[i]] = selected[i];
+
+  unordered_map<size_t, uint64_t> cached_mutant_ids;
+  size_t num_kept = 0;
+
+  for (size_t i = 0; i < mutant_entry_table_.size(); i++)
+  {
+    if (!kept[i])
+      continue;
+
+    auto cached_id = cached_mutant_ids_.find(i);
+
+    if (cached_id != cached_mutant_ids_.end())
+      cached_mutant_ids[num_kept] = cached_id->second;
+
+    mutant_entry_table_[num_kept] = mutant_entry_table_[i];
+    sample_candidates_[num_kept] = sample_candidates_[i];
+    num_kept++;
+  }
+
+  mutant_entry_table_.resize(num_kept);
+  sample_candidates_.resize(num_kept);
+  cached_mutant_ids_.swap(cached_mutant_ids);
+}
+
+uint16_t MutantDatabase::GetOperatorId(const MutantName &name)
+{
+  auto inserted = operator_ids_.insert(make_pair(
+      name, static_cast<uint16_t>(operator_names_.size())));
+
+  if (inserted.second)
+    operator_names_.push_back(name);
+
+  return inserted.first->second;
+}
+
+void MutantDatabase::AddFunction(const string &key, SourceLocation start_loc,
+                                 SourceLocation end_loc)
+{
+  if (!config_->getIncremental() && !config_->getStratifyByFunction() &&
+      !config_->getCountOnly() && !config_->getStableIds())
+    return;
+
+  start_loc = src_mgr_.getExpansionLoc(start_loc);
+  end_loc = src_mgr_.getExpansionLoc(end_loc);
+
+  if (src_mgr_.getFileID(start_loc) != src_mgr_.getMainFileID() ||
+      src_mgr_.getFileID(end_loc) != src_mgr_.getMainFileID())
+    return;
+
+  FunctionCacheItem function;
+  function.start_offset_ = src_mgr_.getFileOffset(start_loc);
+  function.end_offset_ = src_mgr_.getFileOffset(end_loc) + 1;
+  function.start_line_ = GetLineNumber(src_mgr_, start_loc);
+
+  StringRef main_file_content = src_mgr_.getBufferData(
+      src_mgr_.getMainFileID());
+
+  // Definitions are recorded in order and never nest.
+  if (function.end_offset_ > main_file_content.size() ||
+      (!functions_.empty() && 
+       function.start_offset_ < functions_.back().end_offset_))
+    return;
+
+  function.cached_function_.key_ = key;
+  function.cached_function_.hash_ = HashFileContent(main_file_content.substr(
+      function.start_offset_, 
+      function.end_offset_ - function.start_offset_).str());
+
+  auto cached = previous_function_index_.find(key);
+  const CachedFunction *cached_function = nullptr;
+
+  if (cached != previous_function_index_.end() &&
+      previous_function_cache_.functions_[cached->second].hash_ == \
+      function.cached_function_.hash_)
+    cached_function = &previous_function_cache_.functions_[cached->second];
+
+  function.reused_ = cached_function != nullptr;
+  function.mutated_ = 
+      !function.reused_ && 
+      (!config_->getUseChangedLines() ||
+       LinesOverlapRanges(config_->getChangedLines(), function.start_line_,
+                          GetLineNumber(src_mgr_, end_loc)));
+
+  functions_.push_back(function);
+
+  if (cached_function != nullptr)
+    AddCachedMutants(functions_.back(), *cached_function);
+}
+
+void MutantDatabase::CheckFileScopeOfFunctionCache(TranslationUnitDecl *tu)
+{
+  if (!config_->getIncremental())
+    return;
+
+  StringRef main_file_content = src_mgr_.getBufferData(
+      src_mgr_.getMainFileID());
+  string file_scope;
+  unsigned pos = 0;
+
+  // Same ranges as AddFunction records.
+  for (auto d: tu->decls())
+  {
+    FunctionDecl *f = dyn_cast<FunctionDecl>(d);
+
+    if (f == nullptr || !f->doesThisDeclarationHaveABody())
+      continue;
+
+    SourceLocation start_loc = src_mgr_.getExpansionLoc(f->getLocStart());
+    SourceLocation end_loc = src_mgr_.getExpansionLoc(f->getLocEnd());
+
+    if (src_mgr_.getFileID(start_loc) != src_mgr_.getMainFileID() ||
+        src_mgr_.getFileID(end_loc) != src_mgr_.getMainFileID())
+      continue;
+
+    unsigned start_offset = src_mgr_.getFileOffset(start_loc);
+    unsigned end_offset = src_mgr_.getFileOffset(end_loc) + 1;
+
+    if (start_offset < pos || end_offset > main_file_content.size())
+      continue;
+
+    file_scope += main_file_content.substr(pos, start_offset - pos).str();
+    pos = end_offset;
+  }
+
+  file_scope += main_file_content.substr(pos).str();
+  file_scope_hash_ = HashFileContent(file_scope);
+
+  // Globals and constants offered as replacements may have changed.
+  if (!previous_function_cache_.functions_.empty() &&
+      previous_function_cache_.file_scope_hash_ != file_scope_hash_)
+  {
+    cout << "Code outside of functions changed since function cache " << 
+            function_cache_filename_ << " was written, not reused\n";
+    previous_function_cache_.functions_.clear();
+    previous_function_index_.clear();
+  }
+}
+
+void MutantDatabase::AddCachedMutants(const FunctionCacheItem &function,
+                                      const CachedFunction &cached_function)
+{
+  for (auto &mutant: cached_function.mutants_)
+  {
+    MutantEntry entry;
+    entry.start_offset_ = function.start_offset_ + mutant.offset_;
+    entry.end_offset_ = entry.start_offset_ + mutant.length_;
+    entry.token_id_ = token_pool_.Intern(mutant.token_);
+    entry.mutated_token_id_ = token_pool_.Intern(mutant.mutated_token_);
+    entry.proteum_style_line_num_ = 
+        function.start_line_ + mutant.proteum_line_delta_;
+    entry.operator_id_ = GetOperatorId(mutant.operator_name_);
+
+    cached_mutant_ids_[mutant_entry_table_.size()] = mutant.mutant_id_;
+    mutant_entry_table_.push_back(entry);
+
+    if (sampler_.IsSampling())
+      sample_candidates_.push_back(MutantSampler::Candidate{0, 0, 0});
+  }
+}
+
+FunctionCacheItem* MutantDatabase::FindFunction(unsigned offset)
+{
+  // First function starting after offset.
+  auto it = upper_bound(functions_.begin(), functions_.end(), offset,
+                        [](unsigned value, const FunctionCacheItem &function)
+                        { return value < function.start_offset_; });
+
+  if (it == functions_.begin() || offset >= (it - 1)->end_offset_)
+    return nullptr;
+
+  return &*(it - 1);
+}
+
+bool MutantDatabase::IsInMutatedCode(SourceLocation loc)
+{
+  if (!config_->getIncremental())
+    return true;
+
+  loc = src_mgr_.getExpansionLoc(loc);
+
+  if (src_mgr_.getFileID(loc) != src_mgr_.getMainFileID())
+    return true;
+
+  FunctionCacheItem *function = FindFunction(src_mgr_.getFileOffset(loc));
+
+  if (function != nullptr)
+    return function->mutated_;
+
+  // Outside of function definitions, only changed lines are mutated.
+  if (!config_->getUseChangedLines())
+    return true;
+
+  int line_num = GetLineNumber(src_mgr_, loc);
+  return LinesOverlapRanges(config_->getChangedLines(), line_num, line_num);
+}
+
+void MutantDatabase::AddSink(MutantDatabaseSink *sink)
+{
+  sinks_.push_back(unique_ptr<MutantDatabaseSink>(sink));
+}
+
+void MutantDatabase::AddSchemaRegion(
+    SchemaRegionKind kind, SourceLocation start_loc, SourceLocation end_loc)
+{
+  start_loc = src_mgr_.getExpansionLoc(start_loc);
+  end_loc = src_mgr_.getExpansionLoc(end_loc);
+
+  if (src_mgr_.getFileID(start_loc) != src_mgr_.getMainFileID() ||
+      src_mgr_.getFileID(end_loc) != src_mgr_.getMainFileID())
+    return;
+
+  schema_regions_.push_back(SchemaRegion{
+      kind, src_mgr_.getFileOffset(start_loc), 
+      src_mgr_.getFileOffset(end_loc)});
+}
+
+void MutantDatabase::AddSchemaBarrier(SourceLocation loc, SourceRange scope)
+{
+  loc = src_mgr_.getExpansionLoc(loc);
+
+  if (src_mgr_.getFileID(loc) != src_mgr_.getMainFileID())
+    return;
+
+  unsigned file_size = src_mgr_.getBufferData(src_mgr_.getMainFileID()).size();
+  SchemaBarrier barrier{src_mgr_.getFileOffset(loc), 0, file_size};
+
+  if (scope.isValid())
+  {
+    SourceLocation start_loc = src_mgr_.getExpansionLoc(scope.getBegin());
+    SourceLocation end_loc = src_mgr_.getExpansionLoc(scope.getEnd());
+
+    if (src_mgr_.getFileID(start_loc) == src_mgr_.getMainFileID() &&
+        src_mgr_.getFileID(end_loc) == src_mgr_.getMainFileID())
+    {
+      barrier.scope_start_ = src_mgr_.getFileOffset(start_loc);
+      barrier.scope_end_ = src_mgr_.getFileOffset(end_loc) + 1;
     }
   }
+
+  schema_barriers_.push_back(barrier);
 }
 
-void MutantDatabase::WriteEntryToDatabaseFile(
-    string mutant_name, const MutantEntry &entry)
+bool MutantDatabase::OpenSinks()
 {
-  // cout << "making " << mutant_name << " mutant\n" << entry << endl;
+  for (auto &sink: sinks_)
+    if (!sink->IsOpen())
+    {
+      cout << "Failed to open database sink\n";
+      CloseSinks();
+      return false;
+    }
 
-  // Open mutattion database file in APPEND mode
-  ofstream mutant_db_file(database_filename_.data(), ios::app);
+  for (auto format: config_->getDatabaseFormats())
+  {
+    MutantDatabaseSink *sink = CreateMutantDatabaseSink(
+        format, database_path_prefix_);
 
-  // write input file name
-  // mutant_db_file << input_filename_ << ",";
+    if (sink == nullptr || !sink->IsOpen())
+    {
+      cout << "Failed to open " << format << " database for " << 
+              input_filename_ << endl;
+      delete sink;
+      CloseSinks();
+      return false;
+    }
 
-  // write mutant file name
-  mutant_db_file << GetNextMutantFilename() << ","; 
+    sinks_.push_back(unique_ptr<MutantDatabaseSink>(sink));
+  }
 
-  // write name of operator  
-  mutant_db_file << mutant_name << ",";
+  return true;
+}
+
+void MutantDatabase::CloseSinks()
+{
+  for (auto &sink: sinks_)
+    sink->Close();
+
+  sinks_.clear();
+}
 
-  // write information about token BEFORE mutation
-  mutant_db_file << entry.getProteumStyleLineNum() << ",";
-  mutant_db_file << GetLineNumber(src_mgr_, entry.getStartLocation()) << ",";
-  mutant_db_file << GetColumnNumber(src_mgr_, entry.getStartLocation()) << ",";
-  mutant_db_file << GetLineNumber(src_mgr_, entry.getTokenEndLocation()) << ",";
-  mutant_db_file << GetColumnNumber(src_mgr_, entry.getTokenEndLocation()) << ",";
-  mutant_db_file << entry.getToken() << ",";
+void MutantDatabase::WriteEntryToDatabaseFile(const MutantEntry &entry)
+{
+  MutantRecord record;
+  record.mutant_id_ = next_mutantfile_id_;
+  record.mutant_filename_ = GetNextMutantFilename(entry);
+  record.operator_name_ = getOperatorName(entry);
+
+  // information about token BEFORE mutation
+  record.proteum_line_num_ = entry.proteum_style_line_num_;
+  line_table_.GetLineColumn(entry.start_offset_, record.start_line_, 
+                            record.start_col_);
+  line_table_.GetLineColumn(entry.end_offset_, record.end_line_, 
+                            record.end_col_);
+  record.token_ = getToken(entry);
 
-  // write information about token AFTER mutation
-  mutant_db_file << GetLineNumber(src_mgr_, entry.getStartLocation()) << ",";
-  mutant_db_file << GetColumnNumber(src_mgr_, entry.getStartLocation()) << ",";
-  mutant_db_file << GetLineNumber(src_mgr_, entry.getMutatedTokenEndLocation()) << ",";
-  mutant_db_file << GetColumnNumber(src_mgr_, entry.getMutatedTokenEndLocation()) << ",";
-  mutant_db_file << entry.getMutatedToken() << endl;
+  // information about token AFTER mutation.
+  // Its end is counted on the start line, without newlines of the mutated
+  // token, and stops at the end of that line.
+  record.mutated_token_ = getMutatedToken(entry);
+  record.mutated_end_line_ = record.start_line_;
+  record.mutated_end_col_ = line_table_.ClampColumn(
+      record.start_line_, 
+      record.start_col_ + CountNonNewlineChar(record.mutated_token_));
 
-  // close database file
-  mutant_db_file.close(); 
+  for (auto &sink: sinks_)
+    sink->WriteRecord(record);
 }
 
 void MutantDatabase::WriteAllEntriesToDatabaseFile()
 {
   long count = 0;
 
-  for (auto line_map_iter: mutant_entry_table_)
-    for (auto column_map_iter: line_map_iter.second)
-      for (auto mutantname_map_iter: column_map_iter.second)
-        for (auto entry: mutantname_map_iter.second)
-        {
-          count++;
-          WriteEntryToDatabaseFile(mutantname_map_iter.first, entry);
-          IncrementNextMutantfileId();
-        }
+  if (sampler_.IsSampling())
+    SelectSampledEntries();
+
+  if (!OpenSinks())
+    return;
+
+  LoadMainFile();
+
+  for (auto idx: getSortedEntryOrder())
+  {
+    count++;
+    WriteEntryToDatabaseFile(mutant_entry_table_[idx]);
+    IncrementNextMutantfileId();
+  }
+
+  CloseSinks();
 
   cout << "wrote " << count << " mutants to db file\n";
 }
 
 void MutantDatabase::WriteEntryToMutantFile(const MutantEntry &entry)
 {
-  Rewriter rewriter;
-  rewriter.setSourceMgr(src_mgr_, lang_opts_);
+  WriteMutantFile(next_mutantfile_id_, GetNextMutantFilename(entry),
+                  entry.start_offset_, entry.end_offset_,
+                  getMutatedToken(entry));
+}
 
-  SourceLocation start_loc = src_mgr_.getExpansionLoc(entry.getStartLocation());
-  SourceLocation end_loc = src_mgr_.getExpansionLoc(entry.getTokenEndLocation());
+void MutantDatabase::WriteMutantFile(uint64_t mutant_id,
+                                     const string &mutant_filename,
+                                     uint32_t start_offset,
+                                     uint32_t end_offset,
+                                     const string &replacement)
+{
+  // Mutated code is the main file with the token replaced.
+  if (config_->getPackOutput())
+  {
+    if (!pack_writer_)
+    {
+      pack_writer_.reset(new PackFileWriter(pack_filename_,
+                                            config_->getPackCompressed()));
 
-  int length = src_mgr_.getFileOffset(end_loc) - \
-               src_mgr_.getFileOffset(start_loc);
+      if (!pack_writer_->IsOpen())
+        cout << "Failed to open file : " << pack_filename_ << endl;
+    }
 
-  // cout << "length = " << length << endl;
-  
-  rewriter.ReplaceText(start_loc, length, entry.getMutatedToken());
+    string mutant;
+    mutant.reserve(main_file_content_.size() + replacement.size());
+    mutant.append(main_file_content_.data(), start_offset);
+    mutant += replacement;
+    mutant.append(main_file_content_.data() + end_offset,
+                  main_file_content_.size() - end_offset);
 
-  // cout << rewriter.getRewrittenText(SourceRange(entry.getStartLocation(), entry.getTokenEndLocation())) << endl;
-  // cout << entry.getStartLocation().printToString(src_mgr_) << endl;
+    // Failures are reported once, by FinishMutantFiles.
+    pack_writer_->AddMember(mutant_id, mutant_filename, mutant);
+    return;
+  }
 
+  string path{output_dir_};
+  path += mutant_filename;
 
-  string mutant_filename{output_dir_};
-  mutant_filename += GetNextMutantFilename();
+  if (config_->getShardedLayout())
+  {
+    string directory{path, 0, path.rfind('/')};
 
-  // Make and write mutated code to output file.
-  // cout << "cp 1\n";
-  const RewriteBuffer *RewriteBuf = rewriter.getRewriteBufferFor(
-      src_mgr_.getMainFileID());
-  // cout << "cp 2\n";
-  ofstream output(mutant_filename.data());
-  // cout << "cp 3\n";
-  output << string(RewriteBuf->begin(), RewriteBuf->end());
-  // cout << "cp 4\n";
-  output.close(); 
+    if (created_directories_.insert(directory).second &&
+        !CreateParentDirectories(path))
+      cout << "Failed to create directory : " << directory << endl;
+  }
+
+  // Written straight from the buffer of the main file.
+  if (!mutant_file_writer_)
+    mutant_file_writer_.reset(new MutantFileWriter(
+        main_file_content_.data(), main_file_content_.size(),
+        kMutantFileWriterThreads, kMaxPendingMutantFiles));
 
-  // cout << "done\n";
+  mutant_file_writer_->Write(path, start_offset, end_offset, replacement);
+}
+
+void MutantDatabase::FinishMutantFiles()
+{
+  // An incomplete pack file is removed rather than left looking valid.
+  if (pack_writer_ && pack_writer_->IsOpen() && !pack_writer_->Close())
+  {
+    cout << "Failed to write file : " << pack_filename_ << endl;
+    remove(pack_filename_.data());
+  }
+
+  pack_writer_.reset();
+
+  if (!mutant_file_writer_)
+    return;
+
+  for (auto &filename: mutant_file_writer_->Finish())
+    cout << "Failed to open file : " << filename << endl;
+
+  mutant_file_writer_.reset();
 }
 
 void MutantDatabase::WriteAllEntriesToMutantFile()
 {
-  for (auto line_map_iter: mutant_entry_table_)
-    for (auto column_map_iter: line_map_iter.second)
-      for (auto mutantname_map_iter: column_map_iter.second)
-        for (auto entry: mutantname_map_iter.second)
-        {
-          WriteEntryToMutantFile(entry);
-          IncrementNextMutantfileId();
-        }
+  if (sampler_.IsSampling())
+    SelectSampledEntries();
+
+  LoadMainFile();
+
+  for (auto idx: getSortedEntryOrder())
+  {
+    WriteEntryToMutantFile(mutant_entry_table_[idx]);
+    IncrementNextMutantfileId();
+  }
+
+  FinishMutantFiles();
+}
+
+void MutantDatabase::WriteEntryToOutput(const MutantEntry &entry)
+{
+  if (config_->getSchemataOutput() || config_->getTce())
+    exported_edits_.push_back(make_pair(next_mutantfile_id_, 
+                                        MakePatchRecord(entry)));
+
+  if (config_->getSchemataOutput())
+    return;
+
+  if (patch_writer_)
+    WriteEntryToPatchFile(entry);
+  else
+    WriteEntryToMutantFile(entry);
+}
+
+PatchRecord MutantDatabase::MakePatchRecord(const MutantEntry &entry)
+{
+  // Same edit WriteEntryToMutantFile makes, without materializing the
+  // mutated file.
+  PatchRecord record;
+  record.mutant_filename_ = GetNextMutantFilename(entry);
+  record.offset_ = entry.start_offset_;
+  record.length_ = entry.end_offset_ - entry.start_offset_;
+  record.replacement_ = getMutatedToken(entry);
+  return record;
 }
 
-bool CompareEntry(long i, long j)
+void MutantDatabase::WriteEntryToPatchFile(const MutantEntry &entry)
 {
-  return i < j;
+  patch_writer_->WriteRecord(MakePatchRecord(entry));
+}
+
+void MutantDatabase::WriteSchemaFile()
+{
+  string original{src_mgr_.getBufferData(src_mgr_.getMainFileID()).str()};
+  SchemaBuilder builder(original, input_filename_);
+
+  for (auto &region: schema_regions_)
+    builder.AddRegion(region);
+
+  for (auto &barrier: schema_barriers_)
+    builder.AddBarrier(barrier);
+
+  for (auto &edit: exported_edits_)
+    builder.AddMutant(edit.first, edit.second);
+
+  vector<PatchRecord> unschematized;
+  string schema{builder.Build(unschematized)};
+
+  ofstream output(schema_filename_.data());
+
+  if (!output.is_open())
+  {
+    cout << "Failed to open file : " << schema_filename_ << endl;
+    return;
+  }
+
+  output << schema;
+  output.close();
+
+  // Mutants outside of any function body or inside a constant expression
+  // cannot be selected at runtime.
+  unordered_map<string, uint64_t> mutant_ids;
+
+  for (auto &edit: exported_edits_)
+    mutant_ids[edit.second.mutant_filename_] = edit.first;
+
+  for (auto &record: unschematized)
+  {
+    if (patch_writer_)
+    {
+      patch_writer_->WriteRecord(record);
+      continue;
+    }
+
+    WriteMutantFile(mutant_ids[record.mutant_filename_],
+                    record.mutant_filename_, record.offset_,
+                    record.offset_ + record.length_, record.replacement_);
+  }
+
+  cout << "wrote " << exported_edits_.size() - unschematized.size() <<
+          " mutants to schema file, " << unschematized.size() << 
+          " mutants separately\n";
+}
+
+void MutantDatabase::ExportEntry(size_t idx)
+{
+  const MutantEntry &entry = mutant_entry_table_[idx];
+
+  // Mutants reused from the function cache keep their id. With option
+  // -stable-ids, every mutant gets the id derived from what it is.
+  auto cached_id = cached_mutant_ids_.find(idx);
+  uint64_t new_mutant_id = next_mutantfile_id_;
+  bool use_given_id = config_->getStableIds() ||
+                      cached_id != cached_mutant_ids_.end();
+
+  if (config_->getStableIds())
+    next_mutantfile_id_ = GetStableMutantId(entry);
+  else if (cached_id != cached_mutant_ids_.end())
+    next_mutantfile_id_ = cached_id->second;
+
+  WriteEntryToDatabaseFile(entry);
+  WriteEntryToOutput(entry);
+
+  if (config_->getIncremental())
+  {
+    FunctionCacheItem *function = FindFunction(entry.start_offset_);
+
+    // Mutants outside of function definitions are not cached.
+    if (function != nullptr)
+      function->cached_function_.mutants_.push_back(CachedMutant{
+          next_mutantfile_id_, getOperatorName(entry), 
+          entry.start_offset_ - function->start_offset_, 
+          entry.end_offset_ - entry.start_offset_,
+          entry.proteum_style_line_num_ - function->start_line_,
+          getToken(entry), getMutatedToken(entry)});
+  }
+
+  if (use_given_id)
+    next_mutantfile_id_ = new_mutant_id;
+  else
+    IncrementNextMutantfileId();
+}
+
+uint64_t MutantDatabase::GetStableMutantId(const MutantEntry &entry)
+{
+  // Mutants outside of function definitions are located by file offset.
+  FunctionCacheItem *function = FindFunction(entry.start_offset_);
+  string function_key;
+  unsigned offset = entry.start_offset_;
+
+  if (function != nullptr)
+  {
+    function_key = function->cached_function_.key_;
+    offset -= function->start_offset_;
+  }
+
+  // Each field is preceded by its length, so fields cannot run together.
+  string key;
+
+  const string *fields[] = {&config_->getInputFilePath(), &function_key,
+                            &getOperatorName(entry), &getToken(entry),
+                            &getMutatedToken(entry)};
+
+  for (const string *field: fields)
+  {
+    key += to_string(field->length());
+    key += ":";
+    key += *field;
+  }
+
+  key += to_string(offset);
+
+  // Ids must be positive and unique within the file. Taking another id on
+  // a collision would make it depend on export order, so the run stops
+  // instead; with 64 bits this is not expected to happen.
+  uint64_t mutant_id = HashFileContent(key);
+
+  if (mutant_id == 0)
+    mutant_id = 1;
+
+  if (!used_stable_ids_.insert(mutant_id).second)
+  {
+    cout << "Mutant id " << mutant_id << " of option -stable-ids is " <<
+            "given to two mutants of " << config_->getInputFilePath() << endl;
+    exit(1);
+  }
+
+  return mutant_id;
+}
+
+void MutantDatabase::WriteFunctionCacheFile()
+{
+  FunctionCache cache;
+  cache.next_mutant_id_ = next_mutantfile_id_;
+  cache.file_scope_hash_ = file_scope_hash_;
+  cache.options_hash_ = config_->getMutationOptionsHash();
+
+  // Functions neither reused nor mutated have no mutants yet.
+  for (auto &function: functions_)
+    if (function.reused_ || function.mutated_)
+      cache.functions_.push_back(function.cached_function_);
+
+  if (!WriteFunctionCache(function_cache_filename_, cache))
+    cout << "Failed to open file : " << function_cache_filename_ << endl;
 }
 
 // generate mutant file and write to database file
@@ -213,64 +835,228 @@ void MutantDatabase::ExportAllEntries()
   for (auto e: all_mutant_operators)
     mutant_count[e] = 0;
 
+  if (sampler_.IsSampling())
+    SelectSampledEntries();
 
-  for (auto line_map_iter: mutant_entry_table_)
-    for (auto column_map_iter: line_map_iter.second)
-      for (auto mutantname_map_iter: column_map_iter.second)
-      {
-        // Generate all mutants of this mutation operator at this mutation 
-        // point if number of to-be-generated mutants is <= given limit.
-        if (mutantname_map_iter.second.size() <= num_mutant_limit_)
-        {
-          for (auto entry: mutantname_map_iter.second)
-          {
-            WriteEntryToDatabaseFile(mutantname_map_iter.first, entry);
-            WriteEntryToMutantFile(entry);
-            IncrementNextMutantfileId();
-
-            mutant_count[mutantname_map_iter.first] += 1;
-          }
-        }
-        // Otherwise, randomly generate LIMIT number of mutants.
-        else
-        {
-          // Generate a list of LIMIT distinct numbers/indexes, each less than  
-          // number of supposed-to-be-generated mutants.
-          // Generate mutants from mutant entries at those indexes.
-
-          set<int> random_nums;
-          GenerateRandomNumbers(random_nums, num_mutant_limit_, 
-                                mutantname_map_iter.second.size());
-
-          for (auto idx: random_nums)
-          {
-            WriteEntryToDatabaseFile(mutantname_map_iter.first, 
-                                     mutantname_map_iter.second[idx]);
-            WriteEntryToMutantFile(mutantname_map_iter.second[idx]);
-            IncrementNextMutantfileId();
-
-            mutant_count[mutantname_map_iter.first] += 1;
-          }
-        } 
-      }
+  if (!OpenSinks())
+    return;
+
+  LoadMainFile();
+
+  if (config_->getPatchOutput())
+  {
+    PatchFileHeader header;
+    header.original_filename_ = input_filename_;
+    header.original_size_ = main_file_content_.size();
+    header.original_hash_ = HashFileContent(main_file_content_.str());
+
+    patch_writer_.reset(new PatchFileWriter(patch_filename_, header));
+
+    if (!patch_writer_->IsOpen())
+    {
+      cout << "Failed to open file : " << patch_filename_ << endl;
+      patch_writer_.reset();
+      CloseSinks();
+      return;
+    }
+  }
+
+  // Entries left out by -l and -budget are already dropped.
+  for (auto idx: getSortedEntryOrder())
+  {
+    ExportEntry(idx);
+    mutant_count[getOperatorName(mutant_entry_table_[idx])] += 1;
+  }
+
+  if (config_->getSchemataOutput())
+    WriteSchemaFile();
+
+  if (config_->getIncremental())
+    WriteFunctionCacheFile();
+
+  patch_writer_.reset();
+  FinishMutantFiles();
+  CloseSinks();
 
   for (auto it: mutant_count)
     cout << it.first << " " << it.second << endl;
 }
 
+namespace {
+
+// {"total":n,"operators":{"name":n,...}}, operators sorted by name.
+void WriteOperatorCounts(ostream &out, const map<string, long> &counts)
+{
+  long total = 0;
+
+  for (auto &it: counts)
+    total += it.second;
+
+  out << "\"total\":" << total << ",\"operators\":{";
+
+  for (auto it = counts.begin(); it != counts.end(); ++it)
+  {
+    if (it != counts.begin())
+      out << ",";
+
+    WriteJsonString(out, it->first);
+    out << ":" << it->second;
+  }
+
+  out << "}";
+}
+
+mutex g_count_output_mutex;
+
+}  // namespace
+
+void MutantDatabase::WriteEntryCounts(ostream &count_file)
+{
+  if (sampler_.IsSampling())
+    SelectSampledEntries();
+
+  map<string, long> file_counts;
+  map<string, long> outside_function_counts;
+  vector<map<string, long>> function_counts(functions_.size());
+
+  for (auto &entry: mutant_entry_table_)
+  {
+    const string &operator_name = getOperatorName(entry);
+    FunctionCacheItem *function = FindFunction(entry.start_offset_);
+
+    file_counts[operator_name] += 1;
+
+    if (function != nullptr)
+      function_counts[function - functions_.data()][operator_name] += 1;
+    else
+      outside_function_counts[operator_name] += 1;
+  }
+
+  ostringstream out;
+  out << "{\"file\":";
+  WriteJsonString(out, input_filename_);
+  out << ",";
+  WriteOperatorCounts(out, file_counts);
+  out << ",\"functions\":[";
+
+  for (size_t i = 0; i < functions_.size(); i++)
+  {
+    if (i > 0)
+      out << ",";
+
+    out << "{\"name\":";
+    WriteJsonString(out, functions_[i].cached_function_.key_);
+    out << ",\"line\":" << functions_[i].start_line_ << ",";
+    WriteOperatorCounts(out, function_counts[i]);
+    out << "}";
+  }
+
+  out << "],\"outside_functions\":{";
+  WriteOperatorCounts(out, outside_function_counts);
+  out << "}}\n";
+
+  // Lines of files processed in parallel must not interleave.
+  lock_guard<mutex> lock(g_count_output_mutex);
+  count_file << out.str() << flush;
+}
+
 const MutantEntryTable& MutantDatabase::getEntryTable() const
 {
   return mutant_entry_table_;
 }
 
-string MutantDatabase::GetNextMutantFilename()
+uint64_t MutantDatabase::getNumGeneratedEntries() const
+{
+  return num_generated_entries_;
+}
+
+const string& MutantDatabase::getOperatorName(const MutantEntry &entry) const
+{
+  return operator_names_[entry.operator_id_];
+}
+
+const string& MutantDatabase::getToken(const MutantEntry &entry) const
+{
+  return token_pool_.getString(entry.token_id_);
+}
+
+const string& MutantDatabase::getMutatedToken(const MutantEntry &entry) const
+{
+  return token_pool_.getString(entry.mutated_token_id_);
+}
+
+void MutantDatabase::GetLineColumn(uint32_t offset, int &line_num, 
+                                   int &col_num)
+{
+  LoadMainFile();
+  line_table_.GetLineColumn(offset, line_num, col_num);
+}
+
+void MutantDatabase::LoadMainFile()
+{
+  if (line_table_.IsBuilt())
+    return;
+
+  main_file_content_ = src_mgr_.getBufferData(src_mgr_.getMainFileID());
+  line_table_.Build(main_file_content_.data(), main_file_content_.size());
+}
+
+const vector<pair<uint64_t, PatchRecord>>&
+MutantDatabase::getExportedEdits() const
+{
+  return exported_edits_;
+}
+
+string MutantDatabase::getDatabasePathPrefix() const
+{
+  return database_path_prefix_;
+}
+
+vector<size_t> MutantDatabase::getSortedEntryOrder() const
+{
+  vector<size_t> order(mutant_entry_table_.size());
+
+  for (size_t i = 0; i < order.size(); i++)
+    order[i] = i;
+
+  // Same order as iterating the line, column and operator name levels of
+  // the nested map the table used to be.
+  stable_sort(order.begin(), order.end(),
+              [this](size_t i, size_t j)
+              {
+                const MutantEntry &a = mutant_entry_table_[i];
+                const MutantEntry &b = mutant_entry_table_[j];
+
+                if (a.start_offset_ != b.start_offset_)
+                  return a.start_offset_ < b.start_offset_;
+                return a.operator_id_ != b.operator_id_ &&
+                       getOperatorName(a) < getOperatorName(b);
+              });
+
+  return order;
+}
+
+string MutantDatabase::GetNextMutantFilename(const MutantEntry &entry)
 {
   // if input filename is "test.c" and next_mutantfile_id_ is 1,
   // then the next mutant filename is "test.MUT1.c"
   // this function will, however, return "test.MUT1" 
   // for use in both database record and mutant file generation
   string mutant_filename;
-  mutant_filename.assign(input_filename_, 0, input_filename_.length()-2);
+
+  // With -layout sharded, e.g. "SSDL/0/test.MUT1.c"
+  if (config_->getShardedLayout())
+  {
+    uint64_t ids_per_shard = config_->getStableIds() ? kStableIdsPerShard :
+                                                       kMutantsPerShard;
+
+    mutant_filename += getOperatorName(entry);
+    mutant_filename += "/";
+    mutant_filename += to_string(next_mutantfile_id_ / ids_per_shard);
+    mutant_filename += "/";
+  }
+
+  mutant_filename.append(input_filename_, 0, input_filename_.length()-2);
   mutant_filename += ".MUT";
   mutant_filename += to_string(next_mutantfile_id_);
   mutant_filename += ".c";
@@ -4,55 +4,290 @@
 #include <string>
 #include <map>
 #include <vector>
+#include <unordered_map>
+#include <unordered_set>
 #include <iostream>
+#include <memory>
 
+#include "clang/AST/Decl.h"
 #include "clang/Frontend/CompilerInstance.h"
 #include "clang/Basic/SourceManager.h"
 #include "clang/Basic/LangOptions.h"
 
+#include "configuration.h"
+#include "function_cache.h"
+#include "line_table.h"
 #include "mutant_entry.h"
+#include "mutant_database_sink.h"
+#include "mutant_file_writer.h"
+#include "mutant_sampler.h"
+#include "pack_file.h"
+#include "patch_file.h"
+#include "schema_builder.h"
 
-typedef int LineNumber;
-typedef int ColumnNumber;
 typedef std::string MutantName;
 
-typedef std::vector<MutantEntry> MutantEntryList;
-typedef std::map<MutantName, MutantEntryList> MutantNameToEntryMap;
-typedef std::map<ColumnNumber, MutantNameToEntryMap> ColumnNumToEntryMap;
-typedef std::map<LineNumber, ColumnNumToEntryMap> MutantEntryTable;
+// Entries in the order they were added. Entries with the same start offset
+// and mutation operator form one mutation point, to which option -l
+// applies. With -l or -budget, only entries that can still be selected
+// are kept.
+typedef std::vector<MutantEntry> MutantEntryTable;
+
+// Two entries are duplicates if they make the same replacement of the same
+// token at the same mutation point.
+struct MutantEntryKey
+{
+  uint32_t start_offset_;
+  uint16_t operator_id_;
+  uint32_t token_id_;
+  uint32_t mutated_token_id_;
+
+  bool operator==(const MutantEntryKey &rhs) const;
+};
+
+struct MutantEntryKeyHash
+{
+  size_t operator()(const MutantEntryKey &key) const;
+};
+
+/**
+  A function definition of the input file, recorded with option
+  -incremental, -stratify function or -count-only.
+
+  @param  cached_function_ key, hash and exported mutants of the function,
+                           written to the function cache for the next run
+          start_offset_ end_offset_ text of function definition
+                                    [start_offset_, end_offset_)
+          start_line_ line number of start of function definition
+          reused_ True if mutants are reused from the previous run
+          mutated_ True if mutants are generated in this run
+*/
+struct FunctionCacheItem
+{
+  CachedFunction cached_function_;
+  unsigned start_offset_;
+  unsigned end_offset_;
+  int start_line_;
+  bool reused_;
+  bool mutated_;
+};
 
 class MutantDatabase
 {
 public:
-  MutantDatabase(clang::CompilerInstance *comp_inst, 
-                 std::string input_filename, std::string output_dir, int limit);
+  MutantDatabase(clang::CompilerInstance *comp_inst, Configuration *config);
 
   void AddMutantEntry(MutantName name, clang::SourceLocation start_loc,
                       clang::SourceLocation end_loc, std::string token,
                       std::string mutated_token, int proteum_style_line_num);
-  void WriteEntryToDatabaseFile(std::string mutant_name, const MutantEntry &entry);
+  /**
+    Record function definition [start_loc, end_loc] with option -incremental.
+    If its text is the same as in the previous run, the mutants exported for
+    it then are added again with their ids, and no new mutant is generated
+    for it. Otherwise mutants are generated for it, unless option -diff is
+    given and none of its lines changed.
+
+    @param  key name and type of function, unique within the input file
+  */
+  void AddFunction(const std::string &key, clang::SourceLocation start_loc,
+                   clang::SourceLocation end_loc);
+
+  /**
+    With option -incremental, hash the text of the input file outside of
+    the function definitions of translation unit tu. If it differs from
+    the previous run, no function is reused from the function cache.
+    Called before the first AddFunction.
+  */
+  void CheckFileScopeOfFunctionCache(clang::TranslationUnitDecl *tu);
+
+  // Return true if mutants starting at loc are generated in this run.
+  // Always true without option -incremental.
+  bool IsInMutatedCode(clang::SourceLocation loc);
+
+  // Take ownership of sink. It receives the records of the next export
+  // in addition to the sinks selected by Configuration.
+  void AddSink(MutantDatabaseSink *sink);
+
+  // Record a piece of the input file that can hold a runtime switch
+  // between mutants in schemata output mode. [start_loc, end_loc)
+  void AddSchemaRegion(SchemaRegionKind kind, clang::SourceLocation start_loc,
+                       clang::SourceLocation end_loc);
+  // Record text at loc that must not be duplicated without whole scope.
+  // Invalid scope means the whole file.
+  void AddSchemaBarrier(clang::SourceLocation loc, clang::SourceRange scope);
+
+  void WriteEntryToDatabaseFile(const MutantEntry &entry);
   void WriteAllEntriesToDatabaseFile();
   void WriteEntryToMutantFile(const MutantEntry &entry);
   void WriteAllEntriesToMutantFile();
+  void WriteEntryToPatchFile(const MutantEntry &entry);
+
+  // Write entry as a full mutant file, or as an edit in the patch file
+  // if patch output mode is on. In schemata output mode, the entry is
+  // kept until WriteSchemaFile. Its edit is also kept if TCE is on.
+  void WriteEntryToOutput(const MutantEntry &entry);
+
+  // Write all kept entries into one schematized source file. Entries that
+  // cannot be put in it are written as in the other output modes.
+  void WriteSchemaFile();
+
   void ExportAllEntries();
 
+  /**
+    Write the number of mutants ExportAllEntries would write, per mutation
+    operator for the whole file and for each function definition, as one
+    line of JSON to out (the file of option -count-only). Nothing else is
+    written. out can be shared by files processed in parallel.
+  */
+  void WriteEntryCounts(std::ostream &out);
+
   const MutantEntryTable& getEntryTable() const;
 
+  // Number of mutants added by mutation operators so far, including those
+  // dropped later by -l or -budget. Duplicates are not counted.
+  uint64_t getNumGeneratedEntries() const;
+  const std::string& getOperatorName(const MutantEntry &entry) const;
+  const std::string& getToken(const MutantEntry &entry) const;
+  const std::string& getMutatedToken(const MutantEntry &entry) const;
+
+  // Line and column of offset in the main file.
+  void GetLineColumn(uint32_t offset, int &line_num, int &col_num);
+
+  // Mutant id and edit of each exported entry. Only kept in schemata output
+  // mode or if TCE is on.
+  const std::vector<std::pair<uint64_t, PatchRecord>>&
+  getExportedEdits() const;
+
+  // Path of database files without extension.
+  std::string getDatabasePathPrefix() const;
+
+  // Return positions in entry table ordered by start offset and mutation
+  // operator name, which is the order of line, column and name. Entries of
+  // the same mutation point keep insertion order.
+  std::vector<size_t> getSortedEntryOrder() const;
+
 private:
   clang::CompilerInstance *comp_inst_;
   clang::SourceManager &src_mgr_;
   clang::LangOptions &lang_opts_;
+  Configuration *config_;
 
   MutantEntryTable mutant_entry_table_;
+  std::unordered_set<MutantEntryKey, MutantEntryKeyHash> mutant_entry_keys_;
+  uint64_t num_generated_entries_;
+
+  // Tokens of all entries and names of their mutation operators.
+  StringPool token_pool_;
+  std::vector<MutantName> operator_names_;
+  std::unordered_map<MutantName, uint16_t> operator_ids_;
+
+  // Content of main file and its lines, loaded when exporting.
+  llvm::StringRef main_file_content_;
+  LineTable line_table_;
+
+  // Ids of entries reused from the function cache, by position in entry
+  // table. Other entries get their id when exported.
+  std::unordered_map<size_t, uint64_t> cached_mutant_ids_;
+
+  // Ids given with option -stable-ids so far.
+  std::unordered_set<uint64_t> used_stable_ids_;
+
   std::string input_filename_;
-  std::string database_filename_;
+  // path of database files without extension (e.g. /output/test_mut_db)
+  std::string database_path_prefix_;
+  std::string patch_filename_;
+  std::string schema_filename_;
+  std::string pack_filename_;
   std::string output_dir_;
-  int next_mutantfile_id_;
+  uint64_t next_mutantfile_id_;
+
+  // Selection of entries by options -l, -seed, -budget and -stratify.
+  // Candidates of the sampler, by position in entry table. Reused entries
+  // are not sampled again.
+  MutantSampler sampler_;
+  std::vector<MutantSampler::Candidate> sample_candidates_;
+
+  // Sinks records are written to. Open only while exporting entries.
+  std::vector<std::unique_ptr<MutantDatabaseSink>> sinks_;
+
+  // Open only while exporting entries in patch output mode.
+  std::unique_ptr<PatchFileWriter> patch_writer_;
+
+  // Open from the first full mutant file written until the end of export.
+  // With option -pack, mutant files are written into the pack instead.
+  std::unique_ptr<MutantFileWriter> mutant_file_writer_;
+  std::unique_ptr<PackFileWriter> pack_writer_;
+
+  // Directories of mutant files created with -layout sharded.
+  std::unordered_set<std::string> created_directories_;
+
+  std::vector<SchemaRegion> schema_regions_;
+  std::vector<SchemaBarrier> schema_barriers_;
+
+  std::vector<std::pair<uint64_t, PatchRecord>> exported_edits_;
+
+  // Function cache read from the previous run and position of each of its
+  // functions by key. Empty without option -incremental.
+  std::string function_cache_filename_;
+  FunctionCache previous_function_cache_;
+  std::unordered_map<std::string, size_t> previous_function_index_;
+
+  // Hash of the text outside of function definitions in this run.
+  uint64_t file_scope_hash_;
+
+  // Function definitions of this run, ordered by start offset.
+  std::vector<FunctionCacheItem> functions_;
+
+  // Return function definition containing offset, nullptr if none.
+  FunctionCacheItem* FindFunction(unsigned offset);
+  void AddCachedMutants(const FunctionCacheItem &function,
+                        const CachedFunction &cached_function);
+
+  uint16_t GetOperatorId(const MutantName &name);
+
+  // Stratum of new entry starting at start_loc, by option -stratify.
+  uint64_t GetSampleStratum(const MutantEntry &entry,
+                            clang::SourceLocation start_loc);
+
+  // Drop the entries the sampler leaves out, keeping order of the others.
+  void SelectSampledEntries();
+
+  // Set main_file_content_ and build line_table_ if not done yet.
+  void LoadMainFile();
+
+  // Write entry idx to database, output and function cache under id
+  // of reused mutant or next new id.
+  void ExportEntry(size_t idx);
+  void WriteFunctionCacheFile();
+
+  /**
+    Id of entry with option -stable-ids: a 64-bit hash of input file path
+    relative to the directory of its compile command, key of enclosing
+    function, offset in that function (in file outside of function
+    definitions), mutation operator, token and mutated token. It does not
+    change when other code or other mutants change.
+  */
+  uint64_t GetStableMutantId(const MutantEntry &entry);
+
+  // Edit that turns original file into the next mutant.
+  PatchRecord MakePatchRecord(const MutantEntry &entry);
+
+  bool OpenSinks();
+  void CloseSinks();
+
+  // Write mutant file mutant_filename, relative to the output directory:
+  // the main file with [start_offset, end_offset) replaced.
+  void WriteMutantFile(uint64_t mutant_id,
+                       const std::string &mutant_filename,
+                       uint32_t start_offset, uint32_t end_offset,
+                       const std::string &replacement);
 
-  // maxi number of mutants generated per mutation point per mutation operator
-  int num_mutant_limit_;
+  // Wait for mutant files still being written, close the pack and report
+  // failures.
+  void FinishMutantFiles();
 
-  std::string GetNextMutantFilename();
+  // Name of next mutant file, relative to the output directory.
+  std::string GetNextMutantFilename(const MutantEntry &entry);
   void IncrementNextMutantfileId();
 };
 
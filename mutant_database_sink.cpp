@@ -0,0 +1,369 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <mutex>
+
+#include "mutant_database_sink.h"
+
+namespace {
+
+// Size of the stream buffer of each file sink.
+const size_t kSinkBufferSize = 1 << 16;
+
+std::mutex g_sink_registry_mutex;
+
+MutantDatabaseSink* CreateCsvSink(const std::string &db_path_prefix)
+{
+  return new CsvMutantDatabaseSink(db_path_prefix + ".csv");
+}
+
+MutantDatabaseSink* CreateJsonLinesSink(const std::string &db_path_prefix)
+{
+  return new JsonLinesMutantDatabaseSink(db_path_prefix + ".jsonl");
+}
+
+MutantDatabaseSink* CreateBinarySink(const std::string &db_path_prefix)
+{
+  return new BinaryMutantDatabaseSink(db_path_prefix + ".bin");
+}
+
+MutantDatabaseSink* CreateIndexedSink(const std::string &db_path_prefix)
+{
+  return new IndexedMutantDatabaseSink(db_path_prefix + ".idx");
+}
+
+// Caller must hold g_sink_registry_mutex.
+std::map<std::string, MutantDatabaseSinkFactory>& GetSinkRegistry()
+{
+  static std::map<std::string, MutantDatabaseSinkFactory> registry{
+      {"csv", CreateCsvSink},
+      {"jsonl", CreateJsonLinesSink},
+      {"binary", CreateBinarySink},
+      {"indexed", CreateIndexedSink}};
+  return registry;
+}
+
+}  // namespace
+
+void WriteJsonString(std::ostream &out, const std::string &str)
+{
+  out << '"';
+
+  for (unsigned char c: str)
+  {
+    switch (c)
+    {
+      case '"': out << "\\\""; break;
+      case '\\': out << "\\\\"; break;
+      case '\n': out << "\\n"; break;
+      case '\r': out << "\\r"; break;
+      case '\t': out << "\\t"; break;
+      default:
+        if (c < 0x20)
+        {
+          char escaped[7];
+          snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+          out << escaped;
+        }
+        else
+          out << c;
+    }
+  }
+
+  out << '"';
+}
+
+FileMutantDatabaseSink::FileMutantDatabaseSink(std::string filename,
+                                               bool binary)
+  : filename_(filename), buffer_(kSinkBufferSize)
+{
+  // Buffer must be installed before the file is opened to take effect.
+  out_.rdbuf()->pubsetbuf(buffer_.data(), buffer_.size());
+
+  if (binary)
+    out_.open(filename_.data(), std::ios::trunc | std::ios::binary);
+  else
+    out_.open(filename_.data(), std::ios::trunc);
+}
+
+FileMutantDatabaseSink::~FileMutantDatabaseSink()
+{
+  Close();
+}
+
+bool FileMutantDatabaseSink::IsOpen() const
+{
+  return out_.is_open();
+}
+
+void FileMutantDatabaseSink::Close()
+{
+  if (out_.is_open())
+    out_.close();
+}
+
+std::string FileMutantDatabaseSink::getFilename() const
+{
+  return filename_;
+}
+
+CsvMutantDatabaseSink::CsvMutantDatabaseSink(std::string filename)
+  : FileMutantDatabaseSink(filename, false)
+{
+  if (!IsOpen())
+    return;
+
+  out_ << "Mutant Filename,Mutation Operator,Line#,Before Mutation,,,,,After Mutation\n";
+  out_ << ",,,Start Line#,Start Col#,End Line#,End Col#,Target Token,";
+  out_ << "Start Line#,Start Col#,End Line#,End Col#,Mutated Token\n";
+}
+
+void CsvMutantDatabaseSink::WriteRecord(const MutantRecord &record)
+{
+  // write mutant file name
+  out_ << record.mutant_filename_ << ",";
+
+  // write name of operator
+  out_ << record.operator_name_ << ",";
+
+  // write information about token BEFORE mutation
+  out_ << record.proteum_line_num_ << ",";
+  out_ << record.start_line_ << ",";
+  out_ << record.start_col_ << ",";
+  out_ << record.end_line_ << ",";
+  out_ << record.end_col_ << ",";
+  out_ << record.token_ << ",";
+
+  // write information about token AFTER mutation
+  out_ << record.start_line_ << ",";
+  out_ << record.start_col_ << ",";
+  out_ << record.mutated_end_line_ << ",";
+  out_ << record.mutated_end_col_ << ",";
+  out_ << record.mutated_token_ << "\n";
+}
+
+JsonLinesMutantDatabaseSink::JsonLinesMutantDatabaseSink(std::string filename)
+  : FileMutantDatabaseSink(filename, false)
+{}
+
+void JsonLinesMutantDatabaseSink::WriteRecord(const MutantRecord &record)
+{
+  out_ << "{\"mutant\":";
+  WriteJsonString(out_, record.mutant_filename_);
+  out_ << ",\"operator\":";
+  WriteJsonString(out_, record.operator_name_);
+  out_ << ",\"proteum_line\":" << record.proteum_line_num_;
+  out_ << ",\"start_line\":" << record.start_line_;
+  out_ << ",\"start_col\":" << record.start_col_;
+  out_ << ",\"end_line\":" << record.end_line_;
+  out_ << ",\"end_col\":" << record.end_col_;
+  out_ << ",\"token\":";
+  WriteJsonString(out_, record.token_);
+  out_ << ",\"mutated_end_line\":" << record.mutated_end_line_;
+  out_ << ",\"mutated_end_col\":" << record.mutated_end_col_;
+  out_ << ",\"mutated_token\":";
+  WriteJsonString(out_, record.mutated_token_);
+  out_ << "}\n";
+}
+
+BinaryMutantDatabaseSink::BinaryMutantDatabaseSink(std::string filename)
+  : FileMutantDatabaseSink(filename, true)
+{
+  if (IsOpen())
+    out_.write("MUSICDB1", 8);
+}
+
+void BinaryMutantDatabaseSink::WriteUInt32(uint32_t value)
+{
+  char bytes[4];
+
+  for (int i = 0; i < 4; i++)
+    bytes[i] = static_cast<char>((value >> (8 * i)) & 0xff);
+
+  out_.write(bytes, 4);
+}
+
+void BinaryMutantDatabaseSink::WriteString(const std::string &str)
+{
+  WriteUInt32(str.length());
+  out_.write(str.data(), str.length());
+}
+
+void BinaryMutantDatabaseSink::WriteRecord(const MutantRecord &record)
+{
+  WriteString(record.mutant_filename_);
+  WriteString(record.operator_name_);
+  WriteUInt32(record.proteum_line_num_);
+  WriteUInt32(record.start_line_);
+  WriteUInt32(record.start_col_);
+  WriteUInt32(record.end_line_);
+  WriteUInt32(record.end_col_);
+  WriteUInt32(record.mutated_end_line_);
+  WriteUInt32(record.mutated_end_col_);
+  WriteString(record.token_);
+  WriteString(record.mutated_token_);
+}
+
+IndexedMutantDatabaseSink::IndexedMutantDatabaseSink(std::string filename)
+  : FileMutantDatabaseSink(filename, true)
+{}
+
+IndexedMutantDatabaseSink::~IndexedMutantDatabaseSink()
+{
+  Close();
+}
+
+uint32_t IndexedMutantDatabaseSink::InternString(const std::string &str)
+{
+  auto it = string_offsets_.find(str);
+
+  if (it != string_offsets_.end())
+    return it->second;
+
+  uint32_t offset = string_pool_.length();
+  uint32_t length = str.length();
+
+  string_pool_.append(reinterpret_cast<const char *>(&length), sizeof(length));
+  string_pool_.append(str);
+  string_pool_.push_back('\0');
+
+  string_offsets_[str] = offset;
+  return offset;
+}
+
+void IndexedMutantDatabaseSink::WriteRecord(const MutantRecord &record)
+{
+  IndexedDbRecord indexed_record;
+  indexed_record.mutant_id_ = record.mutant_id_;
+  indexed_record.mutant_filename_ = InternString(record.mutant_filename_);
+  indexed_record.operator_name_ = InternString(record.operator_name_);
+  indexed_record.proteum_line_num_ = record.proteum_line_num_;
+  indexed_record.start_line_ = record.start_line_;
+  indexed_record.start_col_ = record.start_col_;
+  indexed_record.end_line_ = record.end_line_;
+  indexed_record.end_col_ = record.end_col_;
+  indexed_record.mutated_end_line_ = record.mutated_end_line_;
+  indexed_record.mutated_end_col_ = record.mutated_end_col_;
+  indexed_record.token_ = InternString(record.token_);
+  indexed_record.mutated_token_ = InternString(record.mutated_token_);
+  indexed_record.reserved_ = 0;
+
+  records_.push_back(indexed_record);
+}
+
+void IndexedMutantDatabaseSink::Close()
+{
+  if (!IsOpen())
+    return;
+
+  uint32_t count = records_.size();
+  std::vector<uint32_t> id_index(count);
+  std::vector<uint32_t> line_index(count);
+  std::vector<uint32_t> operator_index(count);
+
+  for (uint32_t i = 0; i < count; i++)
+    id_index[i] = line_index[i] = operator_index[i] = i;
+
+  std::sort(id_index.begin(), id_index.end(),
+            [this](uint32_t i, uint32_t j)
+            { return records_[i].mutant_id_ < records_[j].mutant_id_; });
+
+  std::sort(line_index.begin(), line_index.end(),
+            [this](uint32_t i, uint32_t j)
+            {
+              if (records_[i].start_line_ != records_[j].start_line_)
+                return records_[i].start_line_ < records_[j].start_line_;
+              return records_[i].mutant_id_ < records_[j].mutant_id_;
+            });
+
+  // Operator names are compared as the '\0'-terminated strings stored in
+  // the pool, the same order the reader's binary search expects.
+  std::sort(operator_index.begin(), operator_index.end(),
+            [this](uint32_t i, uint32_t j)
+            {
+              int cmp = strcmp(
+                  &string_pool_[records_[i].operator_name_ + sizeof(uint32_t)],
+                  &string_pool_[records_[j].operator_name_ + sizeof(uint32_t)]);
+              if (cmp != 0)
+                return cmp < 0;
+              return records_[i].mutant_id_ < records_[j].mutant_id_;
+            });
+
+  IndexedDbHeader header;
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic_, kIndexedDbMagic, sizeof(kIndexedDbMagic));
+  header.version_ = kIndexedDbVersion;
+  header.endian_tag_ = kIndexedDbEndianTag;
+  header.record_count_ = count;
+  header.record_size_ = sizeof(IndexedDbRecord);
+  header.records_offset_ = sizeof(IndexedDbHeader);
+  header.id_index_offset_ = header.records_offset_ + 
+                            uint64_t(count) * sizeof(IndexedDbRecord);
+  header.line_index_offset_ = header.id_index_offset_ + 
+                              uint64_t(count) * sizeof(uint32_t);
+  header.operator_index_offset_ = header.line_index_offset_ + 
+                                  uint64_t(count) * sizeof(uint32_t);
+  header.string_pool_offset_ = header.operator_index_offset_ + 
+                               uint64_t(count) * sizeof(uint32_t);
+  header.string_pool_size_ = string_pool_.length();
+
+  out_.write(reinterpret_cast<const char *>(&header), sizeof(header));
+  out_.write(reinterpret_cast<const char *>(records_.data()),
+             count * sizeof(IndexedDbRecord));
+  out_.write(reinterpret_cast<const char *>(id_index.data()),
+             count * sizeof(uint32_t));
+  out_.write(reinterpret_cast<const char *>(line_index.data()),
+             count * sizeof(uint32_t));
+  out_.write(reinterpret_cast<const char *>(operator_index.data()),
+             count * sizeof(uint32_t));
+  out_.write(string_pool_.data(), string_pool_.length());
+
+  records_.clear();
+  string_pool_.clear();
+  string_offsets_.clear();
+
+  FileMutantDatabaseSink::Close();
+}
+
+void RegisterMutantDatabaseSink(const std::string &name,
+                                MutantDatabaseSinkFactory factory)
+{
+  std::lock_guard<std::mutex> lock(g_sink_registry_mutex);
+  GetSinkRegistry()[name] = factory;
+}
+
+bool IsMutantDatabaseSinkRegistered(const std::string &name)
+{
+  std::lock_guard<std::mutex> lock(g_sink_registry_mutex);
+  return GetSinkRegistry().count(name) != 0;
+}
+
+std::vector<std::string> GetMutantDatabaseSinkNames()
+{
+  std::lock_guard<std::mutex> lock(g_sink_registry_mutex);
+  std::vector<std::string> names;
+
+  for (auto &it: GetSinkRegistry())
+    names.push_back(it.first);
+
+  return names;
+}
+
+MutantDatabaseSink* CreateMutantDatabaseSink(const std::string &name,
+                                             const std::string &db_path_prefix)
+{
+  MutantDatabaseSinkFactory factory;
+
+  {
+    std::lock_guard<std::mutex> lock(g_sink_registry_mutex);
+    auto it = GetSinkRegistry().find(name);
+
+    if (it == GetSinkRegistry().end())
+      return nullptr;
+
+    factory = it->second;
+  }
+
+  return factory(db_path_prefix);
+}
@@ -0,0 +1,169 @@
+#ifndef MUSIC_MUTANT_DATABASE_SINK_H_
+#define MUSIC_MUTANT_DATABASE_SINK_H_
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "indexed_mutant_database.h"
+
+/**
+  One row of the mutation database, with source locations already
+  resolved to line and column numbers.
+
+  @param  mutant_id_ number of mutant within its input file (e.g. 12)
+          mutant_filename_ name of mutant file (e.g. test.MUT12.c)
+          operator_name_ name of mutation operator
+          proteum_line_num_ line number in Proteum style
+          start_line_ start_col_ start of token (same before and after
+                                 mutation)
+          end_line_ end_col_ end of token before mutation
+          mutated_end_line_ mutated_end_col_ end of token after mutation
+          token_ token before mutation
+          mutated_token_ token after mutation
+*/
+struct MutantRecord
+{
+  uint64_t mutant_id_;
+  std::string mutant_filename_;
+  std::string operator_name_;
+  int proteum_line_num_;
+  int start_line_;
+  int start_col_;
+  int end_line_;
+  int end_col_;
+  int mutated_end_line_;
+  int mutated_end_col_;
+  std::string token_;
+  std::string mutated_token_;
+};
+
+/**
+  Destination of mutation database records. A sink is opened once per input
+  file, receives every exported record in order and is closed at the end of
+  the export.
+
+  Backends are selected by name with option -db-format. In-process callers
+  can add their own backend with RegisterMutantDatabaseSink, or hand an
+  instance directly to MutantDatabase::AddSink.
+*/
+class MutantDatabaseSink
+{
+public:
+  virtual ~MutantDatabaseSink() {}
+
+  virtual bool IsOpen() const = 0;
+  virtual void WriteRecord(const MutantRecord &record) = 0;
+  virtual void Close() = 0;
+};
+
+/**
+  Base for sinks writing to a single file through one buffered stream that
+  stays open for the whole export.
+*/
+class FileMutantDatabaseSink : public MutantDatabaseSink
+{
+public:
+  FileMutantDatabaseSink(std::string filename, bool binary);
+  virtual ~FileMutantDatabaseSink();
+
+  virtual bool IsOpen() const;
+  virtual void Close();
+
+  std::string getFilename() const;
+
+protected:
+  std::string filename_;
+  std::ofstream out_;
+
+private:
+  std::vector<char> buffer_;
+};
+
+// <name>_mut_db.csv, same layout as earlier versions of MUSIC.
+class CsvMutantDatabaseSink : public FileMutantDatabaseSink
+{
+public:
+  CsvMutantDatabaseSink(std::string filename);
+  virtual void WriteRecord(const MutantRecord &record);
+};
+
+// <name>_mut_db.jsonl, one JSON object per mutant.
+class JsonLinesMutantDatabaseSink : public FileMutantDatabaseSink
+{
+public:
+  JsonLinesMutantDatabaseSink(std::string filename);
+  virtual void WriteRecord(const MutantRecord &record);
+};
+
+/**
+  <name>_mut_db.bin. File starts with the 8 bytes "MUSICDB1", followed by
+  one record per mutant. Integers are little-endian. A record is:
+    u32 length + bytes   mutant filename
+    u32 length + bytes   operator name
+    i32 x 7              proteum line, start line, start col, end line,
+                         end col, mutated end line, mutated end col
+    u32 length + bytes   token
+    u32 length + bytes   mutated token
+*/
+class BinaryMutantDatabaseSink : public FileMutantDatabaseSink
+{
+public:
+  BinaryMutantDatabaseSink(std::string filename);
+  virtual void WriteRecord(const MutantRecord &record);
+
+private:
+  void WriteUInt32(uint32_t value);
+  void WriteString(const std::string &str);
+};
+
+/**
+  <name>_mut_db.idx, an indexed database for random access by mutant id,
+  line or mutation operator (see indexed_mutant_database.h for the layout
+  and the reader). Indexes can only be built once all records are known,
+  so records are kept in memory and the file is written on Close.
+*/
+class IndexedMutantDatabaseSink : public FileMutantDatabaseSink
+{
+public:
+  IndexedMutantDatabaseSink(std::string filename);
+  virtual ~IndexedMutantDatabaseSink();
+
+  virtual void WriteRecord(const MutantRecord &record);
+  virtual void Close();
+
+private:
+  std::vector<IndexedDbRecord> records_;
+  std::string string_pool_;
+  std::unordered_map<std::string, uint32_t> string_offsets_;
+
+  // Return offset of str in string pool, adding it if not yet present.
+  uint32_t InternString(const std::string &str);
+};
+
+/**
+  Create a sink given the path of database files without extension
+  (e.g. /output/test_mut_db). The sink appends its own extension.
+*/
+typedef MutantDatabaseSink* (*MutantDatabaseSinkFactory)(
+    const std::string &db_path_prefix);
+
+// Register factory under name. Replace existing factory with same name.
+void RegisterMutantDatabaseSink(const std::string &name,
+                                MutantDatabaseSinkFactory factory);
+
+bool IsMutantDatabaseSinkRegistered(const std::string &name);
+
+// Return names of all registered sinks, sorted.
+std::vector<std::string> GetMutantDatabaseSinkNames();
+
+// Return nullptr if no sink is registered under name.
+MutantDatabaseSink* CreateMutantDatabaseSink(const std::string &name,
+                                             const std::string &db_path_prefix);
+
+// Write str as a quoted and escaped JSON string.
+void WriteJsonString(std::ostream &out, const std::string &str);
+
+#endif  // MUSIC_MUTANT_DATABASE_SINK_H_
@@ -1,59 +1,32 @@
 #include "mutant_entry.h"
-#include "music_utility.h"
-
-MutantEntry::MutantEntry(
-    string token, string mutated_token, clang::SourceLocation start_loc, 
-    clang::SourceLocation end_loc, clang::SourceManager &src_mgr,
-    int proteum_style_line_num)
-: token_(token), mutated_token_(mutated_token),
-start_location_(start_loc), end_location_before_mutation_(end_loc),
-proteum_style_line_num_(proteum_style_line_num), src_mgr_(src_mgr)
-{
-  // cout << "cp MutantEntry\n";
-  // POTENTIAL ISSUE: no translateLineCol check.
-  end_location_after_mutation_ = src_mgr.translateLineCol(
-      src_mgr.getMainFileID(), GetLineNumber(src_mgr, start_loc),
-      GetColumnNumber(src_mgr, start_loc) + \
-      CountNonNewlineChar(mutated_token));
-}
 
-int MutantEntry::getProteumStyleLineNum() const
+uint32_t StringPool::Intern(const std::string &s)
 {
-  return proteum_style_line_num_;
-}
+  auto inserted = ids_.insert(std::make_pair(s, strings_.size()));
 
-std::string MutantEntry::getToken() const
-{
-  return token_;
-}
-std::string MutantEntry::getMutatedToken() const
-{
-  return mutated_token_;
-}
-clang::SourceLocation MutantEntry::getStartLocation() const
-{
-  return start_location_;
-}
-clang::SourceLocation MutantEntry::getTokenEndLocation() const
-{
-  return end_location_before_mutation_;
-}
-clang::SourceRange MutantEntry::getTokenRange() const
-{
-  return SourceRange(start_location_, end_location_before_mutation_);
+  if (inserted.second)
+    strings_.push_back(&inserted.first->first);
+
+  return inserted.first->second;
 }
-clang::SourceLocation MutantEntry::getMutatedTokenEndLocation() const
+
+bool StringPool::Find(const std::string &s, uint32_t &id) const
 {
-  return end_location_after_mutation_;
+  auto it = ids_.find(s);
+
+  if (it == ids_.end())
+    return false;
+
+  id = it->second;
+  return true;
 }
-clang::SourceRange MutantEntry::getMutatedTokenRange() const
+
+const std::string& StringPool::getString(uint32_t id) const
 {
-  return SourceRange(start_location_, end_location_after_mutation_);
+  return *strings_[id];
 }
 
-bool MutantEntry::operator==(const MutantEntry &rhs) const
+size_t StringPool::getSize() const
 {
-  return (token_.compare(rhs.getToken()) == 0 &&
-          mutated_token_.compare(rhs.getMutatedToken()) == 0);
+  return strings_.size();
 }
-
@@ -1,41 +1,59 @@
 #ifndef MUSIC_MUTANT_ENTRY_H_
-#define MUSIC_MUTANT_ENTRY_H_ 
+#define MUSIC_MUTANT_ENTRY_H_
 
+#include <cstdint>
 #include <string>
-#include <iostream>
-
-#include "clang/Basic/SourceLocation.h"
-#include "clang/Basic/SourceManager.h"
-
-class MutantEntry
+#include <unordered_map>
+#include <vector>
+
+/**
+  Distinct strings, each stored once and referred to by a 32-bit id.
+  Ids are given in order of first insertion, starting from 0.
+*/
+class StringPool
 {
 public:
-  clang::SourceManager &src_mgr_;
+  uint32_t Intern(const std::string &s);
 
-  MutantEntry(std::string token, std::string mutated_token,
-              clang::SourceLocation start_loc, clang::SourceLocation end_loc,
-              clang::SourceManager &src_mgr, int proteum_style_line_num);
+  // Return True and set id if s is in the pool.
+  bool Find(const std::string &s, uint32_t &id) const;
 
-  // getters
-  int getProteumStyleLineNum() const;
-  std::string getToken() const;
-  std::string getMutatedToken() const;
-  // only end location changes after mutation
-  clang::SourceLocation getStartLocation() const;
-  clang::SourceLocation getTokenEndLocation() const;
-  clang::SourceRange getTokenRange() const;
-  clang::SourceLocation getMutatedTokenEndLocation() const;
-  clang::SourceRange getMutatedTokenRange() const;
-
-  bool operator==(const MutantEntry &rhs) const;
+  const std::string& getString(uint32_t id) const;
+  size_t getSize() const;
 
 private:
-  int proteum_style_line_num_;
-  std::string token_;
-  std::string mutated_token_;
-  clang::SourceLocation start_location_;
-  clang::SourceLocation end_location_before_mutation_;
-  clang::SourceLocation end_location_after_mutation_;
+  // Keys of an unordered_map do not move on rehash, so strings_ can point
+  // to them.
+  std::unordered_map<std::string, uint32_t> ids_;
+  std::vector<const std::string*> strings_;
 };
 
-#endif  // MUSIC_MUTANT_ENTRY_H_
\ No newline at end of file
+/**
+  A mutant, as an edit of the main file: replace bytes
+  [start_offset_, end_offset_) with string mutated_token_id_.
+
+  Tokens are ids in the StringPool of the MutantDatabase holding the entry,
+  operator_id_ is the id of the mutation operator name in the same
+  database. Line and column numbers are resolved only when exported.
+
+  @param  start_offset_ byte offset of token (same before and after
+                        mutation)
+          end_offset_ byte offset of end of token before mutation
+          token_id_ token before mutation
+          mutated_token_id_ token after mutation
+          proteum_style_line_num_ line number in Proteum style
+          operator_id_ mutation operator
+*/
+struct MutantEntry
+{
+  uint32_t start_offset_;
+  uint32_t end_offset_;
+  uint32_t token_id_;
+  uint32_t mutated_token_id_;
+  int32_t proteum_style_line_num_;
+  uint16_t operator_id_;
+};
+
+static_assert(sizeof(MutantEntry) <= 24, "MutantEntry should stay compact");
+
+#endif  // MUSIC_MUTANT_ENTRY_H_
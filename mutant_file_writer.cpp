@@ -0,0 +1,134 @@
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include "mutant_file_writer.h"
+
+MutantFileWriter::MutantFileWriter(const char *original, size_t original_size,
+                                   unsigned num_threads, size_t max_pending)
+  : original_(original), original_size_(original_size),
+    max_pending_(max_pending > 0 ? max_pending : 1), finishing_(false)
+{
+  for (unsigned i = 0; i < num_threads; i++)
+    threads_.push_back(std::thread(&MutantFileWriter::RunWorker, this));
+}
+
+MutantFileWriter::~MutantFileWriter()
+{
+  Finish();
+}
+
+void MutantFileWriter::Write(const std::string &filename,
+                             uint32_t start_offset, uint32_t end_offset,
+                             const std::string &replacement)
+{
+  Job job{filename, start_offset, end_offset, replacement};
+
+  if (threads_.empty())
+  {
+    if (!WriteFile(job))
+      failed_filenames_.push_back(job.filename_);
+
+    return;
+  }
+
+  std::unique_lock<std::mutex> lock(mutex_);
+  job_taken_.wait(lock, [this]() { return jobs_.size() < max_pending_; });
+  jobs_.push_back(std::move(job));
+  job_added_.notify_one();
+}
+
+std::vector<std::string> MutantFileWriter::Finish()
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    finishing_ = true;
+  }
+
+  job_added_.notify_all();
+
+  for (auto &thread: threads_)
+    thread.join();
+
+  threads_.clear();
+
+  std::vector<std::string> failed_filenames;
+  failed_filenames.swap(failed_filenames_);
+  return failed_filenames;
+}
+
+void MutantFileWriter::RunWorker()
+{
+  std::unique_lock<std::mutex> lock(mutex_);
+
+  while (true)
+  {
+    job_added_.wait(lock, [this]() { return finishing_ || !jobs_.empty(); });
+
+    // Queued files are still written when finishing.
+    if (jobs_.empty())
+      return;
+
+    Job job{std::move(jobs_.front())};
+    jobs_.pop_front();
+    job_taken_.notify_one();
+
+    lock.unlock();
+    bool written = WriteFile(job);
+    lock.lock();
+
+    if (!written)
+      failed_filenames_.push_back(job.filename_);
+  }
+}
+
+bool MutantFileWriter::WriteFile(const Job &job)
+{
+  int fd = open(job.filename_.data(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+
+  if (fd < 0)
+    return false;
+
+  struct iovec parts[3];
+  parts[0].iov_base = const_cast<char*>(original_);
+  parts[0].iov_len = job.start_offset_;
+  parts[1].iov_base = const_cast<char*>(job.replacement_.data());
+  parts[1].iov_len = job.replacement_.size();
+  parts[2].iov_base = const_cast<char*>(original_ + job.end_offset_);
+  parts[2].iov_len = original_size_ - job.end_offset_;
+
+  struct iovec *part = parts;
+  int num_parts = 3;
+  bool written = true;
+
+  // writev may write less than asked, e.g. when interrupted.
+  while (num_parts > 0)
+  {
+    ssize_t size = writev(fd, part, num_parts);
+
+    if (size < 0)
+    {
+      if (errno == EINTR)
+        continue;
+
+      written = false;
+      break;
+    }
+
+    while (num_parts > 0 && static_cast<size_t>(size) >= part->iov_len)
+    {
+      size -= part->iov_len;
+      part++;
+      num_parts--;
+    }
+
+    if (num_parts > 0)
+    {
+      part->iov_base = static_cast<char*>(part->iov_base) + size;
+      part->iov_len -= size;
+    }
+  }
+
+  return close(fd) == 0 && written;
+}
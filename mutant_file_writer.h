@@ -0,0 +1,65 @@
+#ifndef MUSIC_MUTANT_FILE_WRITER_H_
+#define MUSIC_MUTANT_FILE_WRITER_H_
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+  Writer of full mutant files. A mutant file is the original file with
+  bytes [start_offset, end_offset) replaced, written with one writev of
+  prefix, replacement and suffix taken straight from the original buffer.
+
+  Files are written by a pool of threads so that disk I/O overlaps with
+  the rest of the export. At most max_pending files wait to be written:
+  Write blocks while the queue is full. Without threads, Write writes the
+  file itself.
+*/
+class MutantFileWriter
+{
+public:
+  // original must stay valid until Finish returns.
+  MutantFileWriter(const char *original, size_t original_size,
+                   unsigned num_threads, size_t max_pending);
+  ~MutantFileWriter();
+
+  void Write(const std::string &filename, uint32_t start_offset,
+             uint32_t end_offset, const std::string &replacement);
+
+  // Wait until all files are written. Return names of files that could
+  // not be written.
+  std::vector<std::string> Finish();
+
+private:
+  struct Job
+  {
+    std::string filename_;
+    uint32_t start_offset_;
+    uint32_t end_offset_;
+    std::string replacement_;
+  };
+
+  const char *original_;
+  size_t original_size_;
+  size_t max_pending_;
+
+  std::vector<std::thread> threads_;
+  std::mutex mutex_;
+  std::condition_variable job_added_;
+  std::condition_variable job_taken_;
+  std::deque<Job> jobs_;
+  bool finishing_;
+  std::vector<std::string> failed_filenames_;
+
+  void RunWorker();
+
+  // Return False if file could not be written.
+  bool WriteFile(const Job &job);
+};
+
+#endif  // MUSIC_MUTANT_FILE_WRITER_H_
@@ -0,0 +1,155 @@
+#include <algorithm>
+
+#include "mutant_sampler.h"
+
+namespace {
+
+// Held mutants are reduced once at least this many are held.
+const size_t kMinSelectSize = 4096;
+
+// FNV-1a
+uint64_t HashBytes(uint64_t hash, const char *data, size_t size)
+{
+  for (size_t i = 0; i < size; i++)
+  {
+    hash ^= static_cast<unsigned char>(data[i]);
+    hash *= 0x100000001b3ULL;
+  }
+
+  return hash;
+}
+
+// Final mix of splitmix64, so that close inputs give unrelated keys.
+uint64_t MixBits(uint64_t x)
+{
+  x ^= x >> 30;
+  x *= 0xbf58476d1ce4e5b9ULL;
+  x ^= x >> 27;
+  x *= 0x94d049bb133111ebULL;
+  x ^= x >> 31;
+  return x;
+}
+
+}  // namespace
+
+MutantSampler::MutantSampler(uint32_t limit, size_t budget)
+  : limit_(limit), budget_(budget), next_select_size_(kMinSelectSize)
+{
+  if (budget_ > 0)
+    next_select_size_ = std::max(next_select_size_, 2 * budget_);
+}
+
+bool MutantSampler::IsSampling() const
+{
+  return limit_ != UINT32_MAX || budget_ > 0;
+}
+
+bool MutantSampler::Offer(uint64_t key, uint64_t point)
+{
+  if (limit_ == UINT32_MAX)
+    return true;
+
+  std::vector<uint64_t> &keys = point_keys_[point];
+
+  if (keys.size() < limit_)
+  {
+    keys.push_back(key);
+    std::push_heap(keys.begin(), keys.end());
+    return true;
+  }
+
+  if (key >= keys.front())
+    return false;
+
+  // The mutant with the largest key so far is now left out.
+  std::pop_heap(keys.begin(), keys.end());
+  keys.back() = key;
+  std::push_heap(keys.begin(), keys.end());
+  return true;
+}
+
+bool MutantSampler::ShouldSelect(size_t num_candidates) const
+{
+  return IsSampling() && num_candidates >= next_select_size_;
+}
+
+bool MutantSampler::IsWithinLimit(uint64_t key, uint64_t point) const
+{
+  if (limit_ == UINT32_MAX)
+    return true;
+
+  auto it = point_keys_.find(point);
+
+  return it == point_keys_.end() || it->second.size() < limit_ ||
+         key <= it->second.front();
+}
+
+void MutantSampler::Select(const std::vector<Candidate> &candidates,
+                           std::vector<bool> &selected)
+{
+  std::vector<size_t> order;
+  selected.assign(candidates.size(), false);
+
+  for (size_t i = 0; i < candidates.size(); i++)
+    if (IsWithinLimit(candidates[i].key_, candidates[i].point_))
+      order.push_back(i);
+
+  if (budget_ > 0 && order.size() > budget_)
+  {
+    // Rank of each candidate in its stratum, by key.
+    std::sort(order.begin(), order.end(),
+              [&candidates](size_t i, size_t j)
+              {
+                return candidates[i].stratum_ < candidates[j].stratum_ ||
+                       (candidates[i].stratum_ == candidates[j].stratum_ &&
+                        candidates[i].key_ < candidates[j].key_);
+              });
+
+    std::vector<size_t> rank(candidates.size());
+
+    for (size_t k = 0; k < order.size(); k++)
+      rank[order[k]] = (k > 0 && candidates[order[k]].stratum_ ==
+                                 candidates[order[k - 1]].stratum_) ?
+                       rank[order[k - 1]] + 1 : 0;
+
+    // Take rank 0 of every stratum, then rank 1, ...
+    std::nth_element(order.begin(), order.begin() + budget_, order.end(),
+                     [&candidates, &rank](size_t i, size_t j)
+                     {
+                       return rank[i] < rank[j] ||
+                              (rank[i] == rank[j] &&
+                               candidates[i].key_ < candidates[j].key_);
+                     });
+    order.resize(budget_);
+  }
+
+  for (auto i: order)
+    selected[i] = true;
+
+  next_select_size_ = std::max(kMinSelectSize, 2 * order.size());
+
+  if (budget_ > 0)
+    next_select_size_ = std::max(next_select_size_, 2 * budget_);
+}
+
+uint64_t GetSampleKey(uint64_t seed, uint32_t offset,
+                      const std::string &operator_name,
+                      const std::string &token,
+                      const std::string &mutated_token)
+{
+  uint64_t hash = 0xcbf29ce484222325ULL ^ MixBits(seed);
+
+  hash = HashBytes(hash, reinterpret_cast<const char*>(&offset),
+                   sizeof(offset));
+
+  // Sizes keep the strings apart.
+  for (const std::string *s: {&operator_name, &token, &mutated_token})
+  {
+    uint64_t size = s->size();
+    hash = HashBytes(hash, reinterpret_cast<const char*>(&size),
+                     sizeof(size));
+    hash = HashBytes(hash, s->data(), s->size());
+  }
+
+  return MixBits(hash);
+}
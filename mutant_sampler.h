@@ -0,0 +1,85 @@
+#ifndef MUSIC_MUTANT_SAMPLER_H_
+#define MUSIC_MUTANT_SAMPLER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+  Seeded selection of mutants among those generated for a file, done while
+  they are generated so that only mutants that can still be selected are
+  kept (options -l, -seed, -budget and -stratify).
+
+  Each mutant gets a pseudo-random key from the seed and what the mutant
+  is (GetSampleKey), so the same file and seed always give the same
+  mutants, in whatever order they are generated. A mutant is selected if
+
+  - its key is one of the limit smallest of its mutation point, and
+  - with a budget, it is one of the budget first mutants taken in turn
+    from each stratum, smallest key first (same share for every stratum,
+    strata with fewer mutants give their share to the others).
+
+  A mutant left out once is never selected later: more mutants only bring
+  smaller keys into a stratum, since a mutation point lies in one stratum.
+*/
+class MutantSampler
+{
+public:
+  /**
+    @param  key_ key of mutant, from GetSampleKey
+            point_ mutation point of mutant (start offset and operator)
+            stratum_ stratum of mutant, 0 without stratification
+  */
+  struct Candidate
+  {
+    uint64_t key_;
+    uint64_t point_;
+    uint64_t stratum_;
+  };
+
+  // limit UINT32_MAX and budget 0 mean no limit and no budget.
+  MutantSampler(uint32_t limit, size_t budget);
+
+  // Return True if mutants are limited per mutation point or budgeted.
+  bool IsSampling() const;
+
+  /**
+    Record a new mutant with key at mutation point.
+
+    @return False if the mutant can never be selected
+  */
+  bool Offer(uint64_t key, uint64_t point);
+
+  // Return True if num_candidates mutants are held, enough to drop those
+  // that cannot be selected.
+  bool ShouldSelect(size_t num_candidates) const;
+
+  /**
+    Set selected[i] if candidates[i] is selected among candidates. Every
+    mutant offered and not left out since must be in candidates.
+  */
+  void Select(const std::vector<Candidate> &candidates,
+              std::vector<bool> &selected);
+
+private:
+  uint32_t limit_;
+  size_t budget_;
+  size_t next_select_size_;
+
+  // Max-heap of the limit smallest keys offered at each mutation point,
+  // including those of mutants left out by the budget since.
+  std::unordered_map<uint64_t, std::vector<uint64_t>> point_keys_;
+
+  // Return True if key is one of the limit smallest of point.
+  bool IsWithinLimit(uint64_t key, uint64_t point) const;
+};
+
+// Key of mutant replacing token at offset with mutated_token, under seed.
+uint64_t GetSampleKey(uint64_t seed, uint32_t offset,
+                      const std::string &operator_name,
+                      const std::string &token,
+                      const std::string &mutated_token);
+
+#endif  // MUSIC_MUTANT_SAMPLER_H_
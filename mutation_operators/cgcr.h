@@ -7,9 +7,7 @@ class CGCR : public ExprMutantOperator
 {
 public:
 	CGCR(const std::string name = "CGCR")
-		: ExprMutantOperator(name), choose_max_(false), 
-		choose_min_(false), choose_median_(false), 
-		close_less_(false), close_more_(false)
+		: ExprMutantOperator(name)
 	{}
 
 	virtual bool ValidateDomain(const std::set<std::string> &domain);
@@ -17,17 +15,18 @@ public:
 
 	virtual void setRange(std::set<std::string> &range);
 
+	virtual void GetTargetKinds(
+			std::vector<StmtClassRange> &classes,
+			std::vector<clang::BinaryOperatorKind> &opcodes) const;
+
 	// Return True if the mutant operator can mutate this expression
 	virtual bool IsMutationTarget(clang::Expr *e, MusicContext *context);
 
 	virtual void Mutate(clang::Expr *e, MusicContext *context);
 
 private:
-	bool choose_max_;
-	bool choose_min_;
-	bool choose_median_;
-	bool close_less_;
-	bool close_more_;
+	// MAX, MIN, MEDIAN, CLOSE_LESS and CLOSE_MORE of the range
+	ConstantSelectors selectors_;
 
 	bool IsDuplicateCaseLabel(string new_label, 
 														SwitchStmtInfoList *switchstmt_list);
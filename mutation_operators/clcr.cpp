@@ -5,37 +5,7 @@
 
 void CLCR::setRange(std::set<std::string> &range)
 {
-  for (auto it = range.begin(); it != range.end(); )
-  {
-    if (it->compare("MAX") == 0)
-    {
-      choose_max_ = true;
-      it = range.erase(it);
-    }
-    else if (it->compare("MIN") == 0)
-    {
-      choose_min_ = true;
-      it = range.erase(it);
-    }
-    else if (it->compare("MEDIAN") == 0)
-    {
-      choose_median_ = true;
-      it = range.erase(it);
-    }
-    else if (it->compare("CLOSE_LESS") == 0)
-    {
-      close_less_ = true;
-      it = range.erase(it);
-    }
-    else if (it->compare("CLOSE_MORE") == 0)
-    {
-      close_more_ = true;
-      it = range.erase(it);
-    }
-    else
-      ++it;
-  }
-
+  selectors_.TakeFromRange(range);
   range_ = range;
 }
 
@@ -49,43 +19,54 @@ bool CLCR::ValidateRange(const std::set<std::string> &range)
 	return true;
 }
 
+void CLCR::GetTargetKinds(
+		vector<StmtClassRange> &classes,
+		vector<BinaryOperatorKind> &opcodes) const
+{
+	classes.push_back(Stmt::CharacterLiteralClass);
+	classes.push_back(Stmt::FloatingLiteralClass);
+	classes.push_back(Stmt::IntegerLiteralClass);
+}
+
 // Return True if the mutant operator can mutate this expression
 bool CLCR::IsMutationTarget(clang::Expr *e, MusicContext *context)
 {
+	ExprAnalysis &analysis = context->getExprAnalysis(e);
+
 	if (!isa<CharacterLiteral>(e) && !isa<FloatingLiteral>(e) &&
 			!isa<IntegerLiteral>(e))
 		return false;
 
 	SourceLocation start_loc = e->getLocStart();
-	SourceLocation end_loc = GetEndLocOfExpr(e, context->comp_inst_);
+	SourceLocation end_loc = analysis.getEndLoc();
 	StmtContext &stmt_context = context->getStmtContext();
 
   SourceManager &src_mgr = context->comp_inst_->getSourceManager();
-  Rewriter rewriter;
-  rewriter.setSourceMgr(src_mgr, context->comp_inst_->getLangOpts());
 
-  string token{ConvertToString(e, context->comp_inst_->getLangOpts())};
+  string token{analysis.getToken()};
   bool is_in_domain = domain_.empty() ? true : 
                       IsStringElementOfSet(token, domain_);
 
 	// CLCR can mutate this constant literal if it is in mutation range,
 	// outside array decl range, outside enum decl range, outside
 	// field decl range and inside a function (local range)
-	return context->IsRangeInMutationRange(SourceRange(start_loc, end_loc)) &&
+	return analysis.IsInMutationRange() &&
 				 !stmt_context.IsInEnumDecl() &&
 				 !stmt_context.IsInArrayDeclSize() &&
-				 !stmt_context.IsInFieldDeclRange(e) && is_in_domain &&
-				 stmt_context.IsInCurrentlyParsedFunctionRange(e);
+				 !analysis.IsInFieldDeclRange() && is_in_domain &&
+				 analysis.IsInCurrentlyParsedFunctionRange();
 }
 
 void CLCR::Mutate(clang::Expr *e, MusicContext *context)
 {
+	ExprAnalysis &analysis = context->getExprAnalysis(e);
+
 	SourceLocation start_loc = e->getLocStart();
-	SourceLocation end_loc = GetEndLocOfExpr(e, context->comp_inst_);
+	SourceLocation end_loc = analysis.getEndLoc();
 
 	SourceManager &src_mgr = context->comp_inst_->getSourceManager();
 
-	string token{ConvertToString(e, context->comp_inst_->getLangOpts())};
+	string token{analysis.getToken()};
 
   vector<string> range;
 
@@ -113,8 +94,6 @@ bool CLCR::IsDuplicateCaseLabel(
 	return false;
 }
 
-bool CLCRSortFunction (long long i,long long j) { return (i<j); }
-
 // Do not mutate constants to floating type in this case
 // (ptr_cast) <target_constant>
 bool IsTargetOfConversionToPointer(Expr *e, MusicContext *context)
@@ -137,122 +116,65 @@ bool IsTargetOfConversionToPointer(Expr *e, MusicContext *context)
 void CLCR::GetRange(
     Expr *e, MusicContext *context, vector<string> *range)
 {
-  string token{ConvertToString(e, context->comp_inst_->getLangOpts())};
+  ExprAnalysis &analysis = context->getExprAnalysis(e);
 
-  // if token is char, then convert to int string for later comparison
-  // to avoid mutating to same value constant.
-  string int_string{ConvertToString(e, context->comp_inst_->getLangOpts())};
+  string token{analysis.getToken()};
 
-  if (int_string.front() == '\'' && int_string.back() == '\'')
-    int_string = ConvertCharStringToIntString(int_string);
+  // if token is char or hex, then convert to int string for later
+  // comparison to avoid mutating to same value constant.
+  string value{GetNormalizedLiteralValue(e, token)};
 
   // cannot mutate the variable in switch condition, case value, 
   // array subscript to a floating-type variable because
   // these location requires integral value.
   StmtContext &stmt_context = context->getStmtContext();
-  bool skip_float_literal = stmt_context.IsInArraySubscriptRange(e) ||
-                            stmt_context.IsInSwitchStmtConditionRange(e) ||
-                            stmt_context.IsInSwitchCaseRange(e) ||
+  bool skip_float_literal = analysis.IsInArraySubscriptRange() ||
+                            analysis.IsInSwitchStmtConditionRange() ||
+                            analysis.IsInSwitchCaseRange() ||
                             IsTargetOfConversionToPointer(e, context) ||
-                            stmt_context.IsInNonFloatingExprRange(e);
-
-  ExprList local_consts(
-      (*(context->getSymbolTable()->getLocalScalarConstantList()))[context->getFunctionId()]);
-
-  for (auto it = local_consts.begin(); it != local_consts.end(); ++it)
+                            analysis.IsInNonFloatingExprRange();
+
+  LiteralPool &pool = (*(context->getSymbolTable()->getLocalScalarConstantList()))[context->getFunctionId()];
+
+  // Mitigate mutation from causing duplicate-case-label error.
+  // If this constant is in range of a case label
+  // then check if the replacing token is same with any other label.
+  // Then keep only constants inside user-specified range, if any.
+  // char literals are replaced with their int value.
+  auto is_candidate = [&](const Literal &literal) -> bool {
+    if (analysis.IsInSwitchCaseRange() &&
+        IsDuplicateCaseLabel(literal.token_, context->switchstmt_info_list_))
+      return false;
+
+    return range_.empty() || range_.count(literal.token_) > 0 ||
+           range_.count(literal.spelling_) > 0;
+  };
+
+  // If user specify predefined values MAX, MIN, MEDIAN, CLOSE_LESS,
+  // CLOSE_MORE, binary search them among the constants sorted by value.
+  if (!selectors_.IsEmpty())
   {
-    if (skip_float_literal && ExprIsFloat(*it))
-      continue;
-
-    string mutated_token{
-        ConvertToString(*it, context->comp_inst_->getLangOpts())};
-    string orig_mutated_token{
-        ConvertToString(*it, context->comp_inst_->getLangOpts())};
+    LiteralPool::LiteralFilter filter;
 
-    if (mutated_token.front() == '\'' && mutated_token.back() == '\'')
-      mutated_token = ConvertCharStringToIntString(mutated_token);
-
-    if (int_string.compare(mutated_token) == 0)
-      continue;
-
-    // Mitigate mutation from causing duplicate-case-label error.
-    // If this constant is in range of a case label
-    // then check if the replacing token is same with any other label.
-    if (stmt_context.IsInSwitchCaseRange(e) &&
-        IsDuplicateCaseLabel(mutated_token, context->switchstmt_info_list_))
-      continue;
-
-    // If user did not specify range or this mutated token
-    // is inside user-specified range, then add it to list 
-    // of mutated tokens RANGE for this location
-    if (range_.empty() || range_.find(mutated_token) != range_.end() ||
-        range_.find(orig_mutated_token) != range_.end())
-      range->push_back(mutated_token);
-  }
+    if (analysis.IsInSwitchCaseRange() || !range_.empty())
+      filter = is_candidate;
 
-  if (range->empty())
+    pool.SelectConstants(selectors_, value, skip_float_literal, filter,
+                         range);
     return;
-
-  if (!(choose_max_ || choose_min_ || choose_median_ ||
-        close_less_ || close_more_))
-    return;
-
-  // Check if user specify predefined values MAX, MIN, MEDIAN, 
-  // CLOSE_LESS, CLOSE_MORE.
-
-  // Convert the strings to long long.
-  // Ignore those that cannot be converted.
-  vector<long long> range_values;
-  for (auto num: *range)
-  {
-    long long val;
-    try 
-    {
-      val = stoll(num);
-    }
-    catch(...) { continue; }
-
-    range_values.push_back(val);
-  }
-
-  sort(range_values.begin(), range_values.end(), CLCRSortFunction);
-  range->clear();
-
-  if (choose_max_)
-    range->push_back(to_string(range_values.back()));
-
-  if (choose_min_)
-    range->push_back(to_string(range_values.front()));
-
-  if (choose_median_)
-    range->push_back(to_string(range_values[range_values.size()/2]));
-
-  long long token_value;
-  try
-  {
-    token_value = stoll(int_string);
   }
-  catch(...) { return; }
 
-  // If user wants the closest but less than original value,
-  // original value must be higher than at least 1 of the mutated token.
-  if (close_less_ && token_value > range_values[0])
+  for (auto &literal: pool)
   {
-    int i = 1;
-    for (; i < range_values.size(); i++)
-      if (range_values[i] > token_value)
-        break;
-
-    range->push_back(to_string(range_values[i-1]));
-  }
+    if (skip_float_literal && literal.is_floating_)
+      continue;
 
-  if (close_more_ && token_value < range_values.back())
-  {
-    int i = range_values.size() - 2;
-    for (; i >= 0; i--)
-      if (range_values[i] < token_value)
-        break;
+    // Avoid mutating to the same scalar constant
+    // If token is char or hex, then compare their int values
+    if (value.compare(literal.value_) == 0)
+      continue;
 
-    range->push_back(to_string(range_values[i+1]));
+    if (is_candidate(literal))
+      range->push_back(literal.token_);
   }
-}
\ No newline at end of file
+}
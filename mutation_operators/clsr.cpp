@@ -17,21 +17,28 @@ bool CLSR::ValidateRange(const std::set<std::string> &range)
 	return true;
 }
 
+void CLSR::GetTargetKinds(
+		vector<StmtClassRange> &classes,
+		vector<BinaryOperatorKind> &opcodes) const
+{
+	classes.push_back(Stmt::DeclRefExprClass);
+}
+
 // Return True if the mutant operator can mutate this expression
 bool CLSR::IsMutationTarget(clang::Expr *e, MusicContext *context)
 {
-	if (!ExprIsDeclRefExpr(e) || !ExprIsScalar(e))
+	ExprAnalysis &analysis = context->getExprAnalysis(e);
+
+	if (!ExprIsDeclRefExpr(e) || !analysis.IsScalar())
 		return false;
 
 	SourceLocation start_loc = e->getLocStart();
-	SourceLocation end_loc = GetEndLocOfExpr(e, context->comp_inst_);
+	SourceLocation end_loc = analysis.getEndLoc();
 	StmtContext &stmt_context = context->getStmtContext();
 
   SourceManager &src_mgr = context->comp_inst_->getSourceManager();
-  Rewriter rewriter;
-  rewriter.setSourceMgr(src_mgr, context->comp_inst_->getLangOpts());
 
-  string token{ConvertToString(e, context->comp_inst_->getLangOpts())};
+  string token{analysis.getToken()};
   bool is_in_domain = domain_.empty() ? true : 
                       IsStringElementOfSet(token, domain_);
 
@@ -40,52 +47,45 @@ bool CLSR::IsMutationTarget(clang::Expr *e, MusicContext *context)
 	// (vulnerable to different uncompilable cases) and outside 
 	// lhs of assignment, unary increment/decrement/addressop (these
 	// cannot take constant literal as their target)
-	return context->IsRangeInMutationRange(SourceRange(start_loc, end_loc)) &&
+	return analysis.IsInMutationRange() &&
 				 !stmt_context.IsInEnumDecl() &&
 				 !stmt_context.IsInArrayDeclSize() &&
-				 !stmt_context.IsInLhsOfAssignmentRange(e) &&
-				 !stmt_context.IsInUnaryIncrementDecrementRange(e) &&
-				 !stmt_context.IsInAddressOpRange(e) &&
-				 stmt_context.IsInCurrentlyParsedFunctionRange(e) &&
+				 !analysis.IsInLhsOfAssignmentRange() &&
+				 !analysis.IsInUnaryIncrementDecrementRange() &&
+				 !analysis.IsInAddressOpRange() &&
+				 analysis.IsInCurrentlyParsedFunctionRange() &&
          is_in_domain;
 }
 
 void CLSR::Mutate(clang::Expr *e, MusicContext *context)
 {
+	ExprAnalysis &analysis = context->getExprAnalysis(e);
+
 	SourceLocation start_loc = e->getLocStart();
-	SourceLocation end_loc = GetEndLocOfExpr(e, context->comp_inst_);
+	SourceLocation end_loc = analysis.getEndLoc();
 
 	SourceManager &src_mgr = context->comp_inst_->getSourceManager();
-	Rewriter rewriter;
-	rewriter.setSourceMgr(src_mgr, context->comp_inst_->getLangOpts());
 
-	string token{ConvertToString(e, context->comp_inst_->getLangOpts())};
+	string token{analysis.getToken()};
 
 	// cannot mutate the variable in switch condition or 
   // array subscript to a floating-type variable
   StmtContext &stmt_context = context->getStmtContext();
-  bool skip_float_literal = stmt_context.IsInArraySubscriptRange(e) ||
-                            stmt_context.IsInSwitchStmtConditionRange(e) ||
-                            stmt_context.IsInSwitchCaseRange(e) ||
-                            stmt_context.IsInNonFloatingExprRange(e);
+  bool skip_float_literal = analysis.IsInArraySubscriptRange() ||
+                            analysis.IsInSwitchStmtConditionRange() ||
+                            analysis.IsInSwitchCaseRange() ||
+                            analysis.IsInNonFloatingExprRange();
 
-  for (auto it: (*(context->getSymbolTable()->getLocalScalarConstantList()))[context->getFunctionId()])
+  for (auto &literal: (*(context->getSymbolTable()->getLocalScalarConstantList()))[context->getFunctionId()])
   {
-    string mutated_token{
-        ConvertToString(it, context->comp_inst_->getLangOpts())};
-
-    if (!range_.empty() && !IsStringElementOfSet(mutated_token, range_))
+    if (!range_.empty() && range_.count(literal.spelling_) == 0)
       continue;
 
-  	if (skip_float_literal && ExprIsFloat(it))
+  	if (skip_float_literal && literal.is_floating_)
       continue;
 
-    if (mutated_token.front() == '\'' && mutated_token.back() == '\'')
-    	mutated_token = ConvertCharStringToIntString(mutated_token);
-
-
     context->mutant_database_.AddMutantEntry(
-        name_, start_loc, end_loc, token, mutated_token, 
+        name_, start_loc, end_loc, token, literal.token_, 
         context->getStmtContext().getProteumStyleLineNum());
   }
 }
\ No newline at end of file
@@ -28,36 +28,45 @@ void CRCR::setRange(std::set<std::string> &range)
 }
 
 
+void CRCR::GetTargetKinds(
+		vector<StmtClassRange> &classes,
+		vector<BinaryOperatorKind> &opcodes) const
+{
+	GetReferenceTargetKinds(classes);
+}
+
 // Return True if the mutant operator can mutate this expression
 bool CRCR::IsMutationTarget(clang::Expr *e, MusicContext *context)
 {
+	ExprAnalysis &analysis = context->getExprAnalysis(e);
+
 	if (!ExprIsScalarReference(e))
 		return false;
 
 	SourceLocation start_loc = e->getLocStart();
-	SourceLocation end_loc = GetEndLocOfExpr(e, context->comp_inst_);
+	SourceLocation end_loc = analysis.getEndLoc();
 
 	StmtContext &stmt_context = context->getStmtContext();
 
-	return context->IsRangeInMutationRange(SourceRange(start_loc, end_loc)) &&
+	return analysis.IsInMutationRange() &&
 				 !stmt_context.IsInEnumDecl() &&
 				 !stmt_context.IsInArrayDeclSize() &&
-				 !stmt_context.IsInLhsOfAssignmentRange(e) &&
-				 !stmt_context.IsInAddressOpRange(e) &&
-				 !stmt_context.IsInUnaryIncrementDecrementRange(e);
+				 !analysis.IsInLhsOfAssignmentRange() &&
+				 !analysis.IsInAddressOpRange() &&
+				 !analysis.IsInUnaryIncrementDecrementRange();
 }
 
 void CRCR::Mutate(clang::Expr *e, MusicContext *context)
 {
-	Rewriter rewriter;
+	ExprAnalysis &analysis = context->getExprAnalysis(e);
+
 	SourceManager &src_mgr = context->comp_inst_->getSourceManager();
-	rewriter.setSourceMgr(src_mgr, context->comp_inst_->getLangOpts());
 
-	string token{ConvertToString(e, context->comp_inst_->getLangOpts())};
+	string token{analysis.getToken()};
 	SourceLocation start_loc = e->getLocStart();
-	SourceLocation end_loc = GetEndLocOfExpr(e, context->comp_inst_);
+	SourceLocation end_loc = analysis.getEndLoc();
 
-	if (ExprIsIntegral(context->comp_inst_, e))
+	if (analysis.IsIntegral())
 	{
 		for (auto num: range_integral_)
 		{
@@ -77,7 +86,7 @@ void CRCR::Mutate(clang::Expr *e, MusicContext *context)
 		return;
 	}
 
-	if (ExprIsFloat(e))
+	if (analysis.IsFloating())
 	{
 		for (auto num: range_float_)
 		{
@@ -13,10 +13,48 @@ public:
 	virtual bool ValidateDomain(const std::set<std::string> &domain) = 0;
 	virtual bool ValidateRange(const std::set<std::string> &range) = 0;
 
+	/**
+		Add to classes the Stmt classes of the expressions this operator can
+		mutate and to opcodes the binary operators it can mutate. IsMutationTarget
+		is only called for such expressions. Adding no class means any
+		expression, adding no opcode means any binary operator.
+	*/
+	virtual void GetTargetKinds(
+			std::vector<StmtClassRange> &classes,
+			std::vector<clang::BinaryOperatorKind> &opcodes) const
+	{}
+
 	// Return True if the mutant operator can mutate this expression
 	virtual bool IsMutationTarget(clang::Expr *e, MusicContext *context) = 0;
 
 	virtual void Mutate(clang::Expr *e, MusicContext *context) = 0;
+
+protected:
+	// Target binary operators whose spelling is in domain_.
+	void GetBinaryOperatorTargetKinds(
+			std::vector<StmtClassRange> &classes,
+			std::vector<clang::BinaryOperatorKind> &opcodes) const
+	{
+		classes.push_back(StmtClassRange(clang::Stmt::firstBinaryOperatorConstant,
+																		 clang::Stmt::lastBinaryOperatorConstant));
+
+		for (int opcode = clang::BO_PtrMemD; opcode <= clang::BO_Comma; opcode++)
+		{
+			auto kind = static_cast<clang::BinaryOperatorKind>(opcode);
+
+			if (domain_.count(clang::BinaryOperator::getOpcodeStr(kind).str()) > 0)
+				opcodes.push_back(kind);
+		}
+	}
+
+	// Target expressions that ExprIs*Reference functions can accept.
+	void GetReferenceTargetKinds(std::vector<StmtClassRange> &classes) const
+	{
+		classes.push_back(clang::Stmt::DeclRefExprClass);
+		classes.push_back(clang::Stmt::UnaryOperatorClass);
+		classes.push_back(clang::Stmt::ArraySubscriptExprClass);
+		classes.push_back(clang::Stmt::MemberExprClass);
+	}
 };
 
 #endif	// MUSIC_EXPR_MUTANT_OPERATOR_H_
\ No newline at end of file
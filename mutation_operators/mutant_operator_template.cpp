@@ -13,6 +13,11 @@ void MutantOperatorTemplate::setRange(set<string> &range)
   range_ = range;
 }
 
+string MutantOperatorTemplate::getName() const
+{
+  return name_;
+}
+
 /*void MutantOperatorTemplate::GenerateMutantFile(
 	MusicContext *context, const SourceLocation &start_loc,
 	const SourceLocation &end_loc, const string &mutated_token)
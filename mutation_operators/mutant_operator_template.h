@@ -3,6 +3,7 @@
 
 #include <string>
 #include <set>
+#include <vector>
 
 #include "clang/AST/Stmt.h"
 #include "clang/AST/Expr.h"
@@ -25,6 +26,22 @@
 
 #include "../music_context.h"
 
+// Stmt classes from first_ to last_, e.g. a class and all classes derived
+// from it (Stmt::firstCallExprConstant to Stmt::lastCallExprConstant).
+struct StmtClassRange
+{
+	StmtClassRange(clang::Stmt::StmtClass stmt_class)
+		: first_(stmt_class), last_(stmt_class)
+	{}
+
+	StmtClassRange(clang::Stmt::StmtClass first, clang::Stmt::StmtClass last)
+		: first_(first), last_(last)
+	{}
+
+	clang::Stmt::StmtClass first_;
+	clang::Stmt::StmtClass last_;
+};
+
 class MutantOperatorTemplate
 {
 protected:
@@ -38,11 +55,15 @@ public:
 		: num_of_generated_mutants_(0), name_(name)
 	{}
 
+	virtual ~MutantOperatorTemplate() {}
+
 	virtual bool ValidateDomain(const std::set<std::string> &domain) = 0;
 	virtual bool ValidateRange(const std::set<std::string> &range) = 0;
 
 	virtual void setDomain(std::set<std::string> &domain);
   virtual void setRange(std::set<std::string> &range);
+
+	std::string getName() const;
 	
 protected:
 	/*void GenerateMutantFile(MusicContext *context, 
@@ -39,6 +39,13 @@ void OAAA::setRange(std::set<std::string> &range)
 		range_ = range;
 }
 
+void OAAA::GetTargetKinds(
+		vector<StmtClassRange> &classes,
+		vector<BinaryOperatorKind> &opcodes) const
+{
+	GetBinaryOperatorTargetKinds(classes, opcodes);
+}
+
 bool OAAA::IsMutationTarget(clang::Expr *e, MusicContext *context)
 {
 	if (BinaryOperator *bo = dyn_cast<BinaryOperator>(e))
@@ -39,8 +39,17 @@ void OAAN::setRange(std::set<std::string> &range)
 		range_ = range;
 }
 
+void OAAN::GetTargetKinds(
+		vector<StmtClassRange> &classes,
+		vector<BinaryOperatorKind> &opcodes) const
+{
+	GetBinaryOperatorTargetKinds(classes, opcodes);
+}
+
 bool OAAN::IsMutationTarget(clang::Expr *e, MusicContext *context)
 {
+	ExprAnalysis &analysis = context->getExprAnalysis(e);
+
 	if (BinaryOperator *bo = dyn_cast<BinaryOperator>(e))
 	{
 		string binary_operator{bo->getOpcodeStr()};
@@ -59,7 +68,7 @@ bool OAAN::IsMutationTarget(clang::Expr *e, MusicContext *context)
 		if (!context->IsRangeInMutationRange(SourceRange(start_loc, end_loc)) ||
 				stmt_context.IsInArrayDeclSize() ||
 				stmt_context.IsInEnumDecl() ||
-				stmt_context.IsInTypedefRange(e) ||
+				analysis.IsInTypedefRange() ||
 				domain_.find(binary_operator) == domain_.end())
 			return false;
 
@@ -86,9 +95,6 @@ void OAAN::Mutate(clang::Expr *e, MusicContext *context)
 			GetLineNumber(src_mgr, start_loc),
 			GetColumnNumber(src_mgr, start_loc) + token.length());
 
-	Rewriter rewriter;
-	rewriter.setSourceMgr(src_mgr, context->comp_inst_->getLangOpts());
-
 	for (auto mutated_token: range_)
 	{
 		if (token.compare(mutated_token) == 0)
@@ -40,6 +40,13 @@ void OABA::setRange(std::set<std::string> &range)
 		range_ = range;
 }
 
+void OABA::GetTargetKinds(
+		vector<StmtClassRange> &classes,
+		vector<BinaryOperatorKind> &opcodes) const
+{
+	GetBinaryOperatorTargetKinds(classes, opcodes);
+}
+
 bool OABA::IsMutationTarget(clang::Expr *e, MusicContext *context)
 {
 	if (BinaryOperator *bo = dyn_cast<BinaryOperator>(e))
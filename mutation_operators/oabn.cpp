@@ -40,8 +40,17 @@ void OABN::setRange(std::set<std::string> &range)
 		range_ = range;
 }
 
+void OABN::GetTargetKinds(
+		vector<StmtClassRange> &classes,
+		vector<BinaryOperatorKind> &opcodes) const
+{
+	GetBinaryOperatorTargetKinds(classes, opcodes);
+}
+
 bool OABN::IsMutationTarget(clang::Expr *e, MusicContext *context)
 {
+	ExprAnalysis &analysis = context->getExprAnalysis(e);
+
 	// cout << name_ << " is mutating\n";
 	
 	if (BinaryOperator *bo = dyn_cast<BinaryOperator>(e))
@@ -62,7 +71,7 @@ bool OABN::IsMutationTarget(clang::Expr *e, MusicContext *context)
 		if (!context->IsRangeInMutationRange(SourceRange(start_loc, end_loc)) ||
 				stmt_context.IsInArrayDeclSize() ||
 				stmt_context.IsInEnumDecl() ||
-				stmt_context.IsInTypedefRange(e) ||
+				analysis.IsInTypedefRange() ||
 				domain_.find(binary_operator) == domain_.end())
 			return false;
 
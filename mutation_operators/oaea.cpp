@@ -40,6 +40,13 @@ void OAEA::setRange(std::set<std::string> &range)
 		range_ = range;
 }
 
+void OAEA::GetTargetKinds(
+		vector<StmtClassRange> &classes,
+		vector<BinaryOperatorKind> &opcodes) const
+{
+	GetBinaryOperatorTargetKinds(classes, opcodes);
+}
+
 bool OAEA::IsMutationTarget(clang::Expr *e, MusicContext *context)
 {
 	if (BinaryOperator *bo = dyn_cast<BinaryOperator>(e))
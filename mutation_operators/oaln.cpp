@@ -40,8 +40,17 @@ void OALN::setRange(std::set<std::string> &range)
 		range_ = range;
 }
 
+void OALN::GetTargetKinds(
+		vector<StmtClassRange> &classes,
+		vector<BinaryOperatorKind> &opcodes) const
+{
+	GetBinaryOperatorTargetKinds(classes, opcodes);
+}
+
 bool OALN::IsMutationTarget(clang::Expr *e, MusicContext *context)
 {
+	ExprAnalysis &analysis = context->getExprAnalysis(e);
+
 	// cout << name_ << " is mutating\n";
 	
 	if (BinaryOperator *bo = dyn_cast<BinaryOperator>(e))
@@ -62,7 +71,7 @@ bool OALN::IsMutationTarget(clang::Expr *e, MusicContext *context)
 		if (!context->IsRangeInMutationRange(SourceRange(start_loc, end_loc)) ||
 				stmt_context.IsInArrayDeclSize() ||
 				stmt_context.IsInEnumDecl() ||
-				stmt_context.IsInTypedefRange(e) ||
+				analysis.IsInTypedefRange() ||
 				domain_.find(binary_operator) == domain_.end())
 			return false;
 
@@ -77,6 +86,8 @@ bool OALN::IsMutationTarget(clang::Expr *e, MusicContext *context)
 
 void OALN::Mutate(clang::Expr *e, MusicContext *context)
 {
+	ExprAnalysis &analysis = context->getExprAnalysis(e);
+
 	BinaryOperator *bo;
 	if (!(bo = dyn_cast<BinaryOperator>(e)))
 		return;
@@ -92,9 +103,7 @@ void OALN::Mutate(clang::Expr *e, MusicContext *context)
 			GetColumnNumber(src_mgr, start_loc) + token.length());
 
 	SourceLocation start_of_expr = e->getLocStart();
-	SourceLocation end_of_expr = GetEndLocOfExpr(e, context->comp_inst_);
-	Rewriter rewriter;
-	rewriter.setSourceMgr(src_mgr, context->comp_inst_->getLangOpts());
+	SourceLocation end_of_expr = analysis.getEndLoc();
 	string lhs = ConvertToString(bo->getLHS(), context->comp_inst_->getLangOpts());
 	string rhs = ConvertToString(bo->getRHS(), context->comp_inst_->getLangOpts());
 
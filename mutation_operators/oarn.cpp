@@ -40,8 +40,17 @@ void OARN::setRange(std::set<std::string> &range)
 		range_ = range;
 }
 
+void OARN::GetTargetKinds(
+		vector<StmtClassRange> &classes,
+		vector<BinaryOperatorKind> &opcodes) const
+{
+	GetBinaryOperatorTargetKinds(classes, opcodes);
+}
+
 bool OARN::IsMutationTarget(clang::Expr *e, MusicContext *context)
 {
+	ExprAnalysis &analysis = context->getExprAnalysis(e);
+
 	// cout << name_ << " is mutating\n";
 	
 	if (BinaryOperator *bo = dyn_cast<BinaryOperator>(e))
@@ -62,7 +71,7 @@ bool OARN::IsMutationTarget(clang::Expr *e, MusicContext *context)
 		if (!context->IsRangeInMutationRange(SourceRange(start_loc, end_loc)) ||
 				stmt_context.IsInArrayDeclSize() ||
 				stmt_context.IsInEnumDecl() ||
-				stmt_context.IsInTypedefRange(e) ||
+				analysis.IsInTypedefRange() ||
 				domain_.find(binary_operator) == domain_.end())
 			return false;
 
@@ -79,6 +88,8 @@ bool OARN::IsMutationTarget(clang::Expr *e, MusicContext *context)
 
 void OARN::Mutate(clang::Expr *e, MusicContext *context)
 {
+	ExprAnalysis &analysis = context->getExprAnalysis(e);
+
 	BinaryOperator *bo;
 	if (!(bo = dyn_cast<BinaryOperator>(e)))
 		return;
@@ -94,9 +105,7 @@ void OARN::Mutate(clang::Expr *e, MusicContext *context)
 			GetColumnNumber(src_mgr, start_loc) + token.length());
 
 	SourceLocation start_of_expr = e->getLocStart();
-	SourceLocation end_of_expr = GetEndLocOfExpr(e, context->comp_inst_);
-	Rewriter rewriter;
-	rewriter.setSourceMgr(src_mgr, context->comp_inst_->getLangOpts());
+	SourceLocation end_of_expr = analysis.getEndLoc();
 	string lhs = ConvertToString(bo->getLHS(), context->comp_inst_->getLangOpts());
 	string rhs = ConvertToString(bo->getRHS(), context->comp_inst_->getLangOpts());
 
@@ -11,18 +11,31 @@ bool OBNG::ValidateRange(const std::set<std::string> &range)
 	return true;
 }
 
+void OBNG::GetTargetKinds(
+		vector<StmtClassRange> &classes,
+		vector<BinaryOperatorKind> &opcodes) const
+{
+	classes.push_back(StmtClassRange(Stmt::firstBinaryOperatorConstant,
+	                                 Stmt::lastBinaryOperatorConstant));
+	opcodes.push_back(BO_And);
+	opcodes.push_back(BO_Xor);
+	opcodes.push_back(BO_Or);
+}
+
 // Return True if the mutant operator can mutate this expression
 bool OBNG::IsMutationTarget(clang::Expr *e, MusicContext *context)
 {
+	ExprAnalysis &analysis = context->getExprAnalysis(e);
+
 	if (BinaryOperator *bo = dyn_cast<BinaryOperator>(e))
 	{
 		SourceLocation start_loc = e->getLocStart();
-    SourceLocation end_loc = GetEndLocOfExpr(e, context->comp_inst_);
+    SourceLocation end_loc = analysis.getEndLoc();
     StmtContext &stmt_context = context->getStmtContext();
 
     // OPPO can mutate binary bitwise expression in mutation range,
     // outside array decl size and enum declaration.
-    return context->IsRangeInMutationRange(SourceRange(start_loc, end_loc)) &&
+    return analysis.IsInMutationRange() &&
 	    		 bo->isBitwiseOp() &&
 	    		 !stmt_context.IsInArrayDeclSize() &&
 					 !stmt_context.IsInEnumDecl();
@@ -55,14 +68,12 @@ void OBNG::Mutate(clang::Expr *e, MusicContext *context)
 
 void OBNG::GenerateMutantByNegation(Expr *e, MusicContext *context)
 {
+  ExprAnalysis &analysis = context->getExprAnalysis(e);
+
   SourceLocation start_loc = e->getLocStart();
-  SourceLocation end_loc = GetEndLocOfExpr(e, context->comp_inst_); 
+  SourceLocation end_loc = analysis.getEndLoc(); 
 
-  Rewriter rewriter;
-  rewriter.setSourceMgr(
-  		context->comp_inst_->getSourceManager(),
-  		context->comp_inst_->getLangOpts());
-  string token{ConvertToString(e, context->comp_inst_->getLangOpts())};    
+  string token{analysis.getToken()};    
 
   string mutated_token = "~(" + token + ")";
 
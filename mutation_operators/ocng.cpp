@@ -11,6 +11,17 @@ bool OCNG::ValidateRange(const std::set<std::string> &range)
 	return range.empty();
 }
 
+void OCNG::GetTargetClasses(vector<StmtClassRange> &classes) const
+{
+	classes.push_back(Stmt::IfStmtClass);
+	classes.push_back(Stmt::WhileStmtClass);
+	classes.push_back(Stmt::DoStmtClass);
+	classes.push_back(Stmt::ForStmtClass);
+	classes.push_back(
+			StmtClassRange(Stmt::firstAbstractConditionalOperatorConstant,
+										 Stmt::lastAbstractConditionalOperatorConstant));
+}
+
 // Return True if the mutant operator can mutate this statement
 bool OCNG::IsMutationTarget(clang::Stmt *s, MusicContext *context)
 {
@@ -124,14 +135,12 @@ void OCNG::Mutate(clang::Stmt *s, MusicContext *context)
 
 void OCNG::GenerateMutantByNegation(Expr *e, MusicContext *context)
 {
+  ExprAnalysis &analysis = context->getExprAnalysis(e);
+
   SourceLocation start_loc = e->getLocStart();
-  SourceLocation end_loc = GetEndLocOfExpr(e, context->comp_inst_); 
+  SourceLocation end_loc = analysis.getEndLoc(); 
 
-  Rewriter rewriter;
-  rewriter.setSourceMgr(
-  		context->comp_inst_->getSourceManager(),
-  		context->comp_inst_->getLangOpts());
-  string token{ConvertToString(e, context->comp_inst_->getLangOpts())};    
+  string token{analysis.getToken()};    
 
   string mutated_token = "!(" + token + ")";
 
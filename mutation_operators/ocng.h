@@ -13,6 +13,8 @@ public:
 	virtual bool ValidateDomain(const std::set<std::string> &domain);
 	virtual bool ValidateRange(const std::set<std::string> &range);
 
+	virtual void GetTargetClasses(std::vector<StmtClassRange> &classes) const;
+
 	// Return True if the mutant operator can mutate this statement
 	virtual bool IsMutationTarget(clang::Stmt *s, MusicContext *context);
 
@@ -21,13 +21,22 @@ bool OCOR::ValidateRange(const std::set<std::string> &range)
 	return true;
 }
 
+void OCOR::GetTargetKinds(
+		vector<StmtClassRange> &classes,
+		vector<BinaryOperatorKind> &opcodes) const
+{
+	classes.push_back(Stmt::CStyleCastExprClass);
+}
+
 // Return True if the mutant operator can mutate this expression
 bool OCOR::IsMutationTarget(clang::Expr *e, MusicContext *context)
 {
+	ExprAnalysis &analysis = context->getExprAnalysis(e);
+
 	if (CStyleCastExpr *csce = dyn_cast<CStyleCastExpr>(e))
 	{
 		SourceLocation start_loc = csce->getLocStart();
-    SourceLocation end_loc = GetEndLocOfExpr(e, context->comp_inst_);
+    SourceLocation end_loc = analysis.getEndLoc();
     const Type *type{csce->getTypeAsWritten().getCanonicalType().getTypePtr()};
     StmtContext &stmt_context = context->getStmtContext();
 
@@ -39,7 +48,7 @@ bool OCOR::IsMutationTarget(clang::Expr *e, MusicContext *context)
     // These expr should be in mutation range, outside field decl
     // and the type of cast should be integral (int, char, float)
     return context->IsRangeInMutationRange(SourceRange(start_loc, end_loc)) &&
-					 !stmt_context.IsInFieldDeclRange(e) &&
+					 !analysis.IsInFieldDeclRange() &&
 					 (type->isIntegerType() || type->isCharType() || 
             type->isFloatingType()) && is_in_domain;
 	}
@@ -49,6 +58,8 @@ bool OCOR::IsMutationTarget(clang::Expr *e, MusicContext *context)
 
 void OCOR::Mutate(clang::Expr *e, MusicContext *context)
 {
+	ExprAnalysis &analysis = context->getExprAnalysis(e);
+
 	CStyleCastExpr *csce;
 	if (!(csce = dyn_cast<CStyleCastExpr>(e)))
 		return;
@@ -90,10 +101,10 @@ void OCOR::Mutate(clang::Expr *e, MusicContext *context)
   // binary modulo, shift, bitwise epxr to floating-type.
   // all of pre-mentioned expr demands integral subexpr
   if (is_subexpr_ptr ||
-  		stmt_context.IsInArraySubscriptRange(e) ||
-      stmt_context.IsInSwitchCaseRange(e) ||
-      stmt_context.IsInSwitchStmtConditionRange(e) ||
-      stmt_context.IsInNonFloatingExprRange(e))
+  		analysis.IsInArraySubscriptRange() ||
+      analysis.IsInSwitchCaseRange() ||
+      analysis.IsInSwitchStmtConditionRange() ||
+      analysis.IsInNonFloatingExprRange())
   	return;
 
   MutateToFloatingType(type_str, token, start_loc, end_loc, context);
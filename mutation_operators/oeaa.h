@@ -17,6 +17,10 @@ public:
 	virtual void setDomain(std::set<std::string> &domain);
   virtual void setRange(std::set<std::string> &range);
 
+	virtual void GetTargetKinds(
+			std::vector<StmtClassRange> &classes,
+			std::vector<clang::BinaryOperatorKind> &opcodes) const;
+
 	// Return True if the mutant operator can mutate this expression
 	virtual bool IsMutationTarget(clang::Expr *e, MusicContext *context);
 
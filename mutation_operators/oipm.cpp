@@ -11,6 +11,13 @@ bool OIPM::ValidateRange(const std::set<std::string> &range)
 	return range.empty();
 }
 
+void OIPM::GetTargetKinds(
+		vector<StmtClassRange> &classes,
+		vector<BinaryOperatorKind> &opcodes) const
+{
+	classes.push_back(Stmt::UnaryOperatorClass);
+}
+
 // Return True if the mutant operator can mutate this expression
 bool OIPM::IsMutationTarget(clang::Expr *e, MusicContext *context)
 {
@@ -84,9 +91,6 @@ void OIPM::Mutate(clang::Expr *e, MusicContext *context)
 	if (!(uo = dyn_cast<UnaryOperator>(e)))
 		return;
 
-	Rewriter rewriter;
-	rewriter.setSourceMgr(context->comp_inst_->getSourceManager(), 
-														context->comp_inst_->getLangOpts());
 	string token{ConvertToString(uo, context->comp_inst_->getLangOpts())};
 
 	Expr *first_non_deref_subexpr = cast<Expr>(uo);
@@ -14,6 +14,10 @@ public:
 	virtual bool ValidateDomain(const std::set<std::string> &domain);
 	virtual bool ValidateRange(const std::set<std::string> &range);
 
+	virtual void GetTargetKinds(
+			std::vector<StmtClassRange> &classes,
+			std::vector<clang::BinaryOperatorKind> &opcodes) const;
+
 	// Return True if the mutant operator can mutate this expression
 	virtual bool IsMutationTarget(clang::Expr *e, MusicContext *context);
 
@@ -11,18 +11,30 @@ bool OLNG::ValidateRange(const std::set<std::string> &range)
 	return true;
 }
 
+void OLNG::GetTargetKinds(
+		vector<StmtClassRange> &classes,
+		vector<BinaryOperatorKind> &opcodes) const
+{
+	classes.push_back(StmtClassRange(Stmt::firstBinaryOperatorConstant,
+	                                 Stmt::lastBinaryOperatorConstant));
+	opcodes.push_back(BO_LAnd);
+	opcodes.push_back(BO_LOr);
+}
+
 // Return True if the mutant operator can mutate this expression
 bool OLNG::IsMutationTarget(clang::Expr *e, MusicContext *context)
 {
+	ExprAnalysis &analysis = context->getExprAnalysis(e);
+
 	if (BinaryOperator *bo = dyn_cast<BinaryOperator>(e))
 	{
 		SourceLocation start_loc = e->getLocStart();
-    SourceLocation end_loc = GetEndLocOfExpr(e, context->comp_inst_);
+    SourceLocation end_loc = analysis.getEndLoc();
     StmtContext &stmt_context = context->getStmtContext();
 
     // OPPO can mutate binary logical expression in mutation range,
     // outside array decl size and enum declaration.
-    return context->IsRangeInMutationRange(SourceRange(start_loc, end_loc)) &&
+    return analysis.IsInMutationRange() &&
     		bo->isLogicalOp() &&
     		!stmt_context.IsInArrayDeclSize() &&
 				!stmt_context.IsInEnumDecl();
@@ -57,17 +69,15 @@ void OLNG::Mutate(clang::Expr *e, MusicContext *context)
 
 void OLNG::GenerateMutantByNegation(Expr *e, MusicContext *context)
 {
+  ExprAnalysis &analysis = context->getExprAnalysis(e);
+
   SourceLocation start_loc = e->getLocStart();
-  SourceLocation end_loc = GetEndLocOfExpr(e, context->comp_inst_); 
+  SourceLocation end_loc = analysis.getEndLoc(); 
 
   // cout << "OLNG end loc is: ";
   // PrintLocation(context->comp_inst_->getSourceManager(), end_loc);
 
-  Rewriter rewriter;
-  rewriter.setSourceMgr(
-  		context->comp_inst_->getSourceManager(),
-  		context->comp_inst_->getLangOpts());
-  string token{ConvertToString(e, context->comp_inst_->getLangOpts())};    
+  string token{analysis.getToken()};    
 
   string mutated_token = "!(" + token + ")";
 
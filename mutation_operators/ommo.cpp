@@ -11,6 +11,13 @@ bool OMMO::ValidateRange(const std::set<std::string> &range)
 	return true;
 }
 
+void OMMO::GetTargetKinds(
+		vector<StmtClassRange> &classes,
+		vector<BinaryOperatorKind> &opcodes) const
+{
+	classes.push_back(Stmt::UnaryOperatorClass);
+}
+
 // Return True if the mutant operator can mutate this expression
 bool OMMO::IsMutationTarget(clang::Expr *e, MusicContext *context)
 {
@@ -21,8 +28,6 @@ bool OMMO::IsMutationTarget(clang::Expr *e, MusicContext *context)
     	SourceLocation end_loc = GetEndLocOfUnaryOpExpr(uo, context->comp_inst_);
 
     	SourceManager &src_mgr = context->comp_inst_->getSourceManager();
-		  Rewriter rewriter;
-		  rewriter.setSourceMgr(src_mgr, context->comp_inst_->getLangOpts());
 
 		  string token{ConvertToString(uo->getSubExpr(), 
 		  														 context->comp_inst_->getLangOpts())};
@@ -58,8 +63,6 @@ void OMMO::GenerateMutantForPostDec(UnaryOperator *uo, MusicContext *context)
 	SourceLocation end_loc = GetEndLocOfUnaryOpExpr(uo, context->comp_inst_);
 
 	SourceManager &src_mgr = context->comp_inst_->getSourceManager();
-	Rewriter rewriter;
-	rewriter.setSourceMgr(src_mgr, context->comp_inst_->getLangOpts());
 
 	string token{ConvertToString(uo, context->comp_inst_->getLangOpts())};
 
@@ -97,8 +100,6 @@ void OMMO::GenerateMutantForPreDec(UnaryOperator *uo, MusicContext *context)
 	SourceLocation end_loc = GetEndLocOfUnaryOpExpr(uo, context->comp_inst_);
 
 	SourceManager &src_mgr = context->comp_inst_->getSourceManager();
-	Rewriter rewriter;
-	rewriter.setSourceMgr(src_mgr, context->comp_inst_->getLangOpts());
 
 	string token{ConvertToString(uo, context->comp_inst_->getLangOpts())};
 
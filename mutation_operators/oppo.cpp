@@ -11,6 +11,13 @@ bool OPPO::ValidateRange(const std::set<std::string> &range)
 	return true;
 }
 
+void OPPO::GetTargetKinds(
+		vector<StmtClassRange> &classes,
+		vector<BinaryOperatorKind> &opcodes) const
+{
+	classes.push_back(Stmt::UnaryOperatorClass);
+}
+
 // Return True if the mutant operator can mutate this expression
 bool OPPO::IsMutationTarget(clang::Expr *e, MusicContext *context)
 {
@@ -21,8 +28,6 @@ bool OPPO::IsMutationTarget(clang::Expr *e, MusicContext *context)
     	SourceLocation end_loc = GetEndLocOfUnaryOpExpr(uo, context->comp_inst_);
 
     	SourceManager &src_mgr = context->comp_inst_->getSourceManager();
-		  Rewriter rewriter;
-		  rewriter.setSourceMgr(src_mgr, context->comp_inst_->getLangOpts());
 
 		  string token{ConvertToString(uo->getSubExpr(), 
 		  														 context->comp_inst_->getLangOpts())};
@@ -54,8 +59,6 @@ void OPPO::GenerateMutantForPostInc(UnaryOperator *uo, MusicContext *context)
 	SourceLocation end_loc = GetEndLocOfUnaryOpExpr(uo, context->comp_inst_);
 
 	SourceManager &src_mgr = context->comp_inst_->getSourceManager();
-	Rewriter rewriter;
-	rewriter.setSourceMgr(src_mgr, context->comp_inst_->getLangOpts());
 
 	string token{ConvertToString(uo, context->comp_inst_->getLangOpts())};
 
@@ -94,8 +97,6 @@ void OPPO::GenerateMutantForPreInc(UnaryOperator *uo, MusicContext *context)
 	SourceLocation end_loc = GetEndLocOfUnaryOpExpr(uo, context->comp_inst_);
 
 	SourceManager &src_mgr = context->comp_inst_->getSourceManager();
-	Rewriter rewriter;
-	rewriter.setSourceMgr(src_mgr, context->comp_inst_->getLangOpts());
 
 	string token{ConvertToString(uo, context->comp_inst_->getLangOpts())};
 
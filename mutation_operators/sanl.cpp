@@ -11,9 +11,18 @@ bool SANL::ValidateRange(const std::set<std::string> &range)
 	return range.empty();
 }
 
+void SANL::GetTargetKinds(
+		vector<StmtClassRange> &classes,
+		vector<BinaryOperatorKind> &opcodes) const
+{
+	classes.push_back(Stmt::StringLiteralClass);
+}
+
 // Return True if the mutant operator can mutate this expression
 bool SANL::IsMutationTarget(clang::Expr *e, MusicContext *context)
 {
+  ExprAnalysis &analysis = context->getExprAnalysis(e);
+
   // if (GetLineNumber(context->comp_inst_->getSourceManager(), e->getLocStart()) == 49)
   //   cout << "SANL can mutate?\n";
 
@@ -29,7 +38,7 @@ bool SANL::IsMutationTarget(clang::Expr *e, MusicContext *context)
     // FieldDecl is a member of a struct or union.
     return context->IsRangeInMutationRange(SourceRange(start_loc, end_loc)) &&
     			 !stmt_context.IsInEnumDecl() &&
-    			 !stmt_context.IsInFieldDeclRange(e);
+    			 !analysis.IsInFieldDeclRange();
 	}
 
   // if (GetLineNumber(context->comp_inst_->getSourceManager(), e->getLocStart()) == 49)
@@ -42,17 +51,17 @@ bool SANL::IsMutationTarget(clang::Expr *e, MusicContext *context)
 
 void SANL::Mutate(clang::Expr *e, MusicContext *context)
 {
+  ExprAnalysis &analysis = context->getExprAnalysis(e);
+
   // if (GetLineNumber(context->comp_inst_->getSourceManager(), e->getLocStart()) == 49)
   //   cout << "mutating\n";
 
 	SourceManager &src_mgr = context->comp_inst_->getSourceManager();
-	Rewriter rewriter;
-	rewriter.setSourceMgr(src_mgr, context->comp_inst_->getLangOpts());
 
 	SourceLocation start_loc = e->getLocStart();
   SourceLocation end_loc = GetEndLocOfStringLiteral(src_mgr, start_loc);
 
-	string token{ConvertToString(e, context->comp_inst_->getLangOpts())};
+	string token{analysis.getToken()};
 	
 	string mutated_token{token};
 	mutated_token.pop_back();
@@ -11,9 +11,18 @@ bool SCSR::ValidateRange(const std::set<std::string> &range)
 	return range.empty();
 }
 
+void SCSR::GetTargetKinds(
+		vector<StmtClassRange> &classes,
+		vector<BinaryOperatorKind> &opcodes) const
+{
+	classes.push_back(Stmt::StringLiteralClass);
+}
+
 // Return True if the mutant operator can mutate this expression
 bool SCSR::IsMutationTarget(clang::Expr *e, MusicContext *context)
 {
+	ExprAnalysis &analysis = context->getExprAnalysis(e);
+
 	if (StringLiteral *sl = dyn_cast<StringLiteral>(e))
 	{
 		SourceLocation start_loc = sl->getLocStart();
@@ -26,7 +35,7 @@ bool SCSR::IsMutationTarget(clang::Expr *e, MusicContext *context)
     // FieldDecl is a member of a struct or union.
     return context->IsRangeInMutationRange(SourceRange(start_loc, end_loc)) &&
     			 !stmt_context.IsInEnumDecl() &&
-    			 !stmt_context.IsInFieldDeclRange(e);
+    			 !analysis.IsInFieldDeclRange();
 	}
 
 	return false;
@@ -47,19 +56,19 @@ void SCSR::Mutate(clang::Expr *e, MusicContext *context)
 void SCSR::GenerateGlobalMutants(Expr *e, MusicContext *context,
 																 set<string> *stringCache)
 {
+	ExprAnalysis &analysis = context->getExprAnalysis(e);
+
 	SourceManager &src_mgr = context->comp_inst_->getSourceManager();
 	SourceLocation start_loc = e->getLocStart();
   SourceLocation end_loc = GetEndLocOfStringLiteral(src_mgr, start_loc);
 
-	Rewriter rewriter;
-	rewriter.setSourceMgr(src_mgr, context->comp_inst_->getLangOpts());
-	string token{ConvertToString(e, context->comp_inst_->getLangOpts())};
+	string token{analysis.getToken()};
 
 	// All string literals from global list are distinct 
   // (filtered from InformationGatherer).
-  for (auto it: *(context->getSymbolTable()->getGlobalStringLiteralList()))
+  for (auto &literal: *(context->getSymbolTable()->getGlobalStringLiteralList()))
   {
-  	string mutated_token{ConvertToString(it, context->comp_inst_->getLangOpts())};
+  	const string &mutated_token = literal.token_;
 
     if (mutated_token.compare(token) != 0)
     {
@@ -73,20 +82,20 @@ void SCSR::GenerateGlobalMutants(Expr *e, MusicContext *context,
 void SCSR::GenerateLocalMutants(Expr *e, MusicContext *context,
 															  set<string> *stringCache)
 {
+	ExprAnalysis &analysis = context->getExprAnalysis(e);
+
 	SourceManager &src_mgr = context->comp_inst_->getSourceManager();
 	SourceLocation start_loc = e->getLocStart();
   SourceLocation end_loc = GetEndLocOfStringLiteral(src_mgr, start_loc);
 
-	Rewriter rewriter;
-	rewriter.setSourceMgr(src_mgr, context->comp_inst_->getLangOpts());
-	string token{ConvertToString(e, context->comp_inst_->getLangOpts())};
+	string token{analysis.getToken()};
 
 	if (!context->getStmtContext().IsInCurrentlyParsedFunctionRange(e))
 		return;
 
-	for (auto it: (*(context->getSymbolTable()->getLocalStringLiteralList()))[context->getFunctionId()])
+	for (auto &literal: (*(context->getSymbolTable()->getLocalStringLiteralList()))[context->getFunctionId()])
 	{
-		string mutated_token = ConvertToString(it, context->comp_inst_->getLangOpts());
+		const string &mutated_token = literal.token_;
 
     // mutate if the literal is not the same as the token
     // and prevent duplicate if the literal is already in the cache
@@ -11,9 +11,18 @@ bool SRWS::ValidateRange(const std::set<std::string> &range)
 	return true;
 }
 
+void SRWS::GetTargetKinds(
+		vector<StmtClassRange> &classes,
+		vector<BinaryOperatorKind> &opcodes) const
+{
+	classes.push_back(Stmt::StringLiteralClass);
+}
+
 // Return True if the mutant operator can mutate this expression
 bool SRWS::IsMutationTarget(clang::Expr *e, MusicContext *context)
 {
+	ExprAnalysis &analysis = context->getExprAnalysis(e);
+
 	if (StringLiteral *sl = dyn_cast<StringLiteral>(e))
 	{
 		SourceLocation start_loc = sl->getLocStart();
@@ -26,7 +35,7 @@ bool SRWS::IsMutationTarget(clang::Expr *e, MusicContext *context)
     // FieldDecl is a member of a struct or union.
     return context->IsRangeInMutationRange(SourceRange(start_loc, end_loc)) &&
            !stmt_context.IsInEnumDecl() &&
-           !stmt_context.IsInFieldDeclRange(e);
+           !analysis.IsInFieldDeclRange();
 	}
 
 	return false;
@@ -34,13 +43,13 @@ bool SRWS::IsMutationTarget(clang::Expr *e, MusicContext *context)
 
 void SRWS::Mutate(clang::Expr *e, MusicContext *context)
 {
+	ExprAnalysis &analysis = context->getExprAnalysis(e);
+
 	SourceManager &src_mgr = context->comp_inst_->getSourceManager();
 	SourceLocation start_loc = e->getLocStart();
   SourceLocation end_loc = GetEndLocOfStringLiteral(src_mgr, start_loc);
 
-  Rewriter rewriter;
-	rewriter.setSourceMgr(src_mgr, context->comp_inst_->getLangOpts());
-	string token{ConvertToString(e, context->comp_inst_->getLangOpts())};
+	string token{analysis.getToken()};
 
 	int first_non_whitespace = GetFirstNonWhitespaceIndex(token);
   int last_non_whitespace = GetLastNonWhitespaceIndex(token);
@@ -127,9 +127,7 @@ void SSDL::DeleteStatement(Stmt *s, MusicContext *context)
   		isa<WhileStmt>(s) || isa<ForStmt>(s))
   	HandleStmtWithBody(s, context);
 
-  Rewriter rewriter;
 	SourceManager &src_mgr = context->comp_inst_->getSourceManager();
-	rewriter.setSourceMgr(src_mgr, context->comp_inst_->getLangOpts());
 
 	string token{ConvertToString(s, context->comp_inst_->getLangOpts())};
 	SourceLocation start_loc = s->getLocStart();
@@ -157,7 +155,7 @@ void SSDL::DeleteStatement(Stmt *s, MusicContext *context)
       IsInSpecifiedDomain(src_mgr, start_loc, end_loc) &&
       NoUnremovableLabelInsideRange(src_mgr,
       															SourceRange(start_loc, end_loc),
-      															context->label_to_gotolist_map_))
+      															context->label_index_))
 	{
 		context->mutant_database_.AddMutantEntry(
         name_, start_loc, end_loc, token, mutated_token, 
@@ -172,41 +170,18 @@ void SSDL::DeleteStatement(Stmt *s, MusicContext *context)
 // Deleting such label can cause goto-undefined-label error.
 // Return True if there is no such label inside given range
 bool SSDL::NoUnremovableLabelInsideRange(
-	SourceManager &src_mgr, SourceRange range, 
-	LabelStmtToGotoStmtListMap *label_map)
+	SourceManager &src_mgr, SourceRange range, LabelIndex *label_index)
 {
-  auto it = label_map->begin();
+  SourceLocation start_loc = src_mgr.getExpansionLoc(range.getBegin());
+  SourceLocation end_loc = src_mgr.getExpansionLoc(range.getEnd());
 
-  for (; it != label_map->end(); ++it)
-  {
-    // cout << "cp ssdl\n";
-
-    SourceLocation loc = src_mgr.translateLineCol(
-    	src_mgr.getMainFileID(),
-      it->first.first,
-      it->first.second);
-
-    // check only those labels inside range
-    if (LocationIsInRange(loc, range))
-    {
-      // check if this label is goto-ed from outside of the statement
-      // if yes, then the label is unremovable, return False
-      for (auto e: it->second)  
-      {   
-        // the goto is outside of the statement
-        if (!LocationIsInRange(e, range))  
-          return false;
-      }
-    }
-
-    // the LabelStmtToGotoStmtListMap is traversed in the order of 
-    // increasing location. If the location is after the range then 
-    // all the rest is outside statement range
-    if (LocationAfterRangeEnd(loc, range))
-      return true;
-  }
+  // labels are indexed by offset in the main file only
+  if (src_mgr.getFileID(start_loc) != src_mgr.getMainFileID() ||
+      src_mgr.getFileID(end_loc) != src_mgr.getMainFileID())
+    return true;
 
-  return true;
+  return !label_index->HasLabelTargetedFromOutside(
+      src_mgr.getFileOffset(start_loc), src_mgr.getFileOffset(end_loc));
 }
 
 bool SSDL::HandleStmtWithSubStmt(Stmt *s, MusicContext *context)
@@ -268,13 +243,11 @@ void SSDL::DeleteCompoundStmtContent(CompoundStmt *c, MusicContext *context)
   SourceLocation start_loc = c->getLBracLoc();
   SourceLocation end_loc = c->getRBracLoc().getLocWithOffset(1);
 
-  Rewriter rewriter;
 	SourceManager &src_mgr = context->comp_inst_->getSourceManager();
-	rewriter.setSourceMgr(src_mgr, context->comp_inst_->getLangOpts());
 
   if (!NoUnremovableLabelInsideRange(src_mgr, 
   																	 SourceRange(start_loc, end_loc),
-  																	 context->label_to_gotolist_map_))
+  																	 context->label_index_))
     return;
 
   string token{ConvertToString(c, context->comp_inst_->getLangOpts())};
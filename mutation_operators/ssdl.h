@@ -26,7 +26,7 @@ public:
 	// Deleting such label can cause goto-undefined-label error.
 	// Return True if there is no such label inside given range
 	bool NoUnremovableLabelInsideRange(SourceManager &src_mgr, SourceRange range, 
-																		 LabelStmtToGotoStmtListMap *label_map);
+																		 LabelIndex *label_index);
 
 	bool HandleStmtWithSubStmt(Stmt *s, MusicContext *context);
 
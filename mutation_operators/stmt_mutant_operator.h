@@ -13,6 +13,14 @@ public:
 	virtual bool ValidateDomain(const std::set<std::string> &domain) = 0;
 	virtual bool ValidateRange(const std::set<std::string> &range) = 0;
 
+	/**
+		Add to classes the Stmt classes of the statements this operator can
+		mutate. IsMutationTarget is only called for such statements. Adding no
+		class means any statement.
+	*/
+	virtual void GetTargetClasses(std::vector<StmtClassRange> &classes) const
+	{}
+
 	// Return True if the mutant operator can mutate this statement
 	virtual bool IsMutationTarget(clang::Stmt *s, MusicContext *context) = 0;
 
@@ -22,27 +22,34 @@ bool VGAR::ValidateRange(const std::set<std::string> &range)
 	// return range.empty();
 }
 
+void VGAR::GetTargetKinds(
+		vector<StmtClassRange> &classes,
+		vector<BinaryOperatorKind> &opcodes) const
+{
+	GetReferenceTargetKinds(classes);
+}
+
 // Return True if the mutant operator can mutate this expression
 bool VGAR::IsMutationTarget(clang::Expr *e, MusicContext *context)
 {
+	ExprAnalysis &analysis = context->getExprAnalysis(e);
+
 	if (!ExprIsArrayReference(e))
 		return false;
 
 	SourceLocation start_loc = e->getLocStart();
-	SourceLocation end_loc = GetEndLocOfExpr(e, context->comp_inst_);
+	SourceLocation end_loc = analysis.getEndLoc();
 	StmtContext &stmt_context = context->getStmtContext();
 
   SourceManager &src_mgr = context->comp_inst_->getSourceManager();
-  Rewriter rewriter;
-  rewriter.setSourceMgr(src_mgr, context->comp_inst_->getLangOpts());
 
-  string token{ConvertToString(e, context->comp_inst_->getLangOpts())};
+  string token{analysis.getToken()};
   bool is_in_domain = domain_.empty() ? true : 
                       IsStringElementOfSet(token, domain_);
 
 	// VGAR can mutate this expression only if it is array type
 	// inside mutation range and NOT inside array decl size or enum declaration
-	return context->IsRangeInMutationRange(SourceRange(start_loc, end_loc)) &&
+	return analysis.IsInMutationRange() &&
 				 !stmt_context.IsInArrayDeclSize() &&
 				 !stmt_context.IsInEnumDecl() && is_in_domain;
 }
@@ -55,42 +62,44 @@ string newGetArrayTypeFunction(QualType type)
 
 void VGAR::Mutate(clang::Expr *e, MusicContext *context)
 {
+	ExprAnalysis &analysis = context->getExprAnalysis(e);
+
 	SourceLocation start_loc = e->getLocStart();
-	SourceLocation end_loc = GetEndLocOfExpr(e, context->comp_inst_);
+	SourceLocation end_loc = analysis.getEndLoc();
 
 	SourceManager &src_mgr = context->comp_inst_->getSourceManager();
-	Rewriter rewriter;
-	rewriter.setSourceMgr(src_mgr, context->comp_inst_->getLangOpts());
 
-	string token{ConvertToString(e, context->comp_inst_->getLangOpts())};
+	string token{analysis.getToken()};
 	StmtContext &stmt_context = context->getStmtContext();
 
 	// cannot mutate variable in switch condition to a floating-type variable
-  bool skip_float_vardecl = stmt_context.IsInSwitchStmtConditionRange(e);
+  bool skip_float_vardecl = analysis.IsInSwitchStmtConditionRange();
 
   // cannot mutate a variable in lhs of assignment to a const variable
-  bool skip_const_vardecl = stmt_context.IsInLhsOfAssignmentRange(e);
+  bool skip_const_vardecl = analysis.IsInLhsOfAssignmentRange();
 
-  for (auto vardecl: *(context->getSymbolTable()->getGlobalArrayVarDeclList()))
-  {
-  	if (!(vardecl->getLocStart() < start_loc))
-  		break; 
+  unsigned excluded_flags{0};
 
-    string mutated_token{GetVarDeclName(vardecl)};
+  if (skip_const_vardecl)
+    excluded_flags |= VarDeclSymbol::kConst;
 
-    if (!range_.empty() && !IsStringElementOfSet(mutated_token, range_))
-      continue;
+  if (skip_float_vardecl)
+    excluded_flags |= VarDeclSymbol::kFloating;
 
-  	if (skip_const_vardecl && IsVarDeclConst(vardecl)) 
-      continue;   
+  VarDeclCandidateList range;
+  context->getSymbolTable()->GetGlobalVarDeclCandidates(
+      SymbolTable::kArrayVarDecl, start_loc, excluded_flags, range);
 
-    if (skip_float_vardecl && IsVarDeclFloating(vardecl))
+  for (auto symbol: range)
+  {
+    // Skip if range is specified and this VarDecl is not in range.
+    if (!range_.empty() && !IsStringElementOfSet(symbol->name_, range_))
       continue;
 
-    if (token.compare(mutated_token) != 0 && 
-        sameArrayElementType(e->getType(), vardecl->getType()))
+    if (token.compare(symbol->name_) != 0 && 
+        sameArrayElementType(e->getType(), symbol->vardecl_->getType()))
     {
-    	context->mutant_database_.AddMutantEntry(name_, start_loc, end_loc, token, mutated_token, context->getStmtContext().getProteumStyleLineNum());
+    	context->mutant_database_.AddMutantEntry(name_, start_loc, end_loc, token, symbol->name_, context->getStmtContext().getProteumStyleLineNum());
     }
   }
 }
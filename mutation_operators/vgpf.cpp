@@ -11,9 +11,19 @@ bool VGPF::ValidateRange(const std::set<std::string> &range)
 	return true;
 }
 
+void VGPF::GetTargetKinds(
+		vector<StmtClassRange> &classes,
+		vector<BinaryOperatorKind> &opcodes) const
+{
+	classes.push_back(StmtClassRange(Stmt::firstCallExprConstant,
+	                                 Stmt::lastCallExprConstant));
+}
+
 // Return True if the mutant operator can mutate this expression
 bool VGPF::IsMutationTarget(clang::Expr *e, MusicContext *context)
 {
+	ExprAnalysis &analysis = context->getExprAnalysis(e);
+
 	if (CallExpr *ce = dyn_cast<CallExpr>(e))
 	{
 		SourceLocation start_loc = ce->getLocStart();
@@ -30,7 +40,7 @@ bool VGPF::IsMutationTarget(clang::Expr *e, MusicContext *context)
     // Return True if expr is in mutation range, NOT inside enum decl
     // and is pointer type.
 		return (context->IsRangeInMutationRange(SourceRange(start_loc, end_loc)) &&
-						!context->getStmtContext().IsInEnumDecl() && ExprIsPointer(e)) &&
+						!context->getStmtContext().IsInEnumDecl() && analysis.IsPointer()) &&
             is_in_domain;
 	}
 
@@ -39,6 +49,8 @@ bool VGPF::IsMutationTarget(clang::Expr *e, MusicContext *context)
 
 void VGPF::Mutate(clang::Expr *e, MusicContext *context)
 {
+	ExprAnalysis &analysis = context->getExprAnalysis(e);
+
 	CallExpr *ce;
 	if (!(ce = dyn_cast<CallExpr>(e)))
 		return;
@@ -49,11 +61,9 @@ void VGPF::Mutate(clang::Expr *e, MusicContext *context)
   SourceLocation end_loc = ce->getRParenLoc();
   end_loc = end_loc.getLocWithOffset(1);
 
-  Rewriter rewriter;
 	SourceManager &src_mgr = context->comp_inst_->getSourceManager();
-	rewriter.setSourceMgr(src_mgr, context->comp_inst_->getLangOpts());
 
-	string token{ConvertToString(e, context->comp_inst_->getLangOpts())};
+	string token{analysis.getToken()};
 
 	// cannot mutate variable in switch condition to a floating-type variable
   bool skip_float_vardecl = \
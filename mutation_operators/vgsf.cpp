@@ -17,9 +17,19 @@ bool VGSF::ValidateRange(const std::set<std::string> &range)
   return true;
 }
 
+void VGSF::GetTargetKinds(
+		vector<StmtClassRange> &classes,
+		vector<BinaryOperatorKind> &opcodes) const
+{
+	classes.push_back(StmtClassRange(Stmt::firstCallExprConstant,
+	                                 Stmt::lastCallExprConstant));
+}
+
 // Return True if the mutant operator can mutate this expression
 bool VGSF::IsMutationTarget(clang::Expr *e, MusicContext *context)
 {
+	ExprAnalysis &analysis = context->getExprAnalysis(e);
+
 	if (CallExpr *ce = dyn_cast<CallExpr>(e))
 	{
 		SourceLocation start_loc = ce->getLocStart();
@@ -40,7 +50,7 @@ bool VGSF::IsMutationTarget(clang::Expr *e, MusicContext *context)
     // and is scalar type.
 		return (context->IsRangeInMutationRange(SourceRange(start_loc, end_loc)) &&
 						!context->getStmtContext().IsInEnumDecl() &&
-						ExprIsScalar(e));
+						analysis.IsScalar());
 	}
 
 	return false;
@@ -48,6 +58,8 @@ bool VGSF::IsMutationTarget(clang::Expr *e, MusicContext *context)
 
 void VGSF::Mutate(clang::Expr *e, MusicContext *context)
 {
+	ExprAnalysis &analysis = context->getExprAnalysis(e);
+
 	CallExpr *ce;
 	if (!(ce = dyn_cast<CallExpr>(e)))
 		return;
@@ -58,11 +70,9 @@ void VGSF::Mutate(clang::Expr *e, MusicContext *context)
   SourceLocation end_loc = ce->getRParenLoc();
   end_loc = end_loc.getLocWithOffset(1);
 
-  Rewriter rewriter;
 	SourceManager &src_mgr = context->comp_inst_->getSourceManager();
-	rewriter.setSourceMgr(src_mgr, context->comp_inst_->getLangOpts());
 
-	string token{ConvertToString(e, context->comp_inst_->getLangOpts())};
+	string token{analysis.getToken()};
 
 	// cannot mutate variable in switch condition to a floating-type variable
   bool skip_float_vardecl = \
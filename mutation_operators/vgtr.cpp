@@ -23,27 +23,34 @@ bool VGTR::ValidateRange(const std::set<std::string> &range)
 	// return range.empty();
 }
 
+void VGTR::GetTargetKinds(
+		vector<StmtClassRange> &classes,
+		vector<BinaryOperatorKind> &opcodes) const
+{
+	GetReferenceTargetKinds(classes);
+}
+
 // Return True if the mutant operator can mutate this expression
 bool VGTR::IsMutationTarget(clang::Expr *e, MusicContext *context)
 {
+	ExprAnalysis &analysis = context->getExprAnalysis(e);
+
 	if (!ExprIsStructReference(e))
 		return false;
 
 	SourceLocation start_loc = e->getLocStart();
-	SourceLocation end_loc = GetEndLocOfExpr(e, context->comp_inst_);
+	SourceLocation end_loc = analysis.getEndLoc();
 	StmtContext &stmt_context = context->getStmtContext();
 
   SourceManager &src_mgr = context->comp_inst_->getSourceManager();
-  Rewriter rewriter;
-  rewriter.setSourceMgr(src_mgr, context->comp_inst_->getLangOpts());
 
-  string token{ConvertToString(e, context->comp_inst_->getLangOpts())};
+  string token{analysis.getToken()};
   bool is_in_domain = domain_.empty() ? true : 
                       IsStringElementOfSet(token, domain_);
 
 	// VGTR can mutate this expression only if it is struct type
 	// inside mutation range and NOT inside array decl size or enum declaration
-	return context->IsRangeInMutationRange(SourceRange(start_loc, end_loc)) &&
+	return analysis.IsInMutationRange() &&
 				 !stmt_context.IsInArrayDeclSize() &&
 				 !stmt_context.IsInEnumDecl() && is_in_domain;
 }
@@ -52,45 +59,46 @@ bool VGTR::IsMutationTarget(clang::Expr *e, MusicContext *context)
 
 void VGTR::Mutate(clang::Expr *e, MusicContext *context)
 {
+	ExprAnalysis &analysis = context->getExprAnalysis(e);
+
 	SourceLocation start_loc = e->getLocStart();
-	SourceLocation end_loc = GetEndLocOfExpr(e, context->comp_inst_);
+	SourceLocation end_loc = analysis.getEndLoc();
 
 	SourceManager &src_mgr = context->comp_inst_->getSourceManager();
-	Rewriter rewriter;
-	rewriter.setSourceMgr(src_mgr, context->comp_inst_->getLangOpts());
 
-	string token{ConvertToString(e, context->comp_inst_->getLangOpts())};
+	string token{analysis.getToken()};
 	StmtContext &stmt_context = context->getStmtContext();
 
 	// cannot mutate variable in switch condition to a floating-type variable
-  bool skip_float_vardecl = stmt_context.IsInSwitchStmtConditionRange(e);
+  bool skip_float_vardecl = analysis.IsInSwitchStmtConditionRange();
 
   // cannot mutate a variable in lhs of assignment to a const variable
-  bool skip_const_vardecl = stmt_context.IsInLhsOfAssignmentRange(e);
+  bool skip_const_vardecl = analysis.IsInLhsOfAssignmentRange();
 
   string struct_type = getStructureType(e->getType());
 
-  for (auto vardecl: *(context->getSymbolTable()->getGlobalStructVarDeclList()))
-  {
-  	if (!(vardecl->getLocStart() < start_loc))
-  		break; 
+  unsigned excluded_flags{0};
 
-    string mutated_token{GetVarDeclName(vardecl)};
+  if (skip_const_vardecl)
+    excluded_flags |= VarDeclSymbol::kConst;
 
-    // Skip if range is specified and this VarDecl is not in range.
-    if (!range_.empty() && !IsStringElementOfSet(mutated_token, range_))
-      continue; 
-  	
-  	if (skip_const_vardecl && IsVarDeclConst(vardecl)) 
-      continue;   
+  if (skip_float_vardecl)
+    excluded_flags |= VarDeclSymbol::kFloating;
+
+  VarDeclCandidateList range;
+  context->getSymbolTable()->GetGlobalVarDeclCandidates(
+      SymbolTable::kStructVarDecl, start_loc, excluded_flags, range);
 
-    if (skip_float_vardecl && IsVarDeclFloating(vardecl))
+  for (auto symbol: range)
+  {
+    // Skip if range is specified and this VarDecl is not in range.
+    if (!range_.empty() && !IsStringElementOfSet(symbol->name_, range_))
       continue;
 
-    if (token.compare(mutated_token) != 0 &&
-        struct_type.compare(getStructureType(vardecl->getType())) == 0)
+    if (token.compare(symbol->name_) != 0 &&
+        struct_type.compare(symbol->type_) == 0)
     {
-    	context->mutant_database_.AddMutantEntry(name_, start_loc, end_loc, token, mutated_token, context->getStmtContext().getProteumStyleLineNum());
+    	context->mutant_database_.AddMutantEntry(name_, start_loc, end_loc, token, symbol->name_, context->getStmtContext().getProteumStyleLineNum());
     }
   }
 }
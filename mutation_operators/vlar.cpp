@@ -19,125 +19,98 @@ bool VLAR::ValidateRange(const std::set<std::string> &range)
   return true;
 }
 
+void VLAR::GetTargetKinds(
+		vector<StmtClassRange> &classes,
+		vector<BinaryOperatorKind> &opcodes) const
+{
+	GetReferenceTargetKinds(classes);
+}
+
 // Return True if the mutant operator can mutate this expression
 bool VLAR::IsMutationTarget(clang::Expr *e, MusicContext *context)
 {
+	ExprAnalysis &analysis = context->getExprAnalysis(e);
+
 	if (!ExprIsArrayReference(e))
 		return false;
 
 	SourceLocation start_loc = e->getLocStart();
-	SourceLocation end_loc = GetEndLocOfExpr(e, context->comp_inst_);
+	SourceLocation end_loc = analysis.getEndLoc();
 	StmtContext &stmt_context = context->getStmtContext();
 
   SourceManager &src_mgr = context->comp_inst_->getSourceManager();
-  Rewriter rewriter;
-  rewriter.setSourceMgr(src_mgr, context->comp_inst_->getLangOpts());
 
-  string token{ConvertToString(e, context->comp_inst_->getLangOpts())};
+  string token{analysis.getToken()};
   bool is_in_domain = domain_.empty() ? true : 
                       IsStringElementOfSet(token, domain_);
 
 	// VLAR can mutate this expression only if it is array type
 	// inside mutation range and NOT inside array decl size or enum declaration
-	return context->IsRangeInMutationRange(SourceRange(start_loc, end_loc)) &&
+	return analysis.IsInMutationRange() &&
 				 !stmt_context.IsInArrayDeclSize() &&
 				 !stmt_context.IsInEnumDecl() &&
-				 stmt_context.IsInCurrentlyParsedFunctionRange(e) &&
+				 analysis.IsInCurrentlyParsedFunctionRange() &&
          is_in_domain;
 }
 
 void VLAR::Mutate(clang::Expr *e, MusicContext *context)
 {
+	ExprAnalysis &analysis = context->getExprAnalysis(e);
+
 	SourceLocation start_loc = e->getLocStart();
-	SourceLocation end_loc = GetEndLocOfExpr(e, context->comp_inst_);
+	SourceLocation end_loc = analysis.getEndLoc();
 
 	SourceManager &src_mgr = context->comp_inst_->getSourceManager();
-	Rewriter rewriter;
-	rewriter.setSourceMgr(src_mgr, context->comp_inst_->getLangOpts());
-
-	string token{ConvertToString(e, context->comp_inst_->getLangOpts())};
 
-	// get all variable declaration that VLSR can mutate this expr to.
-  VarDeclList range(
-  		(*(context->getSymbolTable()->getLocalArrayVarDeclList()))[context->getFunctionId()]);
+	string token{analysis.getToken()};
 
+	// get all variable declaration that VLAR can mutate this expr to.
+  VarDeclCandidateList range;
   GetRange(e, context, &range);
 
-  for (auto vardecl: range)
+  for (auto symbol: range)
   {
-  	string mutated_token{GetVarDeclName(vardecl)};
+    if (token.compare(symbol->name_) == 0 ||
+        (!range_.empty() && !IsStringElementOfSet(symbol->name_, range_)))
+      continue;
   	
-  	if (sameArrayElementType(e->getType(), vardecl->getType()))
+  	if (sameArrayElementType(e->getType(), symbol->vardecl_->getType()))
   	{
-  		context->mutant_database_.AddMutantEntry(name_, start_loc, end_loc, token, mutated_token, context->getStmtContext().getProteumStyleLineNum());
+  		context->mutant_database_.AddMutantEntry(name_, start_loc, end_loc, token, symbol->name_, context->getStmtContext().getProteumStyleLineNum());
 		}
   }
 }
 
-void VLAR::GetRange(Expr *e, MusicContext *context, VarDeclList *range)
+void VLAR::GetRange(Expr *e, MusicContext *context,
+                    VarDeclCandidateList *range)
 {
+  ExprAnalysis &analysis = context->getExprAnalysis(e);
+
   SourceLocation start_loc = e->getLocStart();
-  Rewriter rewriter;
-  rewriter.setSourceMgr(context->comp_inst_->getSourceManager(), 
-                        context->comp_inst_->getLangOpts());
 
-  string token{ConvertToString(e, context->comp_inst_->getLangOpts())};
 	StmtContext &stmt_context = context->getStmtContext();
 
 	// cannot mutate variable in switch condition to a floating-type variable
-  bool skip_float_vardecl = stmt_context.IsInSwitchStmtConditionRange(e);
+  bool skip_float_vardecl = analysis.IsInSwitchStmtConditionRange();
 
   // cannot mutate a variable in lhs of assignment to a const variable
-  bool skip_const_vardecl = stmt_context.IsInLhsOfAssignmentRange(e);
+  bool skip_const_vardecl = analysis.IsInLhsOfAssignmentRange();
 
-  bool skip_register_vardecl = stmt_context.IsInAddressOpRange(e);
+  bool skip_register_vardecl = analysis.IsInAddressOpRange();
 
-	// remove all vardecl appear after expr
-	for (auto it = range->begin(); it != range->end(); )
-	{
-		if (!((*it)->getLocStart() < start_loc))
-		{
-			range->erase(it, range->end());
-			break;
-		}
+  unsigned excluded_flags{0};
 
-    bool is_in_range = range_.empty() ? true :
-                       IsStringElementOfSet(GetVarDeclName(*it), range_);
-
-		if ((skip_const_vardecl && IsVarDeclConst((*it))) ||
-				(skip_float_vardecl && IsVarDeclFloating((*it))) ||
-				(skip_register_vardecl && 
-          (*it)->getStorageClass() == SC_Register) ||
-				(token.compare(GetVarDeclName(*it)) == 0) ||
-        !is_in_range)
-		{
-			it = range->erase(it);
-			continue;
-		}
+  if (skip_const_vardecl)
+    excluded_flags |= VarDeclSymbol::kConst;
 
-		++it;
-	}
-
-	for (auto scope: *(context->scope_list_))
-	{
-		// all vardecl after expr are removed.
-		// Hence no need to consider scopes after expr as well.
-		if (LocationBeforeRangeStart(start_loc, scope))
-			break;
-
-		if (!LocationIsInRange(start_loc, scope))
-			for (auto it = range->begin(); it != range->end();)
-			{
-				if (LocationAfterRangeEnd((*it)->getLocStart(), scope))
-					break;
-
-				if (LocationIsInRange((*it)->getLocStart(), scope))
-				{
-					it = range->erase(it);
-					continue;
-				}
-
-				++it;
-			}
-	}
-}
\ No newline at end of file
+  if (skip_float_vardecl)
+    excluded_flags |= VarDeclSymbol::kFloating;
+
+  if (skip_register_vardecl)
+    excluded_flags |= VarDeclSymbol::kRegister;
+
+  // VarDecl declared before expr and visible at expr
+  context->getSymbolTable()->GetLocalVarDeclCandidates(
+      SymbolTable::kArrayVarDecl, context->getFunctionId(), start_loc,
+      *(context->scope_list_), excluded_flags, false, *range);
+}
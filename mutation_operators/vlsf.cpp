@@ -11,9 +11,19 @@ bool VLSF::ValidateRange(const std::set<std::string> &range)
 	return true;
 }
 
+void VLSF::GetTargetKinds(
+		vector<StmtClassRange> &classes,
+		vector<BinaryOperatorKind> &opcodes) const
+{
+	classes.push_back(StmtClassRange(Stmt::firstCallExprConstant,
+	                                 Stmt::lastCallExprConstant));
+}
+
 // Return True if the mutant operator can mutate this expression
 bool VLSF::IsMutationTarget(clang::Expr *e, MusicContext *context)
 {
+	ExprAnalysis &analysis = context->getExprAnalysis(e);
+
 	if (CallExpr *ce = dyn_cast<CallExpr>(e))
 	{
 		SourceLocation start_loc = ce->getLocStart();
@@ -31,7 +41,7 @@ bool VLSF::IsMutationTarget(clang::Expr *e, MusicContext *context)
     // and is scalar type.
 		return (context->IsRangeInMutationRange(SourceRange(start_loc, end_loc)) &&
             !context->getStmtContext().IsInEnumDecl() &&
-						ExprIsScalar(e)) && is_in_domain;
+						analysis.IsScalar()) && is_in_domain;
 	}
 
 	return false;
@@ -39,6 +49,8 @@ bool VLSF::IsMutationTarget(clang::Expr *e, MusicContext *context)
 
 void VLSF::Mutate(clang::Expr *e, MusicContext *context)
 {
+	ExprAnalysis &analysis = context->getExprAnalysis(e);
+
 	CallExpr *ce;
 	if (!(ce = dyn_cast<CallExpr>(e)))
 		return;
@@ -49,84 +61,45 @@ void VLSF::Mutate(clang::Expr *e, MusicContext *context)
   SourceLocation end_loc = ce->getRParenLoc();
   end_loc = end_loc.getLocWithOffset(1);
 
-  Rewriter rewriter;
 	SourceManager &src_mgr = context->comp_inst_->getSourceManager();
-	rewriter.setSourceMgr(src_mgr, context->comp_inst_->getLangOpts());
-
-	string token{ConvertToString(e, context->comp_inst_->getLangOpts())};
 
-	// get all variable declaration that VLSR can mutate this expr to.
-  VarDeclList range(
-  		(*(context->getSymbolTable()->getLocalScalarVarDeclList()))[context->getFunctionId()]);
+	string token{analysis.getToken()};
 
+	// get all variable declaration that VLSF can mutate this expr to.
+  VarDeclCandidateList range;
   GetRange(e, context, &range);
 
-  for (auto vardecl: range)
+  for (auto symbol: range)
   {
-  	string mutated_token{GetVarDeclName(vardecl)};
-
   	// Mutated token is not inside user-specified range.
-  	if (!range_.empty() && range_.find(mutated_token) == range_.end())
+  	if (!range_.empty() && range_.find(symbol->name_) == range_.end())
   		continue;
 
   	context->mutant_database_.AddMutantEntry(
-  			name_, start_loc, end_loc, token, mutated_token, 
+  			name_, start_loc, end_loc, token, symbol->name_, 
   			context->getStmtContext().getProteumStyleLineNum());
   }
 }
 
-void VLSF::GetRange(Expr *e, MusicContext *context, VarDeclList *range)
+void VLSF::GetRange(Expr *e, MusicContext *context,
+                    VarDeclCandidateList *range)
 {
-  SourceLocation start_loc = e->getLocStart();
-  Rewriter rewriter;
-  rewriter.setSourceMgr(context->comp_inst_->getSourceManager(), 
-                        context->comp_inst_->getLangOpts());
+  ExprAnalysis &analysis = context->getExprAnalysis(e);
 
-  string token{ConvertToString(e, context->comp_inst_->getLangOpts())};
+  SourceLocation start_loc = e->getLocStart();
 
 	// cannot mutate variable in switch condition to a floating-type variable
   bool skip_float_vardecl = \
       context->getStmtContext().IsInSwitchStmtConditionRange(e) ||
       context->getStmtContext().IsInNonFloatingExprRange(e);
 
-	// remove all vardecl appear after expr
-	for (auto it = range->begin(); it != range->end(); )
-	{
-		if (!((*it)->getLocStart() < start_loc))
-		{
-			range->erase(it, range->end());
-			break;
-		}
-
-		if (skip_float_vardecl && IsVarDeclFloating(*it))
-		{
-			it = range->erase(it);
-			continue;
-		}
-
-		++it;
-	}
+  unsigned excluded_flags{0};
 
-	for (auto scope: *(context->scope_list_))
-	{
-		// all vardecl after expr are removed.
-		// Hence no need to consider scopes after expr as well.
-		if (LocationBeforeRangeStart(start_loc, scope))
-			break;
-
-		if (!LocationIsInRange(start_loc, scope))
-			for (auto it = range->begin(); it != range->end();)
-			{
-				if (LocationAfterRangeEnd((*it)->getLocStart(), scope))
-					break;
-
-				if (LocationIsInRange((*it)->getLocStart(), scope))
-				{
-					it = range->erase(it);
-					continue;
-				}
-
-				++it;
-			}
-	}
-}
\ No newline at end of file
+  if (skip_float_vardecl)
+    excluded_flags |= VarDeclSymbol::kFloating;
+
+  // VarDecl declared before expr and visible at expr
+  context->getSymbolTable()->GetLocalVarDeclCandidates(
+      SymbolTable::kScalarVarDecl, context->getFunctionId(), start_loc,
+      *(context->scope_list_), excluded_flags, false, *range);
+}
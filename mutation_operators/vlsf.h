@@ -13,13 +13,18 @@ public:
 	virtual bool ValidateDomain(const std::set<std::string> &domain);
 	virtual bool ValidateRange(const std::set<std::string> &range);
 
+	virtual void GetTargetKinds(
+			std::vector<StmtClassRange> &classes,
+			std::vector<clang::BinaryOperatorKind> &opcodes) const;
+
 	// Return True if the mutant operator can mutate this expression
 	virtual bool IsMutationTarget(clang::Expr *e, MusicContext *context);
 
 	virtual void Mutate(clang::Expr *e, MusicContext *context);
 	
 private:
-	void GetRange(clang::Expr *e, MusicContext *context, VarDeclList *range);
+	void GetRange(clang::Expr *e, MusicContext *context,
+								VarDeclCandidateList *range);
 };
 	
 #endif	// MUSIC_VLSF_H_
\ No newline at end of file
@@ -23,142 +23,108 @@ bool VLSR::ValidateRange(const std::set<std::string> &range)
 	// return range.empty();
 }
 
+void VLSR::GetTargetKinds(
+		vector<StmtClassRange> &classes,
+		vector<BinaryOperatorKind> &opcodes) const
+{
+	GetReferenceTargetKinds(classes);
+}
+
 // Return True if the mutant operator can mutate this expression
 bool VLSR::IsMutationTarget(clang::Expr *e, MusicContext *context)
 {
+	ExprAnalysis &analysis = context->getExprAnalysis(e);
+
 	if (!ExprIsScalarReference(e))
 		return false;
 
 	SourceLocation start_loc = e->getLocStart();
-	SourceLocation end_loc = GetEndLocOfExpr(e, context->comp_inst_);
+	SourceLocation end_loc = analysis.getEndLoc();
   StmtContext &stmt_context = context->getStmtContext();
 
   SourceManager &src_mgr = context->comp_inst_->getSourceManager();
-  Rewriter rewriter;
-  rewriter.setSourceMgr(src_mgr, context->comp_inst_->getLangOpts());
 
-  string token{ConvertToString(e, context->comp_inst_->getLangOpts())};
+  string token{analysis.getToken()};
   bool is_in_domain = domain_.empty() ? true : 
                       IsStringElementOfSet(token, domain_);
 
 	// VLSR can mutate this expression only if it is a scalar expression
 	// inside mutation range and NOT inside array decl size or enum declaration
-	return context->IsRangeInMutationRange(SourceRange(start_loc, end_loc)) &&
+	return analysis.IsInMutationRange() &&
          !stmt_context.IsInArrayDeclSize() &&
          !stmt_context.IsInEnumDecl() &&
-         stmt_context.IsInCurrentlyParsedFunctionRange(e) &&
+         analysis.IsInCurrentlyParsedFunctionRange() &&
          is_in_domain;
 }
 
 void VLSR::Mutate(clang::Expr *e, MusicContext *context)
 {
+	ExprAnalysis &analysis = context->getExprAnalysis(e);
+
 	SourceLocation start_loc = e->getLocStart();
-	SourceLocation end_loc = GetEndLocOfExpr(e, context->comp_inst_);
+	SourceLocation end_loc = analysis.getEndLoc();
 
   // cout << start_loc.printToString(context->comp_inst_->getSourceManager()) << endl;
   // cout << e->getLocEnd().printToString(context->comp_inst_->getSourceManager()) << endl;
 
 	SourceManager &src_mgr = context->comp_inst_->getSourceManager();
-	Rewriter rewriter;
-	rewriter.setSourceMgr(src_mgr, context->comp_inst_->getLangOpts());
 
-	string token{ConvertToString(e, context->comp_inst_->getLangOpts())};
+	string token{analysis.getToken()};
 
   // get all variable declaration that VLSR can mutate this expr to.
-  VarDeclList range(
-  		(*(context->getSymbolTable()->getLocalScalarVarDeclList()))[context->getFunctionId()]);
-
+  VarDeclCandidateList range;
   GetRange(e, context, &range);
 
-  for (auto vardecl: range)
+  for (auto symbol: range)
   {
-  	string mutated_token{GetVarDeclName(vardecl)};
+    // Skip the variable of expr itself, and variables not inside
+    // user-specified range (if range is not empty).
+    if (token.compare(symbol->name_) == 0 ||
+        (!range_.empty() && !IsStringElementOfSet(symbol->name_, range_)))
+      continue;
 
-  	// cout << "mutating " << token << " to " << mutated_token << endl;
-  	// PrintLocation(src_mgr, vardecl->getLocStart());
+  	// cout << "mutating " << token << " to " << symbol->name_ << endl;
+  	// PrintLocation(src_mgr, symbol->vardecl_->getLocStart());
 
   	context->mutant_database_.AddMutantEntry(
-        name_, start_loc, end_loc, token, mutated_token, 
+        name_, start_loc, end_loc, token, symbol->name_, 
         context->getStmtContext().getProteumStyleLineNum());
   }
 }
 
-void VLSR::GetRange(Expr *e, MusicContext *context, VarDeclList *range)
+void VLSR::GetRange(Expr *e, MusicContext *context,
+                    VarDeclCandidateList *range)
 {
+  ExprAnalysis &analysis = context->getExprAnalysis(e);
+
   SourceLocation start_loc = e->getLocStart();
-  Rewriter rewriter;
-  rewriter.setSourceMgr(context->comp_inst_->getSourceManager(), 
-                        context->comp_inst_->getLangOpts());
 
-  string token{ConvertToString(e, context->comp_inst_->getLangOpts())};
   StmtContext &stmt_context = context->getStmtContext();
 
 	// cannot mutate variable in switch condition to a floating-type variable
-  bool skip_float_vardecl = stmt_context.IsInSwitchStmtConditionRange(e) ||
-                            stmt_context.IsInArraySubscriptRange(e) ||
-                            stmt_context.IsInNonFloatingExprRange(e);
+  bool skip_float_vardecl = analysis.IsInSwitchStmtConditionRange() ||
+                            analysis.IsInArraySubscriptRange() ||
+                            analysis.IsInNonFloatingExprRange();
 
   // cannot mutate a variable in lhs of assignment to a const variable
-  bool skip_const_vardecl = stmt_context.IsInLhsOfAssignmentRange(e) ||
-  													stmt_context.IsInUnaryIncrementDecrementRange(e);
-
-  bool skip_register_vardecl = stmt_context.IsInAddressOpRange(e);
-
-	// remove all VarDecl appearing after expr, 
-  // const/float/register VarDecl (if necessary) and
-  // VarDecl not inside user-specified range (if range is not empty)
-	for (auto it = range->begin(); it != range->end(); )
-	{
-		if (!((*it)->getLocStart() < start_loc))
-		{
-			range->erase(it, range->end());
-			break;
-		}
-
-    bool is_in_range = range_.empty() ? true :
-                       IsStringElementOfSet(GetVarDeclName(*it), range_);
-
-		if ((skip_const_vardecl && IsVarDeclConst((*it))) ||
-				(skip_float_vardecl && IsVarDeclFloating((*it))) ||
-				(skip_register_vardecl && 
-          (*it)->getStorageClass() == SC_Register) ||
-				(token.compare(GetVarDeclName(*it)) == 0) ||
-        !is_in_range)
-		{
-			it = range->erase(it);
-			continue;
-		}
-
-		++it;
-	}
-
-  // Remove all VarDecl not inside the same scope as expr E.
-	for (auto scope: *(context->scope_list_))
-	{
-		// all vardecl after expr are removed.
-		// No need to consider scopes after expr as well.
-		if (LocationBeforeRangeStart(start_loc, scope))
-			break;
-
-		if (!LocationIsInRange(start_loc, scope))
-			for (auto it = range->begin(); it != range->end();)
-			{
-        // We are only considering variable inside this scope.
-        // The rest of the loop are VarDecl after scope.
-				if (LocationAfterRangeEnd((*it)->getLocStart(), scope))
-					break;
-
-				// Expr E is not inside this scope so we cannot mutate to any variables
-				// declared inside this scope.
-				if (LocationIsInRange((*it)->getLocStart(), scope))
-				{
-					it = range->erase(it);
-					continue;
-				}
-
-				++it;
-			}
-	}
-
-
-}
\ No newline at end of file
+  bool skip_const_vardecl = analysis.IsInLhsOfAssignmentRange() ||
+  													analysis.IsInUnaryIncrementDecrementRange();
+
+  bool skip_register_vardecl = analysis.IsInAddressOpRange();
+
+  unsigned excluded_flags{0};
+
+  if (skip_const_vardecl)
+    excluded_flags |= VarDeclSymbol::kConst;
+
+  if (skip_float_vardecl)
+    excluded_flags |= VarDeclSymbol::kFloating;
+
+  if (skip_register_vardecl)
+    excluded_flags |= VarDeclSymbol::kRegister;
+
+  // VarDecl declared before expr and visible at expr
+  context->getSymbolTable()->GetLocalVarDeclCandidates(
+      SymbolTable::kScalarVarDecl, context->getFunctionId(), start_loc,
+      *(context->scope_list_), excluded_flags, false, *range);
+}
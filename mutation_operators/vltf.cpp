@@ -11,9 +11,19 @@ bool VLTF::ValidateRange(const std::set<std::string> &range)
 	return true;
 }
 
+void VLTF::GetTargetKinds(
+		vector<StmtClassRange> &classes,
+		vector<BinaryOperatorKind> &opcodes) const
+{
+	classes.push_back(StmtClassRange(Stmt::firstCallExprConstant,
+	                                 Stmt::lastCallExprConstant));
+}
+
 // Return True if the mutant operator can mutate this expression
 bool VLTF::IsMutationTarget(clang::Expr *e, MusicContext *context)
 {
+	ExprAnalysis &analysis = context->getExprAnalysis(e);
+
 	if (CallExpr *ce = dyn_cast<CallExpr>(e))
 	{
 		SourceLocation start_loc = ce->getLocStart();
@@ -30,7 +40,7 @@ bool VLTF::IsMutationTarget(clang::Expr *e, MusicContext *context)
     // Return True if expr is in mutation range, NOT inside enum decl
     // and is structure type.
 		return (context->IsRangeInMutationRange(SourceRange(start_loc, end_loc)) &&
-            !context->getStmtContext().IsInEnumDecl() && ExprIsStruct(e)) &&
+            !context->getStmtContext().IsInEnumDecl() && analysis.IsStruct()) &&
             is_in_domain;
 	}
 
@@ -39,6 +49,8 @@ bool VLTF::IsMutationTarget(clang::Expr *e, MusicContext *context)
 
 void VLTF::Mutate(clang::Expr *e, MusicContext *context)
 {
+	ExprAnalysis &analysis = context->getExprAnalysis(e);
+
 	CallExpr *ce;
 	if (!(ce = dyn_cast<CallExpr>(e)))
 		return;
@@ -49,92 +61,51 @@ void VLTF::Mutate(clang::Expr *e, MusicContext *context)
   SourceLocation end_loc = ce->getRParenLoc();
   end_loc = end_loc.getLocWithOffset(1);
 
-  Rewriter rewriter;
 	SourceManager &src_mgr = context->comp_inst_->getSourceManager();
-	rewriter.setSourceMgr(src_mgr, context->comp_inst_->getLangOpts());
-
-	string token{ConvertToString(e, context->comp_inst_->getLangOpts())};
 
-	// get all variable declaration that VLSR can mutate this expr to.
-  VarDeclList range(
-      (*(context->getSymbolTable()->getLocalStructVarDeclList()))[context->getFunctionId()]);
+	string token{analysis.getToken()};
 
+	// get all variable declaration that VLTF can mutate this expr to.
+  VarDeclCandidateList range;
   GetRange(e, context, &range);
 
   string struct_type{
   		getStructureType(e->getType().getCanonicalType())};
 
-  for (auto vardecl: range)
+  for (auto symbol: range)
   {
-    string mutated_token{GetVarDeclName(vardecl)};
-
     // Mutated token is not inside user-specified range.
-    if (!range_.empty() && range_.find(mutated_token) == range_.end())
+    if (!range_.empty() && range_.find(symbol->name_) == range_.end())
       continue;
 
     // Mutate if 2 variable have exactly same structure type
-    if (struct_type.compare(getStructureType(vardecl->getType())) == 0)
+    if (struct_type.compare(symbol->type_) == 0)
     {
       context->mutant_database_.AddMutantEntry(
-          name_, start_loc, end_loc, token, mutated_token, 
+          name_, start_loc, end_loc, token, symbol->name_, 
           context->getStmtContext().getProteumStyleLineNum());
     }
   }
 }
 
-
-
-void VLTF::GetRange(Expr *e, MusicContext *context, VarDeclList *range)
+void VLTF::GetRange(Expr *e, MusicContext *context,
+                    VarDeclCandidateList *range)
 {
+  ExprAnalysis &analysis = context->getExprAnalysis(e);
+
   SourceLocation start_loc = e->getLocStart();
-  Rewriter rewriter;
-  rewriter.setSourceMgr(context->comp_inst_->getSourceManager(), 
-                        context->comp_inst_->getLangOpts());
 
-  string token{ConvertToString(e, context->comp_inst_->getLangOpts())};
-  
   // cannot mutate variable in switch condition to a floating-type variable
   bool skip_float_vardecl = \
       context->getStmtContext().IsInSwitchStmtConditionRange(e);
 
-  // remove all vardecl appear after expr
-  for (auto it = range->begin(); it != range->end(); )
-  {
-    if (!((*it)->getLocStart() < start_loc))
-    {
-      range->erase(it, range->end());
-      break;
-    }
-
-    if (skip_float_vardecl && IsVarDeclFloating(*it))
-    {
-      it = range->erase(it);
-      continue;
-    }
+  unsigned excluded_flags{0};
 
-    ++it;
-  }
+  if (skip_float_vardecl)
+    excluded_flags |= VarDeclSymbol::kFloating;
 
-  for (auto scope: *(context->scope_list_))
-  {
-    // all vardecl after expr are removed.
-    // Hence no need to consider scopes after expr as well.
-    if (LocationBeforeRangeStart(start_loc, scope))
-      break;
-
-    if (!LocationIsInRange(start_loc, scope))
-      for (auto it = range->begin(); it != range->end();)
-      {
-        if (LocationAfterRangeEnd((*it)->getLocStart(), scope))
-          break;
-
-        if (LocationIsInRange((*it)->getLocStart(), scope))
-        {
-          it = range->erase(it);
-          continue;
-        }
-
-        ++it;
-      }
-  }
-}
\ No newline at end of file
+  // VarDecl declared before expr and visible at expr
+  context->getSymbolTable()->GetLocalVarDeclCandidates(
+      SymbolTable::kStructVarDecl, context->getFunctionId(), start_loc,
+      *(context->scope_list_), excluded_flags, false, *range);
+}
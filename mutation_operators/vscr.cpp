@@ -11,24 +11,31 @@ bool VSCR::ValidateRange(const std::set<std::string> &range)
 	return true;
 }
 
+void VSCR::GetTargetKinds(
+		vector<StmtClassRange> &classes,
+		vector<BinaryOperatorKind> &opcodes) const
+{
+	classes.push_back(Stmt::MemberExprClass);
+}
+
 // Return True if the mutant operator can mutate this expression
 bool VSCR::IsMutationTarget(clang::Expr *e, MusicContext *context)
 {
+	ExprAnalysis &analysis = context->getExprAnalysis(e);
+
 	if (MemberExpr *me = dyn_cast<MemberExpr>(e))
 	{
 		SourceLocation start_loc = e->getLocStart();
-		SourceLocation end_loc = GetEndLocOfExpr(e, context->comp_inst_);
+		SourceLocation end_loc = analysis.getEndLoc();
 
     SourceManager &src_mgr = context->comp_inst_->getSourceManager();
-    Rewriter rewriter;
-    rewriter.setSourceMgr(src_mgr, context->comp_inst_->getLangOpts());
 
     string token{
         ConvertToString(me->getBase(), context->comp_inst_->getLangOpts())};
     bool is_in_domain = domain_.empty() ? true : 
                         IsStringElementOfSet(token, domain_);
 
-		return context->IsRangeInMutationRange(SourceRange(start_loc, end_loc)) &&
+		return analysis.IsInMutationRange() &&
            !context->getStmtContext().IsInEnumDecl() &&
 				   !context->getStmtContext().IsInArrayDeclSize() && is_in_domain;
 	}
@@ -38,6 +45,8 @@ bool VSCR::IsMutationTarget(clang::Expr *e, MusicContext *context)
 
 void VSCR::Mutate(clang::Expr *e, MusicContext *context)
 {
+	ExprAnalysis &analysis = context->getExprAnalysis(e);
+
 	MemberExpr *me;
 	if (!(me = dyn_cast<MemberExpr>(e)))
 		return;
@@ -54,7 +63,7 @@ void VSCR::Mutate(clang::Expr *e, MusicContext *context)
 
   string token{me->getMemberDecl()->getNameAsString()};
   SourceLocation start_loc = me->getMemberLoc();
-  SourceLocation end_loc = GetEndLocOfExpr(e, context->comp_inst_);
+  SourceLocation end_loc = analysis.getEndLoc();
 
   SourceManager &src_mgr = context->comp_inst_->getSourceManager();
 
@@ -83,8 +92,8 @@ void VSCR::Mutate(clang::Expr *e, MusicContext *context)
   }
 
   StmtContext &stmt_context = context->getStmtContext();
-  bool skip_float_literal = stmt_context.IsInNonFloatingExprRange(e) ||
-                            stmt_context.IsInSwitchStmtConditionRange(e);
+  bool skip_float_literal = analysis.IsInNonFloatingExprRange() ||
+                            analysis.IsInSwitchStmtConditionRange();
 
   if (auto rt = dyn_cast<RecordType>(base_type.getTypePtr()))
   {
@@ -14,22 +14,27 @@ bool VTWD::ValidateRange(const std::set<std::string> &range)
 					range.find("minusone") != range.end()));
 }
 
+void VTWD::GetTargetKinds(
+		vector<StmtClassRange> &classes,
+		vector<BinaryOperatorKind> &opcodes) const
+{
+	GetReferenceTargetKinds(classes);
+}
+
 // Return True if the mutant operator can mutate this expression
 bool VTWD::IsMutationTarget(clang::Expr *e, MusicContext *context)
 {
+	ExprAnalysis &analysis = context->getExprAnalysis(e);
+
 	if (!ExprIsScalarReference(e))
 		return false;
 
 	SourceLocation start_loc = e->getLocStart();
-	SourceLocation end_loc = GetEndLocOfExpr(e, context->comp_inst_);
+	SourceLocation end_loc = analysis.getEndLoc();
 
-	Rewriter rewriter;
-	rewriter.setSourceMgr(
-			context->comp_inst_->getSourceManager(),
-			context->comp_inst_->getLangOpts());
 	StmtContext &stmt_context = context->getStmtContext();
 
-	string token{ConvertToString(e, context->comp_inst_->getLangOpts())};
+	string token{analysis.getToken()};
 	bool is_in_domain = domain_.empty() ? true : 
                       IsStringElementOfSet(token, domain_);
 
@@ -38,27 +43,24 @@ bool VTWD::IsMutationTarget(clang::Expr *e, MusicContext *context)
 	// 		- not inside enum decl
 	// 		- not on lhs of assignment (a+1=a -> uncompilable)
 	// 		- not inside unary increment/decrement/addressop
-	return context->IsRangeInMutationRange(SourceRange(start_loc, end_loc)) &&
+	return analysis.IsInMutationRange() &&
          !stmt_context.IsInEnumDecl() &&
-				 !stmt_context.IsInLhsOfAssignmentRange(e) &&
-				 !stmt_context.IsInAddressOpRange(e) && is_in_domain &&
-				 !stmt_context.IsInUnaryIncrementDecrementRange(e) &&
-				 IsMutationTarget(
-				 		ConvertToString(e, context->comp_inst_->getLangOpts()), context);
+				 !analysis.IsInLhsOfAssignmentRange() &&
+				 !analysis.IsInAddressOpRange() && is_in_domain &&
+				 !analysis.IsInUnaryIncrementDecrementRange() &&
+				 IsUnblockedScalarRef(e, context);
 }
 
 
 
 void VTWD::Mutate(clang::Expr *e, MusicContext *context)
 {
+	ExprAnalysis &analysis = context->getExprAnalysis(e);
+
 	SourceLocation start_loc = e->getLocStart();
-	SourceLocation end_loc = GetEndLocOfExpr(e, context->comp_inst_);
+	SourceLocation end_loc = analysis.getEndLoc();
 
-	Rewriter rewriter;
-	rewriter.setSourceMgr(
-			context->comp_inst_->getSourceManager(),
-			context->comp_inst_->getLangOpts());
-	string token{ConvertToString(e, context->comp_inst_->getLangOpts())};
+	string token{analysis.getToken()};
 
 	if (range_.empty() || 
 			(!range_.empty() && range_.find("plusone") != range_.end()))
@@ -83,18 +85,8 @@ void VTWD::Mutate(clang::Expr *e, MusicContext *context)
 
 
 
-bool VTWD::IsMutationTarget(std::string scalarref_name, MusicContext *context)
+bool VTWD::IsUnblockedScalarRef(const Expr *e, MusicContext *context)
 {
-	// if reference name is in the nonMutatableList then it is not mutatable
-	ScalarReferenceNameList *scalarref_list = \
-			context->non_VTWD_mutatable_scalarref_list_;
-
-  for (auto it = (*scalarref_list).begin(); it != (*scalarref_list).end(); ++it)
-    if (scalarref_name.compare(*it) == 0)
-    {
-    	scalarref_list->erase(it);
-      return false;
-    }
-
-  return true;
-}
\ No newline at end of file
+	// each blocked reference is visited once, so it can be removed
+	return context->non_VTWD_mutatable_scalarref_set_->erase(e) == 0;
+}
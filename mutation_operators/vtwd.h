@@ -13,13 +13,19 @@ public:
 	virtual bool ValidateDomain(const std::set<std::string> &domain);
 	virtual bool ValidateRange(const std::set<std::string> &range);
 
+	virtual void GetTargetKinds(
+			std::vector<StmtClassRange> &classes,
+			std::vector<clang::BinaryOperatorKind> &opcodes) const;
+
 	// Return True if the mutant operator can mutate this expression
 	virtual bool IsMutationTarget(clang::Expr *e, MusicContext *context);
 
 	virtual void Mutate(clang::Expr *e, MusicContext *context);
 
 private:
-	bool IsMutationTarget(std::string scalarref_name, MusicContext *context);
+	// Return False if e is blocked to avoid a redundant VTWD mutant,
+	// and unblock it.
+	bool IsUnblockedScalarRef(const clang::Expr *e, MusicContext *context);
 };
 
 #endif	// MUSIC_VTWD_H_
\ No newline at end of file
@@ -12,9 +12,19 @@ bool VTWF::ValidateRange(const std::set<std::string> &range)
 }
 
 
+void VTWF::GetTargetKinds(
+		vector<StmtClassRange> &classes,
+		vector<BinaryOperatorKind> &opcodes) const
+{
+	classes.push_back(StmtClassRange(Stmt::firstCallExprConstant,
+	                                 Stmt::lastCallExprConstant));
+}
+
 // Return True if the mutant operator can mutate this expression
 bool VTWF::IsMutationTarget(clang::Expr *e, MusicContext *context)
 {
+	ExprAnalysis &analysis = context->getExprAnalysis(e);
+
 	if (CallExpr *ce = dyn_cast<CallExpr>(e))
 	{
 		SourceLocation start_loc = ce->getLocStart();
@@ -41,7 +51,7 @@ bool VTWF::IsMutationTarget(clang::Expr *e, MusicContext *context)
     // Return True if expr is in mutation range, NOT inside enum decl
     // and is scalar type.
 		return (context->IsRangeInMutationRange(SourceRange(start_loc, end_loc)) &&
-            !context->getStmtContext().IsInEnumDecl() && ExprIsScalar(e)) &&
+            !context->getStmtContext().IsInEnumDecl() && analysis.IsScalar()) &&
 						is_in_domain;
 	}
 
@@ -50,6 +60,8 @@ bool VTWF::IsMutationTarget(clang::Expr *e, MusicContext *context)
 
 void VTWF::Mutate(clang::Expr *e, MusicContext *context)
 {
+	ExprAnalysis &analysis = context->getExprAnalysis(e);
+
 	CallExpr *ce;
 	if (!(ce = dyn_cast<CallExpr>(e)))
 		return;
@@ -60,11 +72,9 @@ void VTWF::Mutate(clang::Expr *e, MusicContext *context)
   SourceLocation end_loc = ce->getRParenLoc();
   end_loc = end_loc.getLocWithOffset(1);
 
-  Rewriter rewriter;
 	SourceManager &src_mgr = context->comp_inst_->getSourceManager();
-	rewriter.setSourceMgr(src_mgr, context->comp_inst_->getLangOpts());
 
-	string token{ConvertToString(e, context->comp_inst_->getLangOpts())};
+	string token{analysis.getToken()};
 
 	if (range_.empty() ||
 			(!range_.empty() && range_.find("plusone") != range_.end()))
@@ -0,0 +1,96 @@
+#include "music_utility.h"
+#include "operator_dispatch_table.h"
+
+namespace {
+
+const size_t kNumStmtClasses = Stmt::lastStmtConstant + 1;
+const size_t kNumBinaryOpcodes = BO_Comma + 1;
+
+// Return whether each Stmt class is in classes. No class means all of them.
+vector<bool> GetTargetedClasses(const vector<StmtClassRange> &classes)
+{
+  vector<bool> targeted(kNumStmtClasses, classes.empty());
+
+  for (auto &range: classes)
+    for (size_t stmt_class = range.first_; stmt_class <= range.last_;
+         stmt_class++)
+      targeted[stmt_class] = true;
+
+  return targeted;
+}
+
+bool IsBinaryOperatorClass(size_t stmt_class)
+{
+  return stmt_class >= Stmt::firstBinaryOperatorConstant &&
+         stmt_class <= Stmt::lastBinaryOperatorConstant;
+}
+
+}  // namespace
+
+OperatorDispatchTable::OperatorDispatchTable(
+    const vector<StmtMutantOperator*> &stmt_operator_list,
+    const vector<ExprMutantOperator*> &expr_operator_list)
+  : stmt_operators_by_class_(kNumStmtClasses),
+    expr_operators_by_class_(kNumStmtClasses),
+    expr_operators_by_opcode_(kNumBinaryOpcodes)
+{
+  for (auto mutant_operator: stmt_operator_list)
+  {
+    vector<StmtClassRange> classes;
+    mutant_operator->GetTargetClasses(classes);
+
+    vector<bool> targeted = GetTargetedClasses(classes);
+
+    for (size_t stmt_class = 0; stmt_class < kNumStmtClasses; stmt_class++)
+      if (targeted[stmt_class])
+        stmt_operators_by_class_[stmt_class].push_back(mutant_operator);
+  }
+
+  for (auto mutant_operator: expr_operator_list)
+  {
+    vector<StmtClassRange> classes;
+    vector<BinaryOperatorKind> opcodes;
+    mutant_operator->GetTargetKinds(classes, opcodes);
+
+    vector<bool> targeted = GetTargetedClasses(classes);
+    bool targets_binary_operator = false;
+
+    for (size_t stmt_class = 0; stmt_class < kNumStmtClasses; stmt_class++)
+    {
+      if (!targeted[stmt_class])
+        continue;
+
+      if (IsBinaryOperatorClass(stmt_class))
+        targets_binary_operator = true;
+      else
+        expr_operators_by_class_[stmt_class].push_back(mutant_operator);
+    }
+
+    if (!targets_binary_operator)
+      continue;
+
+    vector<bool> targeted_opcodes(kNumBinaryOpcodes, opcodes.empty());
+
+    for (auto opcode: opcodes)
+      targeted_opcodes[opcode] = true;
+
+    for (size_t opcode = 0; opcode < kNumBinaryOpcodes; opcode++)
+      if (targeted_opcodes[opcode])
+        expr_operators_by_opcode_[opcode].push_back(mutant_operator);
+  }
+}
+
+const vector<StmtMutantOperator*>& OperatorDispatchTable::getStmtOperators(
+    Stmt *s) const
+{
+  return stmt_operators_by_class_[s->getStmtClass()];
+}
+
+const vector<ExprMutantOperator*>& OperatorDispatchTable::getExprOperators(
+    Expr *e) const
+{
+  if (BinaryOperator *bo = dyn_cast<BinaryOperator>(e))
+    return expr_operators_by_opcode_[bo->getOpcode()];
+
+  return expr_operators_by_class_[e->getStmtClass()];
+}
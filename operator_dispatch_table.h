@@ -0,0 +1,37 @@
+#ifndef MUSIC_OPERATOR_DISPATCH_TABLE_H_
+#define MUSIC_OPERATOR_DISPATCH_TABLE_H_
+
+#include <vector>
+
+#include "clang/AST/Expr.h"
+#include "clang/AST/Stmt.h"
+
+#include "mutation_operators/expr_mutant_operator.h"
+#include "mutation_operators/stmt_mutant_operator.h"
+
+/**
+  Enabled mutation operators indexed by the kind of AST node they declare
+  they can mutate (see ExprMutantOperator::GetTargetKinds and
+  StmtMutantOperator::GetTargetClasses), so that the visitor only asks the
+  operators interested in a node. Binary operators are indexed by opcode,
+  other nodes by Stmt class. Operators keep their order in the given lists.
+*/
+class OperatorDispatchTable
+{
+public:
+  OperatorDispatchTable(
+      const std::vector<StmtMutantOperator*> &stmt_operator_list,
+      const std::vector<ExprMutantOperator*> &expr_operator_list);
+
+  const std::vector<StmtMutantOperator*>& getStmtOperators(
+      clang::Stmt *s) const;
+  const std::vector<ExprMutantOperator*>& getExprOperators(
+      clang::Expr *e) const;
+
+private:
+  std::vector<std::vector<StmtMutantOperator*>> stmt_operators_by_class_;
+  std::vector<std::vector<ExprMutantOperator*>> expr_operators_by_class_;
+  std::vector<std::vector<ExprMutantOperator*>> expr_operators_by_opcode_;
+};
+
+#endif  // MUSIC_OPERATOR_DISPATCH_TABLE_H_
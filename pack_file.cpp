@@ -0,0 +1,321 @@
+#include <algorithm>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <zlib.h>
+
+#include "pack_file.h"
+
+namespace {
+
+// Return true if [offset, offset + count * elem_size) lies within size.
+bool SectionFits(uint64_t offset, uint64_t count, uint64_t elem_size,
+                 uint64_t size)
+{
+  if (offset > size)
+    return false;
+
+  return count <= (size - offset) / elem_size;
+}
+
+}  // namespace
+
+PackFileWriter::PackFileWriter(std::string pack_filename, bool compressed)
+  : out_(pack_filename.data(), std::ios::binary | std::ios::trunc),
+    compressed_(compressed), failed_(false), size_(0)
+{
+  if (!out_.is_open())
+  {
+    failed_ = true;
+    return;
+  }
+
+  PackHeader header;
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic_, kPackMagic, sizeof(kPackMagic));
+  header.version_ = kPackVersion;
+  header.endian_tag_ = kPackEndianTag;
+  header.flags_ = compressed_ ? kPackCompressed : 0;
+
+  out_.write(reinterpret_cast<const char *>(&header), sizeof(header));
+  size_ = sizeof(header);
+}
+
+PackFileWriter::~PackFileWriter()
+{
+  Close();
+}
+
+bool PackFileWriter::IsOpen() const
+{
+  return out_.is_open();
+}
+
+bool PackFileWriter::AddMember(uint64_t mutant_id, const std::string &name,
+                               const std::string &content)
+{
+  if (!out_.is_open() || failed_)
+    return false;
+
+  PackIndexEntry entry;
+  entry.mutant_id_ = mutant_id;
+  entry.name_ = name_pool_.size();
+  entry.reserved_ = 0;
+  entry.offset_ = size_;
+  entry.size_ = content.size();
+
+  uint32_t length = name.size();
+  name_pool_.append(reinterpret_cast<const char *>(&length), sizeof(length));
+  name_pool_ += name;
+  name_pool_ += '\0';
+
+  if (compressed_)
+  {
+    uLongf stored_size = compressBound(content.size());
+    std::vector<Bytef> stored(stored_size);
+
+    if (compress2(stored.data(), &stored_size,
+                  reinterpret_cast<const Bytef *>(content.data()),
+                  content.size(), Z_DEFAULT_COMPRESSION) != Z_OK)
+    {
+      failed_ = true;
+      return false;
+    }
+
+    out_.write(reinterpret_cast<const char *>(stored.data()), stored_size);
+    entry.stored_size_ = stored_size;
+  }
+  else
+  {
+    out_.write(content.data(), content.size());
+    entry.stored_size_ = content.size();
+  }
+
+  // E.g. the disk is full. The offsets of later members would be wrong.
+  if (!out_)
+  {
+    failed_ = true;
+    return false;
+  }
+
+  size_ += entry.stored_size_;
+  index_.push_back(entry);
+  return true;
+}
+
+bool PackFileWriter::Close()
+{
+  if (!out_.is_open())
+    return !failed_;
+
+  // Without index and trailer, readers reject the incomplete pack.
+  if (failed_)
+  {
+    out_.close();
+    index_.clear();
+    name_pool_.clear();
+    return false;
+  }
+
+  // Index entries hold 64-bit fields and are read in place.
+  while (size_ % alignof(PackIndexEntry) != 0)
+  {
+    out_.put('\0');
+    size_++;
+  }
+
+  // Stable, so members with the same id are found in the order added.
+  std::stable_sort(index_.begin(), index_.end(),
+                   [](const PackIndexEntry &a, const PackIndexEntry &b)
+                   { return a.mutant_id_ < b.mutant_id_; });
+
+  PackTrailer trailer;
+  memset(&trailer, 0, sizeof(trailer));
+  trailer.index_offset_ = size_;
+  trailer.name_pool_offset_ = size_ + index_.size() * sizeof(PackIndexEntry);
+  trailer.name_pool_size_ = name_pool_.size();
+  trailer.member_count_ = index_.size();
+  memcpy(trailer.magic_, kPackMagic, sizeof(kPackMagic));
+
+  out_.write(reinterpret_cast<const char *>(index_.data()),
+             index_.size() * sizeof(PackIndexEntry));
+  out_.write(name_pool_.data(), name_pool_.size());
+  out_.write(reinterpret_cast<const char *>(&trailer), sizeof(trailer));
+  out_.close();
+
+  if (out_.fail())
+    failed_ = true;
+
+  index_.clear();
+  name_pool_.clear();
+  return !failed_;
+}
+
+PackFile::PackFile()
+  : data_(nullptr), size_(0), header_(nullptr), index_(nullptr),
+    name_pool_(nullptr)
+{
+  memset(&trailer_, 0, sizeof(trailer_));
+}
+
+PackFile::~PackFile()
+{
+  Close();
+}
+
+bool PackFile::Open(const std::string &filename)
+{
+  Close();
+
+  int fd = open(filename.data(), O_RDONLY);
+
+  if (fd < 0)
+    return false;
+
+  struct stat file_stat;
+
+  if (fstat(fd, &file_stat) != 0 ||
+      static_cast<size_t>(file_stat.st_size) <
+      sizeof(PackHeader) + sizeof(PackTrailer))
+  {
+    close(fd);
+    return false;
+  }
+
+  void *mapping = mmap(nullptr, file_stat.st_size, PROT_READ, MAP_SHARED,
+                       fd, 0);
+  close(fd);
+
+  if (mapping == MAP_FAILED)
+    return false;
+
+  data_ = static_cast<const char *>(mapping);
+  size_ = file_stat.st_size;
+  header_ = reinterpret_cast<const PackHeader *>(data_);
+
+  // The trailer follows the name pool, so it is copied out rather than
+  // read in place.
+  memcpy(&trailer_, data_ + size_ - sizeof(PackTrailer), sizeof(trailer_));
+
+  if (!Validate())
+  {
+    Close();
+    return false;
+  }
+
+  index_ = reinterpret_cast<const PackIndexEntry *>(
+      data_ + trailer_.index_offset_);
+  name_pool_ = data_ + trailer_.name_pool_offset_;
+  return true;
+}
+
+void PackFile::Close()
+{
+  if (data_ != nullptr)
+    munmap(const_cast<char *>(data_), size_);
+
+  data_ = nullptr;
+  size_ = 0;
+  header_ = nullptr;
+  memset(&trailer_, 0, sizeof(trailer_));
+  index_ = nullptr;
+  name_pool_ = nullptr;
+}
+
+bool PackFile::Validate() const
+{
+  if (memcmp(header_->magic_, kPackMagic, sizeof(kPackMagic)) != 0 ||
+      memcmp(trailer_.magic_, kPackMagic, sizeof(kPackMagic)) != 0 ||
+      header_->version_ != kPackVersion ||
+      header_->endian_tag_ != kPackEndianTag)
+    return false;
+
+  uint64_t data_end = size_ - sizeof(PackTrailer);
+
+  if (trailer_.index_offset_ % alignof(PackIndexEntry) != 0 ||
+      !SectionFits(trailer_.index_offset_, trailer_.member_count_,
+                   sizeof(PackIndexEntry), data_end) ||
+      !SectionFits(trailer_.name_pool_offset_, trailer_.name_pool_size_, 1,
+                   data_end))
+    return false;
+
+  const PackIndexEntry *index = reinterpret_cast<const PackIndexEntry *>(
+      data_ + trailer_.index_offset_);
+
+  for (uint32_t i = 0; i < trailer_.member_count_; i++)
+    if (!SectionFits(index[i].offset_, index[i].stored_size_, 1,
+                     trailer_.index_offset_))
+      return false;
+
+  return true;
+}
+
+uint32_t PackFile::getMemberCount() const
+{
+  return trailer_.member_count_;
+}
+
+const PackIndexEntry& PackFile::getMember(uint32_t member_idx) const
+{
+  return index_[member_idx];
+}
+
+const char* PackFile::getName(const PackIndexEntry &member) const
+{
+  uint64_t pool_size = trailer_.name_pool_size_;
+
+  // Length prefix and terminating '\0' must lie within the pool.
+  if (pool_size < sizeof(uint32_t) ||
+      member.name_ > pool_size - sizeof(uint32_t))
+    return "";
+
+  uint32_t length;
+  memcpy(&length, name_pool_ + member.name_, sizeof(length));
+
+  if (length >= pool_size - member.name_ - sizeof(uint32_t))
+    return "";
+
+  return name_pool_ + member.name_ + sizeof(uint32_t);
+}
+
+const PackIndexEntry* PackFile::FindById(uint64_t mutant_id) const
+{
+  const PackIndexEntry *end = index_ + getMemberCount();
+  const PackIndexEntry *it = std::lower_bound(
+      index_, end, mutant_id,
+      [](const PackIndexEntry &member, uint64_t id)
+      { return member.mutant_id_ < id; });
+
+  if (it == end || it->mutant_id_ != mutant_id)
+    return nullptr;
+
+  return it;
+}
+
+bool PackFile::Extract(const PackIndexEntry &member,
+                       std::string &content) const
+{
+  const char *stored = data_ + member.offset_;
+
+  if (!(header_->flags_ & kPackCompressed))
+  {
+    if (member.stored_size_ != member.size_)
+      return false;
+
+    content.assign(stored, member.size_);
+    return true;
+  }
+
+  content.resize(member.size_);
+  uLongf size = member.size_;
+
+  // uncompress needs a non-null destination even for empty content.
+  Bytef empty;
+  Bytef *dest = size > 0 ? reinterpret_cast<Bytef *>(&content[0]) : &empty;
+
+  return uncompress(dest, &size, reinterpret_cast<const Bytef *>(stored),
+                    member.stored_size_) == Z_OK &&
+         size == member.size_;
+}
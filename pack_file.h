@@ -0,0 +1,139 @@
+#ifndef MUSIC_PACK_FILE_H_
+#define MUSIC_PACK_FILE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+/**
+  Layout of <name>_mut.pack, written with option -pack: the full mutant
+  files of one input file in a single archive. Mutants are appended as they
+  are exported, and the index is written once at the end, so a reader finds
+  it from the trailer at the end of the file. All numbers are in host byte
+  order, as in the indexed mutant database.
+
+    PackHeader
+    member data                     content of each mutant file in the
+                                    order added, zlib-compressed if flags_
+                                    has kPackCompressed
+    PackIndexEntry x member_count_  sorted by mutant id, 8-byte aligned
+    name pool                       each mutant filename stored as
+                                    uint32_t length + bytes + '\0'
+    PackTrailer
+
+  The name of a member is the name the mutant file would have in the output
+  directory (e.g. test.MUT12.c, or SSDL/0/test.MUT12.c with -layout
+  sharded), as recorded in the mutation database.
+*/
+
+const char kPackMagic[8] = {'M', 'U', 'S', 'I', 'C', 'P', 'A', 'K'};
+const uint32_t kPackVersion = 2;
+const uint32_t kPackEndianTag = 0x01020304;
+
+// Flags of PackHeader.
+const uint32_t kPackCompressed = 1;
+
+struct PackHeader
+{
+  char magic_[8];
+  uint32_t version_;
+  uint32_t endian_tag_;
+  uint32_t flags_;
+  uint32_t reserved_;
+};
+
+/**
+  @param  mutant_id_ number of mutant within its input file
+          name_ offset of mutant filename in name pool
+          offset_ offset of member data in pack file
+          stored_size_ size of member data in pack file
+          size_ size of mutant file
+*/
+struct PackIndexEntry
+{
+  uint64_t mutant_id_;
+  uint32_t name_;
+  uint32_t reserved_;
+  uint64_t offset_;
+  uint64_t stored_size_;
+  uint64_t size_;
+};
+
+struct PackTrailer
+{
+  uint64_t index_offset_;
+  uint64_t name_pool_offset_;
+  uint64_t name_pool_size_;
+  uint32_t member_count_;
+  uint32_t reserved_;
+  char magic_[8];
+};
+
+class PackFileWriter
+{
+public:
+  PackFileWriter(std::string pack_filename, bool compressed);
+  ~PackFileWriter();
+
+  bool IsOpen() const;
+
+  // Return false if content cannot be compressed or written. The pack is
+  // then incomplete, and Close also returns false.
+  bool AddMember(uint64_t mutant_id, const std::string &name,
+                 const std::string &content);
+
+  // Write index and trailer. Nothing can be added afterwards. Return false
+  // if the pack file is not completely written.
+  bool Close();
+
+private:
+  std::ofstream out_;
+  bool compressed_;
+  bool failed_;
+  uint64_t size_;
+  std::vector<PackIndexEntry> index_;
+  std::string name_pool_;
+};
+
+/**
+  Read-only view of a pack file. The file is mapped into memory, so opening
+  only reads the trailer and header, and a member is found by binary search
+  over the index.
+*/
+class PackFile
+{
+public:
+  PackFile();
+  ~PackFile();
+
+  // Return false if file cannot be mapped or is not a valid pack file.
+  bool Open(const std::string &filename);
+  void Close();
+
+  uint32_t getMemberCount() const;
+  const PackIndexEntry& getMember(uint32_t member_idx) const;
+
+  // Return name of member. The pointer is valid until Close.
+  const char* getName(const PackIndexEntry &member) const;
+
+  // Return nullptr if there is no mutant with given id.
+  const PackIndexEntry* FindById(uint64_t mutant_id) const;
+
+  // Return false if member data is corrupted.
+  bool Extract(const PackIndexEntry &member, std::string &content) const;
+
+private:
+  const char *data_;
+  size_t size_;
+
+  const PackHeader *header_;
+  PackTrailer trailer_;
+  const PackIndexEntry *index_;
+  const char *name_pool_;
+
+  bool Validate() const;
+};
+
+#endif  // MUSIC_PACK_FILE_H_
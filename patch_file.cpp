@@ -0,0 +1,169 @@
+#include <cerrno>
+#include <sstream>
+#include <sys/stat.h>
+
+#include "patch_file.h"
+
+namespace {
+
+const char kPatchFileMagic[] = "MUSIC-PATCH 2";
+
+// Write str followed by a newline. Its size is written before.
+void WriteSizedString(std::ostream &out, const std::string &str)
+{
+  out.write(str.data(), str.length());
+  out << "\n";
+}
+
+// Read size bytes followed by a newline. Sizes are read from the file, so
+// they are checked against the rest of the file (of file_size bytes)
+// before anything is allocated.
+bool ReadSizedString(std::istream &in, uint64_t file_size, uint64_t size,
+                     std::string &str)
+{
+  std::streamoff pos = in.tellg();
+
+  if (pos < 0 || size >= file_size - static_cast<uint64_t>(pos))
+    return false;
+
+  str.resize(size);
+  in.read(&str[0], size);
+
+  return in.gcount() == static_cast<std::streamsize>(size) &&
+         in.get() == '\n';
+}
+
+}  // namespace
+
+PatchFileWriter::PatchFileWriter(std::string patch_filename,
+                                 const PatchFileHeader &header)
+  : out_(patch_filename.data(), std::ios::trunc | std::ios::binary)
+{
+  if (!out_.is_open())
+    return;
+
+  out_ << kPatchFileMagic << "\n";
+  out_ << header.original_filename_.length() << " "
+       << header.original_size_ << " " << header.original_hash_ << "\n";
+  WriteSizedString(out_, header.original_filename_);
+}
+
+PatchFileWriter::~PatchFileWriter()
+{
+  out_.close();
+}
+
+bool PatchFileWriter::IsOpen() const
+{
+  return out_.is_open();
+}
+
+void PatchFileWriter::WriteRecord(const PatchRecord &record)
+{
+  out_ << record.mutant_filename_.length() << " " << record.offset_ << " "
+       << record.length_ << " " << record.replacement_.length() << "\n";
+  WriteSizedString(out_, record.mutant_filename_);
+  WriteSizedString(out_, record.replacement_);
+}
+
+uint64_t HashFileContent(const std::string &content)
+{
+  uint64_t hash = 14695981039346656037ULL;
+
+  for (unsigned char c: content)
+  {
+    hash ^= c;
+    hash *= 1099511628211ULL;
+  }
+
+  return hash;
+}
+
+bool ReadWholeFile(const std::string &filename, std::string &content)
+{
+  std::ifstream in(filename.data(), std::ios::binary);
+
+  if (!in.is_open())
+    return false;
+
+  std::ostringstream buffer;
+  buffer << in.rdbuf();
+  content = buffer.str();
+  return true;
+}
+
+bool CreateParentDirectories(const std::string &filename)
+{
+  size_t end = filename.find('/', 1);
+
+  for (; end != std::string::npos; end = filename.find('/', end + 1))
+    if (mkdir(filename.substr(0, end).data(), 0755) != 0 && errno != EEXIST)
+      return false;
+
+  return true;
+}
+
+bool ReadPatchFile(const std::string &patch_filename, PatchFileHeader &header,
+                   std::vector<PatchRecord> &records)
+{
+  std::ifstream in(patch_filename.data(), std::ios::binary);
+
+  if (!in.is_open())
+    return false;
+
+  in.seekg(0, std::ios::end);
+  uint64_t file_size = in.tellg();
+  in.seekg(0, std::ios::beg);
+
+  std::string line;
+  if (!std::getline(in, line) || line != kPatchFileMagic)
+    return false;
+
+  if (!std::getline(in, line))
+    return false;
+
+  std::istringstream header_line(line);
+  uint64_t original_filename_size;
+
+  if (!(header_line >> original_filename_size >> header.original_size_
+                    >> header.original_hash_) ||
+      !ReadSizedString(in, file_size, original_filename_size,
+                       header.original_filename_))
+    return false;
+
+  while (std::getline(in, line))
+  {
+    std::istringstream record_line(line);
+    PatchRecord record;
+    uint64_t mutant_filename_size;
+    uint64_t replacement_size;
+
+    if (!(record_line >> mutant_filename_size >> record.offset_
+                      >> record.length_ >> replacement_size) ||
+        !ReadSizedString(in, file_size, mutant_filename_size,
+                         record.mutant_filename_) ||
+        !ReadSizedString(in, file_size, replacement_size,
+                         record.replacement_))
+      return false;
+
+    records.push_back(record);
+  }
+
+  return true;
+}
+
+bool ApplyPatchRecord(const std::string &original, const PatchRecord &record,
+                      std::string &mutant)
+{
+  if (record.offset_ > original.length() ||
+      record.length_ > original.length() - record.offset_)
+    return false;
+
+  mutant.clear();
+  mutant.reserve(original.length() - record.length_ +
+                 record.replacement_.length());
+  mutant.append(original, 0, record.offset_);
+  mutant.append(record.replacement_);
+  mutant.append(original, record.offset_ + record.length_, std::string::npos);
+  return true;
+}
@@ -0,0 +1,106 @@
+#ifndef MUSIC_PATCH_FILE_H_
+#define MUSIC_PATCH_FILE_H_
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+/**
+  A single mutant recorded as an edit against the original input file:
+  replace `length` bytes starting at byte `offset` with `replacement`.
+
+  @param  mutant_filename_ name the mutant would have as a full source file
+                           (e.g. test.MUT12.c)
+          offset_ byte offset of the mutated token in the original file
+          length_ number of bytes of the original token
+          replacement_ mutated token
+*/
+struct PatchRecord
+{
+  std::string mutant_filename_;
+  uint64_t offset_;
+  uint64_t length_;
+  std::string replacement_;
+};
+
+/**
+  Header of a patch file. Identifies the original file the edits apply to,
+  so that an applier can refuse to patch a file that has changed since
+  mutants were generated.
+
+  @param  original_filename_ name of input file
+          original_size_ size in bytes of input file
+          original_hash_ FNV-1a hash of input file content
+*/
+struct PatchFileHeader
+{
+  std::string original_filename_;
+  uint64_t original_size_;
+  uint64_t original_hash_;
+};
+
+/**
+  Patch file layout (all numbers in decimal):
+
+    MUSIC-PATCH 2
+    <original filename size> <original size> <original hash>
+    <original filename bytes>
+    <mutant filename size> <offset> <length> <replacement size>
+    <mutant filename bytes>
+    <replacement bytes>
+    ... (one 3-line record per mutant)
+
+  Filenames and replacements are length-prefixed, so they may contain any
+  byte including spaces and newlines. Each of them is followed by a single
+  newline.
+*/
+class PatchFileWriter
+{
+public:
+  PatchFileWriter(std::string patch_filename,
+                  const PatchFileHeader &header);
+  ~PatchFileWriter();
+
+  bool IsOpen() const;
+  void WriteRecord(const PatchRecord &record);
+
+private:
+  std::ofstream out_;
+};
+
+// Return FNV-1a hash of given content.
+uint64_t HashFileContent(const std::string &content);
+
+// Read whole file into content. Return false if file cannot be opened.
+bool ReadWholeFile(const std::string &filename, std::string &content);
+
+// Create the missing directories of path to filename, as mkdir -p.
+// Return false if one cannot be created.
+bool CreateParentDirectories(const std::string &filename);
+
+/**
+  Read all records of a patch file.
+
+  @param  patch_filename path to patch file
+          header output header of patch file
+          records output list of records in file order
+  @return True if the patch file was read successfully
+          False if it cannot be opened or is malformed
+*/
+bool ReadPatchFile(const std::string &patch_filename, PatchFileHeader &header,
+                   std::vector<PatchRecord> &records);
+
+/**
+  Apply an edit to the original content.
+
+  @param  original content of original file
+          record edit to apply
+          mutant output mutated content
+  @return True if the edit lies within the original content
+          False otherwise
+*/
+bool ApplyPatchRecord(const std::string &original, const PatchRecord &record,
+                      std::string &mutant);
+
+#endif  // MUSIC_PATCH_FILE_H_
@@ -0,0 +1,294 @@
+#include <errno.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "music_runtime.h"
+
+#define MUSIC_MAX_SCHEMAS 1024
+#define MUSIC_MAX_FILENAME 4096
+
+struct music_schema
+{
+  const char *filename;
+  unsigned long long *mutant_id;
+  const unsigned long long *ids;
+  int num_ids;
+};
+
+/* Filled by schema file constructors, before main. */
+static struct music_schema schemas[MUSIC_MAX_SCHEMAS];
+static int num_schemas;
+
+static volatile pid_t current_child;
+static volatile sig_atomic_t timed_out;
+
+void __music_register_schema(const char *filename,
+                             unsigned long long *mutant_id,
+                             const unsigned long long *ids, int num_ids)
+{
+  if (num_schemas < MUSIC_MAX_SCHEMAS)
+  {
+    schemas[num_schemas].filename = filename;
+    schemas[num_schemas].mutant_id = mutant_id;
+    schemas[num_schemas].ids = ids;
+    schemas[num_schemas].num_ids = num_ids;
+    num_schemas++;
+  }
+}
+
+static int compare_ids(const void *a, const void *b)
+{
+  unsigned long long id_a = *(const unsigned long long *) a;
+  unsigned long long id_b = *(const unsigned long long *) b;
+
+  return (id_a > id_b) - (id_a < id_b);
+}
+
+/* Return 1 if mutant_id is in the schema of filename, 0 if it was written
+   as a separate mutant file instead, -1 if no schema of filename is linked
+   into the program. */
+static int has_mutant(const char *filename, unsigned long long mutant_id)
+{
+  int found_schema = 0;
+  int i;
+
+  for (i = 0; i < num_schemas; i++)
+  {
+    if (strcmp(filename, "*") != 0 &&
+        strcmp(filename, schemas[i].filename) != 0)
+      continue;
+
+    found_schema = 1;
+
+    if (bsearch(&mutant_id, schemas[i].ids, schemas[i].num_ids,
+                sizeof(unsigned long long), compare_ids) != NULL)
+      return 1;
+  }
+
+  return found_schema ? 0 : -1;
+}
+
+/* Activate mutant_id of filename and the original code everywhere else. */
+static void select_mutant(const char *filename,
+                          unsigned long long mutant_id)
+{
+  int i;
+
+  for (i = 0; i < num_schemas; i++)
+  {
+    if (strcmp(filename, "*") == 0 ||
+        strcmp(filename, schemas[i].filename) == 0)
+      *schemas[i].mutant_id = mutant_id;
+    else
+      *schemas[i].mutant_id = 0;
+  }
+}
+
+/* Only runs inside sigsuspend, while current_child is not reaped yet, so
+   the pid cannot belong to another process. */
+static void on_alarm(int sig)
+{
+  (void) sig;
+  timed_out = 1;
+
+  if (current_child > 0)
+    kill(current_child, SIGKILL);
+}
+
+/* Only there to wake up sigsuspend: SIGCHLD is ignored by default. */
+static void on_child(int sig)
+{
+  (void) sig;
+}
+
+static long elapsed_ms(const struct timespec *start)
+{
+  struct timespec now;
+
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (now.tv_sec - start->tv_sec) * 1000 +
+         (now.tv_nsec - start->tv_nsec) / 1000000;
+}
+
+static void set_timer(long timeout_ms)
+{
+  struct itimerval timer;
+
+  memset(&timer, 0, sizeof(timer));
+  timer.it_value.tv_sec = timeout_ms / 1000;
+  timer.it_value.tv_usec = (timeout_ms % 1000) * 1000;
+  setitimer(ITIMER_REAL, &timer, NULL);
+}
+
+static void clear_pending_alarm(void)
+{
+  sigset_t pending;
+  sigset_t alarm_signal;
+  int sig;
+
+  sigpending(&pending);
+
+  if (sigismember(&pending, SIGALRM))
+  {
+    sigemptyset(&alarm_signal);
+    sigaddset(&alarm_signal, SIGALRM);
+    sigwait(&alarm_signal, &sig);
+  }
+}
+
+void music_fork_server(void)
+{
+  FILE *commands;
+  FILE *results;
+  struct sigaction alarm_action;
+  struct sigaction old_alarm_action;
+  struct sigaction child_action;
+  struct sigaction old_child_action;
+  sigset_t server_signals;
+  sigset_t old_mask;
+  sigset_t wait_mask;
+  char filename[MUSIC_MAX_FILENAME];
+  unsigned long long mutant_id;
+  long timeout_ms;
+
+  if (getenv(MUSIC_FORK_SERVER_ENV) == NULL)
+    return;
+
+  commands = fdopen(MUSIC_FORK_SERVER_COMMAND_FD, "r");
+  results = fdopen(MUSIC_FORK_SERVER_RESULT_FD, "w");
+
+  if (commands == NULL || results == NULL)
+  {
+    fprintf(stderr, "music_fork_server: not started by music-run\n");
+    exit(1);
+  }
+
+  /* SIGALRM and SIGCHLD are blocked except while waiting for a child in
+     sigsuspend, so the alarm never sees a child that is already reaped. */
+  sigemptyset(&server_signals);
+  sigaddset(&server_signals, SIGALRM);
+  sigaddset(&server_signals, SIGCHLD);
+  sigprocmask(SIG_BLOCK, &server_signals, &old_mask);
+
+  wait_mask = old_mask;
+  sigdelset(&wait_mask, SIGALRM);
+  sigdelset(&wait_mask, SIGCHLD);
+
+  memset(&alarm_action, 0, sizeof(alarm_action));
+  alarm_action.sa_handler = on_alarm;
+  sigemptyset(&alarm_action.sa_mask);
+  sigaction(SIGALRM, &alarm_action, &old_alarm_action);
+
+  memset(&child_action, 0, sizeof(child_action));
+  child_action.sa_handler = on_child;
+  sigemptyset(&child_action.sa_mask);
+  sigaction(SIGCHLD, &child_action, &old_child_action);
+
+  fprintf(results, "ready\n");
+  fflush(results);
+
+  while (fscanf(commands, "%4095s %llu %ld", filename, &mutant_id,
+                &timeout_ms) == 3)
+  {
+    struct timespec start;
+    const char *status_name;
+    int status;
+    int value;
+    int wait_errno;
+    pid_t pid;
+    pid_t reaped;
+
+    /* Running the original code would report the mutant as surviving. */
+    switch (has_mutant(filename, mutant_id))
+    {
+      case -1:
+        fprintf(results, "%llu error 0 0\n", mutant_id);
+        fflush(results);
+        continue;
+
+      case 0:
+        fprintf(results, "%llu unschematized 0 0\n", mutant_id);
+        fflush(results);
+        continue;
+    }
+
+    /* Output buffered so far must not be written again by every child. */
+    fflush(stdout);
+    fflush(stderr);
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    timed_out = 0;
+    pid = fork();
+
+    if (pid == 0)
+    {
+      fclose(commands);
+      fclose(results);
+      sigaction(SIGALRM, &old_alarm_action, NULL);
+      sigaction(SIGCHLD, &old_child_action, NULL);
+      sigprocmask(SIG_SETMASK, &old_mask, NULL);
+      select_mutant(filename, mutant_id);
+      return;
+    }
+
+    if (pid < 0)
+    {
+      fprintf(results, "%llu error %d 0\n", mutant_id, errno);
+      fflush(results);
+      continue;
+    }
+
+    current_child = pid;
+
+    if (timeout_ms > 0)
+      set_timer(timeout_ms);
+
+    while ((reaped = waitpid(pid, &status, WNOHANG)) == 0)
+      sigsuspend(&wait_mask);
+
+    wait_errno = errno;
+
+    /* An alarm that expired after the child was reaped stays pending, and
+       must not be delivered while the next child runs. */
+    set_timer(0);
+    current_child = 0;
+    clear_pending_alarm();
+
+    if (reaped < 0)
+    {
+      fprintf(results, "%llu error %d 0\n", mutant_id, wait_errno);
+      fflush(results);
+      continue;
+    }
+
+    /* Set only if the alarm killed the child before it exited by itself. */
+    if (timed_out && WIFSIGNALED(status) && WTERMSIG(status) == SIGKILL)
+    {
+      status_name = "timeout";
+      value = SIGKILL;
+    }
+    else if (WIFSIGNALED(status))
+    {
+      status_name = "signaled";
+      value = WTERMSIG(status);
+    }
+    else
+    {
+      status_name = "exited";
+      value = WEXITSTATUS(status);
+    }
+
+    fprintf(results, "%llu %s %d %ld\n", mutant_id, status_name, value,
+            elapsed_ms(&start));
+    fflush(results);
+  }
+
+  /* music-run closed the command pipe: no more mutants to run. */
+  exit(0);
+}
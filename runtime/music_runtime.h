@@ -0,0 +1,54 @@
+#ifndef MUSIC_RUNTIME_H_
+#define MUSIC_RUNTIME_H_
+
+/**
+  Runtime linked into a program built from MUSIC schema files (option
+  -schemata). It lets music-run execute many mutants of the program while
+  paying process startup and program initialization only once.
+
+  Call music_fork_server() in the program at the point where each test run
+  should start (e.g. in main, after initialization). When the program is
+  started by music-run, the call never returns in the server process: it
+  forks one child per mutant requested by music-run, and each child returns
+  from music_fork_server() with that mutant selected and runs to completion.
+  When the program is started normally, the call returns immediately.
+
+  Protocol between music-run and the fork server (text, one line each):
+
+    server -> driver   "ready"
+    driver -> server   "<source file> <mutant id> <timeout ms>"
+    server -> driver   "<mutant id> <status> <value> <elapsed ms>"
+
+  status is "exited" (value is exit code), "signaled" (value is signal
+  number), "timeout" (child was killed after timeout ms, 0 means no limit),
+  "unschematized" (mutant is not in the schema file but was written as a
+  separate mutant file, and is not run) or "error" (value is errno if fork
+  failed or the child could not be waited for, 0 if no schema file of
+  source file is linked into the program).
+  Source file "*" selects mutant id in every schema file.
+*/
+
+// File descriptors music-run passes commands and reads results on.
+#define MUSIC_FORK_SERVER_COMMAND_FD 198
+#define MUSIC_FORK_SERVER_RESULT_FD 199
+
+// Set by music-run in the environment of fork servers.
+#define MUSIC_FORK_SERVER_ENV "MUSIC_FORK_SERVER"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Called by each schema file at startup with a pointer to its mutant id
+// and the sorted ids of the mutants it contains.
+void __music_register_schema(const char *filename,
+                             unsigned long long *mutant_id,
+                             const unsigned long long *ids, int num_ids);
+
+void music_fork_server(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  /* MUSIC_RUNTIME_H_ */
@@ -0,0 +1,386 @@
+#include <algorithm>
+
+#include "schema_builder.h"
+
+namespace {
+
+// Return str as the content of a C string literal.
+std::string EscapeCString(const std::string &str)
+{
+  std::string ret;
+
+  for (char c: str)
+  {
+    if (c == '"' || c == '\\')
+      ret += '\\';
+    ret += c;
+  }
+
+  return ret;
+}
+
+// Return True if text, ignoring whitespace, is empty or a single ';'.
+bool IsDeletion(const std::string &text)
+{
+  size_t first = text.find_first_not_of(" \t\r\n");
+
+  if (first == std::string::npos)
+    return true;
+
+  return text[first] == ';' &&
+         text.find_first_not_of(" \t\r\n", first + 1) == std::string::npos;
+}
+
+// Return mutant id as a C constant of the type of __music_id. Ids of
+// option -stable-ids do not fit in a signed type.
+std::string IdLiteral(uint64_t mutant_id)
+{
+  return std::to_string(mutant_id) + "ULL";
+}
+
+}  // namespace
+
+SchemaBuilder::SchemaBuilder(const std::string &original,
+                             const std::string &filename)
+  : original_(original), filename_(filename)
+{
+  line_starts_.push_back(0);
+
+  for (unsigned i = 0; i < original_.length(); i++)
+    if (original_[i] == '\n')
+      line_starts_.push_back(i + 1);
+}
+
+void SchemaBuilder::AddRegion(const SchemaRegion &region)
+{
+  if (region.start_ < region.end_ && region.end_ <= original_.length())
+    regions_.push_back(region);
+}
+
+void SchemaBuilder::AddBarrier(const SchemaBarrier &barrier)
+{
+  barriers_.push_back(barrier);
+}
+
+void SchemaBuilder::AddMutant(uint64_t mutant_id, const PatchRecord &edit)
+{
+  mutants_.push_back(Mutant{mutant_id, edit});
+}
+
+bool SchemaBuilder::RegionCrossesBarrier(const SchemaRegion &region) const
+{
+  auto it = std::lower_bound(
+      barriers_.begin(), barriers_.end(), region.start_,
+      [](const SchemaBarrier &barrier, unsigned offset)
+      { return barrier.offset_ < offset; });
+
+  for (; it != barriers_.end() && it->offset_ < region.end_; ++it)
+    if (it->scope_start_ < region.start_ || it->scope_end_ > region.end_)
+      return true;
+
+  return false;
+}
+
+void SchemaBuilder::BuildRegionTree()
+{
+  std::sort(barriers_.begin(), barriers_.end(),
+            [](const SchemaBarrier &a, const SchemaBarrier &b)
+            { return a.offset_ < b.offset_; });
+
+  // Outer regions first, so that every region is visited after its parent.
+  // Among regions with the same range, expression regions come first and
+  // the others are dropped: they would produce the same switch.
+  std::sort(regions_.begin(), regions_.end(),
+            [](const SchemaRegion &a, const SchemaRegion &b)
+            {
+              if (a.start_ != b.start_)
+                return a.start_ < b.start_;
+              if (a.end_ != b.end_)
+                return a.end_ > b.end_;
+              return a.kind_ < b.kind_;
+            });
+
+  std::vector<int> open_nodes;
+
+  for (auto &region: regions_)
+  {
+    if (!nodes_.empty() && nodes_.back().region_.start_ == region.start_ &&
+        nodes_.back().region_.end_ == region.end_)
+      continue;
+
+    if (RegionCrossesBarrier(region))
+      continue;
+
+    while (!open_nodes.empty() &&
+           nodes_[open_nodes.back()].region_.end_ <= region.start_)
+      open_nodes.pop_back();
+
+    // Regions come from a syntax tree and normally nest. Skip any that
+    // partially overlaps its would-be parent (e.g. because of macros).
+    if (!open_nodes.empty() &&
+        nodes_[open_nodes.back()].region_.end_ < region.end_)
+      continue;
+
+    Node node;
+    node.region_ = region;
+    node.parent_ = open_nodes.empty() ? -1 : open_nodes.back();
+    node.has_mutant_in_subtree_ = false;
+
+    int node_idx = nodes_.size();
+    nodes_.push_back(node);
+
+    if (node.parent_ == -1)
+      top_level_nodes_.push_back(node_idx);
+    else
+      nodes_[node.parent_].children_.push_back(node_idx);
+
+    open_nodes.push_back(node_idx);
+  }
+}
+
+int SchemaBuilder::FindInnermostNode(const PatchRecord &edit) const
+{
+  uint64_t edit_end = edit.offset_ + edit.length_;
+
+  // Last node starting at or before the edit. The innermost node
+  // containing the edit is this node or one of its ancestors.
+  auto it = std::upper_bound(
+      nodes_.begin(), nodes_.end(), edit.offset_,
+      [](uint64_t offset, const Node &node)
+      { return offset < node.region_.start_; });
+
+  if (it == nodes_.begin())
+    return -1;
+
+  int node_idx = (it - nodes_.begin()) - 1;
+
+  while (node_idx != -1 && nodes_[node_idx].region_.end_ < edit_end)
+    node_idx = nodes_[node_idx].parent_;
+
+  return node_idx;
+}
+
+unsigned SchemaBuilder::GetLineNumber(unsigned offset) const
+{
+  return std::upper_bound(line_starts_.begin(), line_starts_.end(), offset) -
+         line_starts_.begin();
+}
+
+std::string SchemaBuilder::GetMutantText(const Node &node,
+                                         const Mutant &mutant) const
+{
+  unsigned start = node.region_.start_;
+  unsigned edit_start = mutant.edit_.offset_;
+  unsigned edit_end = edit_start + mutant.edit_.length_;
+
+  std::string text{original_, start, edit_start - start};
+  text += mutant.edit_.replacement_;
+  text.append(original_, edit_end, node.region_.end_ - edit_end);
+  return text;
+}
+
+void SchemaBuilder::EmitOriginal(int node_idx, std::string &out) const
+{
+  const Node &node = nodes_[node_idx];
+  unsigned pos = node.region_.start_;
+
+  for (auto child_idx: node.children_)
+  {
+    const Node &child = nodes_[child_idx];
+
+    if (!child.has_mutant_in_subtree_)
+      continue;
+
+    out.append(original_, pos, child.region_.start_ - pos);
+    EmitNode(child_idx, out);
+    pos = child.region_.end_;
+  }
+
+  out.append(original_, pos, node.region_.end_ - pos);
+}
+
+void SchemaBuilder::EmitNode(int node_idx, std::string &out) const
+{
+  const Node &node = nodes_[node_idx];
+
+  if (node.mutants_.empty())
+  {
+    EmitOriginal(node_idx, out);
+    return;
+  }
+
+  if (node.region_.kind_ == kSchemaExprRegion)
+  {
+    // (__music_id == 1 ? (m1) : __music_id == 2 ? (m2) : (original))
+    out += "(";
+
+    for (auto mutant_idx: node.mutants_)
+    {
+      const Mutant &mutant = mutants_[mutant_idx];
+      out += "__music_id == " + IdLiteral(mutant.id_) + " ? (";
+      out += GetMutantText(node, mutant);
+      out += ") : ";
+    }
+
+    out += "(";
+    EmitOriginal(node_idx, out);
+    out += "))";
+    return;
+  }
+
+  bool all_deletions = true;
+
+  for (auto mutant_idx: node.mutants_)
+    if (!IsDeletion(GetMutantText(node, mutants_[mutant_idx])))
+      all_deletions = false;
+
+  // Statement deletions: if (__music_id != 1 && __music_id != 2) {original}
+  if (all_deletions)
+  {
+    out += "if (";
+
+    for (size_t i = 0; i < node.mutants_.size(); i++)
+    {
+      if (i != 0)
+        out += " && ";
+      out += "__music_id != " + IdLiteral(mutants_[node.mutants_[i]].id_);
+    }
+
+    out += ") {";
+    EmitOriginal(node_idx, out);
+    out += "}";
+    return;
+  }
+
+  // if (__music_id == 1) {m1} else if (__music_id == 2) {m2} else {original}
+  for (auto mutant_idx: node.mutants_)
+  {
+    const Mutant &mutant = mutants_[mutant_idx];
+    out += "if (__music_id == " + IdLiteral(mutant.id_) + ") {";
+    out += GetMutantText(node, mutant);
+    out += "} else ";
+  }
+
+  out += "{";
+  EmitOriginal(node_idx, out);
+  out += "}";
+}
+
+std::string SchemaBuilder::GetPrelude() const
+{
+  std::string name{EscapeCString(filename_)};
+
+  // Sorted ids of mutants in the schema, so that the runtime can tell them
+  // from mutants written separately. An array cannot be empty.
+  std::vector<uint64_t> schema_ids;
+
+  for (auto &node: nodes_)
+    for (auto mutant_idx: node.mutants_)
+      schema_ids.push_back(mutants_[mutant_idx].id_);
+
+  std::sort(schema_ids.begin(), schema_ids.end());
+
+  std::string ids{schema_ids.empty() ? IdLiteral(0) : ""};
+  size_t num_ids = schema_ids.size();
+
+  for (size_t i = 0; i < num_ids; i++)
+    ids += (i == 0 ? "" : ", ") + IdLiteral(schema_ids[i]);
+
+  // The active mutant is read once at startup: MUSIC_MUTANT_ID selects it,
+  // and MUSIC_MUTANT_FILE (if set) must name this file. A runtime linked
+  // into the program can also take over the selection by defining
+  // __music_register_schema, which also gets the ids of mutants in the
+  // schema. Everything is kept on one line so that
+  // the #line directive below restores original line numbers.
+  std::string prelude;
+  prelude += "static unsigned long long __music_id; ";
+  prelude += "static const unsigned long long __music_ids[] = {" + ids +
+             "}; ";
+  prelude += "extern char *getenv(const char *); ";
+  prelude += "extern void __music_register_schema(const char *, "
+             "unsigned long long *, const unsigned long long *, int) "
+             "__attribute__((weak)); ";
+  prelude += "static void __music_select_mutant(void) "
+             "__attribute__((constructor)); ";
+  prelude += "static void __music_select_mutant(void) { ";
+  prelude += "const char *file = getenv(\"MUSIC_MUTANT_FILE\"); ";
+  prelude += "const char *id = getenv(\"MUSIC_MUTANT_ID\"); ";
+  prelude += "const char *self = \"" + name + "\"; ";
+  prelude += "if (file) { while (*file && *file == *self) { file++; self++; } ";
+  prelude += "if (*file || *self) id = 0; } ";
+  prelude += "if (id) while (*id >= '0' && *id <= '9') ";
+  prelude += "__music_id = __music_id * 10 + (*id++ - '0'); ";
+  prelude += "if (__music_register_schema) ";
+  prelude += "__music_register_schema(\"" + name + "\", &__music_id, "
+             "__music_ids, " + std::to_string(num_ids) + "); }\n";
+  prelude += "#line 1 \"" + name + "\"\n";
+  return prelude;
+}
+
+std::string SchemaBuilder::Build(std::vector<PatchRecord> &unschematized)
+{
+  BuildRegionTree();
+
+  for (size_t i = 0; i < mutants_.size(); i++)
+  {
+    const PatchRecord &edit = mutants_[i].edit_;
+
+    if (edit.offset_ > original_.length() ||
+        edit.length_ > original_.length() - edit.offset_)
+    {
+      unschematized.push_back(edit);
+      continue;
+    }
+
+    int node_idx = FindInnermostNode(edit);
+
+    if (node_idx == -1)
+    {
+      unschematized.push_back(edit);
+      continue;
+    }
+
+    nodes_[node_idx].mutants_.push_back(i);
+
+    for (; node_idx != -1 && !nodes_[node_idx].has_mutant_in_subtree_;
+         node_idx = nodes_[node_idx].parent_)
+      nodes_[node_idx].has_mutant_in_subtree_ = true;
+  }
+
+  // Switch arms are tested in mutant id order.
+  for (auto &node: nodes_)
+    std::sort(node.mutants_.begin(), node.mutants_.end(),
+              [this](int a, int b)
+              { return mutants_[a].id_ < mutants_[b].id_; });
+
+  std::string out{GetPrelude()};
+  unsigned pos = 0;
+
+  for (auto node_idx: top_level_nodes_)
+  {
+    const Node &node = nodes_[node_idx];
+
+    if (!node.has_mutant_in_subtree_)
+      continue;
+
+    out.append(original_, pos, node.region_.start_ - pos);
+
+    std::string text;
+    EmitNode(node_idx, text);
+    out += text;
+    pos = node.region_.end_;
+
+    // Mutated copies may add lines. Keep the rest of the file on its
+    // original line numbers.
+    if (std::count(text.begin(), text.end(), '\n') !=
+        std::count(original_.begin() + node.region_.start_,
+                   original_.begin() + node.region_.end_, '\n'))
+    {
+      out += "\n#line " + std::to_string(GetLineNumber(pos)) + " \"" +
+             EscapeCString(filename_) + "\"\n";
+    }
+  }
+
+  out.append(original_, pos, std::string::npos);
+  return out;
+}
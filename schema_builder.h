@@ -0,0 +1,115 @@
+#ifndef MUSIC_SCHEMA_BUILDER_H_
+#define MUSIC_SCHEMA_BUILDER_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "patch_file.h"
+
+/**
+  A piece of the original file that can be turned into a runtime switch
+  between its original text and its mutated versions.
+
+  Expression regions become (__music_id == N ? (mutant) : (original)), so
+  they must be rvalues that are allowed to be evaluated at runtime.
+  Statement regions become if (__music_id == N) {mutant} else {original},
+  so they must be complete statements directly inside a compound
+  statement.
+
+  @param  kind_ expression or statement region
+          start_ byte offset of first character of region
+          end_ byte offset right after last character of region
+*/
+enum SchemaRegionKind
+{
+  kSchemaExprRegion,
+  kSchemaStmtRegion
+};
+
+struct SchemaRegion
+{
+  SchemaRegionKind kind_;
+  unsigned start_;
+  unsigned end_;
+};
+
+/**
+  Text at offset_ that must not be duplicated unless the whole range
+  [scope_start_, scope_end_) is duplicated with it. Used for labels (whose
+  scope is the whole file) and case labels (whose scope is their switch).
+*/
+struct SchemaBarrier
+{
+  unsigned offset_;
+  unsigned scope_start_;
+  unsigned scope_end_;
+};
+
+/**
+  Build a mutant schemata source: a single source file containing every
+  mutant, where the active mutant is chosen at runtime.
+
+  Each mutant is placed in the innermost region containing its edit. Regions
+  nest, so a region's original text may itself contain switches of inner
+  regions. Mutants not contained in any usable region are returned to the
+  caller, which can still write them as separate mutant files.
+*/
+class SchemaBuilder
+{
+public:
+  // filename is the name of input file, used in #line directives and by
+  // the runtime to match MUSIC_MUTANT_FILE.
+  SchemaBuilder(const std::string &original, const std::string &filename);
+
+  void AddRegion(const SchemaRegion &region);
+  void AddBarrier(const SchemaBarrier &barrier);
+
+  // edit.mutant_filename_ is only carried through to unschematized.
+  void AddMutant(uint64_t mutant_id, const PatchRecord &edit);
+
+  /**
+    @param  unschematized output edits of mutants that could not be put
+                          in the schema, in the order they were added
+    @return schematized source
+  */
+  std::string Build(std::vector<PatchRecord> &unschematized);
+
+private:
+  struct Mutant
+  {
+    uint64_t id_;
+    PatchRecord edit_;
+  };
+
+  struct Node
+  {
+    SchemaRegion region_;
+    int parent_;
+    std::vector<int> children_;
+    std::vector<int> mutants_;
+    bool has_mutant_in_subtree_;
+  };
+
+  const std::string &original_;
+  std::string filename_;
+  std::vector<SchemaRegion> regions_;
+  std::vector<SchemaBarrier> barriers_;
+  std::vector<Mutant> mutants_;
+
+  std::vector<Node> nodes_;
+  std::vector<int> top_level_nodes_;
+  std::vector<unsigned> line_starts_;
+
+  bool RegionCrossesBarrier(const SchemaRegion &region) const;
+  void BuildRegionTree();
+  int FindInnermostNode(const PatchRecord &edit) const;
+  unsigned GetLineNumber(unsigned offset) const;
+
+  void EmitNode(int node_idx, std::string &out) const;
+  void EmitOriginal(int node_idx, std::string &out) const;
+  std::string GetMutantText(const Node &node, const Mutant &mutant) const;
+  std::string GetPrelude() const;
+};
+
+#endif  // MUSIC_SCHEMA_BUILDER_H_
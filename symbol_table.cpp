@@ -1,4 +1,5 @@
 #include "symbol_table.h"
+#include "music_utility.h"
 
 SymbolTable::SymbolTable(
 		GlobalScalarConstantList *g_scalarconstant_list,
@@ -25,7 +26,10 @@ SymbolTable::SymbolTable(
 	local_struct_vardecl_list_(l_struct_vardecl_list),
 	global_pointer_vardecl_list_(g_pointer_vardecl_list),
 	local_pointer_vardecl_list_(l_pointer_vardecl_list)
-{}
+{
+  for (int kind = 0; kind < kNumVarDeclKinds; kind++)
+    has_global_symbols_[kind] = false;
+}
 
 
 GlobalScalarConstantList* SymbolTable::getGlobalScalarConstantList()
@@ -87,3 +91,148 @@ std::vector<VarDeclList>* SymbolTable::getLocalPointerVarDeclList()
 {
 	return local_pointer_vardecl_list_;
 }
+
+void SymbolTable::GetLocalVarDeclCandidates(
+    VarDeclKind kind, int function_id, SourceLocation loc,
+    const std::vector<SourceRange> &scope_list, unsigned excluded_flags,
+    bool whole_decl_before_loc, VarDeclCandidateList &candidates)
+{
+  candidates.clear();
+
+  std::vector<VarDeclList> *vardecl_lists = getLocalVarDeclList(kind);
+
+  if (function_id < 0 || 
+      function_id >= static_cast<int>(vardecl_lists->size()))
+    return;
+
+  if (has_local_symbols_[kind].size() < vardecl_lists->size())
+  {
+    has_local_symbols_[kind].resize(vardecl_lists->size(), false);
+    local_symbols_[kind].resize(vardecl_lists->size());
+  }
+
+  VarDeclSymbolList &symbols = local_symbols_[kind][function_id];
+
+  if (!has_local_symbols_[kind][function_id])
+  {
+    BuildSymbols(kind, (*vardecl_lists)[function_id], symbols);
+    has_local_symbols_[kind][function_id] = true;
+  }
+
+  for (auto &symbol: symbols)
+  {
+    // The rest are declared after loc.
+    if (!(symbol.vardecl_->getLocStart() < loc))
+      break;
+
+    if (whole_decl_before_loc && loc < symbol.vardecl_->getLocEnd())
+      break;
+
+    if ((symbol.flags_ & excluded_flags) != 0)
+      continue;
+
+    // Scopes start in the order they are pushed and nest, so the last one
+    // holding the declaration is the innermost. Every scope starting before
+    // loc is already in scope_list.
+    if (symbol.scope_index_ < 0)
+      for (int i = scope_list.size() - 1; i >= 0; i--)
+        if (LocationIsInRange(symbol.vardecl_->getLocStart(), scope_list[i]))
+        {
+          symbol.scope_index_ = i;
+          break;
+        }
+
+    // A variable is visible only inside the scope declaring it.
+    if (symbol.scope_index_ >= 0 &&
+        !LocationIsInRange(loc, scope_list[symbol.scope_index_]))
+      continue;
+
+    candidates.push_back(&symbol);
+  }
+}
+
+void SymbolTable::GetGlobalVarDeclCandidates(
+    VarDeclKind kind, SourceLocation loc, unsigned excluded_flags,
+    VarDeclCandidateList &candidates)
+{
+  candidates.clear();
+
+  if (!has_global_symbols_[kind])
+  {
+    BuildSymbols(kind, *getGlobalVarDeclList(kind), global_symbols_[kind]);
+    has_global_symbols_[kind] = true;
+  }
+
+  for (auto &symbol: global_symbols_[kind])
+  {
+    // The rest are declared after loc.
+    if (!(symbol.vardecl_->getLocStart() < loc))
+      break;
+
+    if ((symbol.flags_ & excluded_flags) == 0)
+      candidates.push_back(&symbol);
+  }
+}
+
+VarDeclList* SymbolTable::getGlobalVarDeclList(VarDeclKind kind)
+{
+  switch (kind)
+  {
+    case kScalarVarDecl:
+      return global_scalar_vardecl_list_;
+    case kArrayVarDecl:
+      return global_array_vardecl_list_;
+    case kStructVarDecl:
+      return global_struct_vardecl_list_;
+    default:
+      return global_pointer_vardecl_list_;
+  }
+}
+
+std::vector<VarDeclList>* SymbolTable::getLocalVarDeclList(VarDeclKind kind)
+{
+  switch (kind)
+  {
+    case kScalarVarDecl:
+      return local_scalar_vardecl_list_;
+    case kArrayVarDecl:
+      return local_array_vardecl_list_;
+    case kStructVarDecl:
+      return local_struct_vardecl_list_;
+    default:
+      return local_pointer_vardecl_list_;
+  }
+}
+
+void SymbolTable::BuildSymbols(VarDeclKind kind,
+                               const VarDeclList &vardecl_list,
+                               VarDeclSymbolList &symbols)
+{
+  symbols.clear();
+  symbols.reserve(vardecl_list.size());
+
+  for (auto vardecl: vardecl_list)
+  {
+    VarDeclSymbol symbol;
+    symbol.vardecl_ = vardecl;
+    symbol.name_ = GetVarDeclName(vardecl);
+    symbol.flags_ = 0;
+    symbol.scope_index_ = -1;
+
+    if (IsVarDeclConst(vardecl))
+      symbol.flags_ |= VarDeclSymbol::kConst;
+
+    if (IsVarDeclFloating(vardecl))
+      symbol.flags_ |= VarDeclSymbol::kFloating;
+
+    if (vardecl->getStorageClass() == SC_Register)
+      symbol.flags_ |= VarDeclSymbol::kRegister;
+
+    if (kind == kPointerVarDecl)
+      symbol.type_ = getPointerType(vardecl->getType());
+    else if (kind == kStructVarDecl)
+      symbol.type_ = getStructureType(vardecl->getType());
+
+    symbols.push_back(symbol);
+  }
+}
@@ -11,6 +11,8 @@
 #include "clang/AST/RecursiveASTVisitor.h"
 #include "clang/AST/ASTContext.h"
 
+#include "literal_pool.h"
+
 // <line number, column number>
 typedef std::pair<int, int> LabelStmtLocation; 
 
@@ -41,11 +43,40 @@ typedef std::map<LabelStmtLocation, GotoStmtLocationList, comp> LabelStmtToGotoS
 typedef std::vector<clang::Expr*> ExprList;
 typedef std::vector<clang::VarDecl *> VarDeclList;
 
-typedef ExprList GlobalStringLiteralList;
-typedef std::vector<ExprList> LocalStringLiteralList;
+// Distinct literals of global scope, and of each function by function id.
+typedef LiteralPool GlobalStringLiteralList;
+typedef std::vector<LiteralPool> LocalStringLiteralList;
+
+typedef LiteralPool GlobalScalarConstantList;
+typedef std::vector<LiteralPool> LocalScalarConstantList;
 
-typedef ExprList GlobalScalarConstantList;
-typedef std::vector<ExprList> LocalScalarConstantList;
+/**
+  A variable of SymbolTable with what replacement operators check on every
+  candidate, computed once: its name, whether it is const, floating or
+  register, and the type a replacing variable must have (pointee type of a
+  pointer, canonical type of a struct, empty otherwise).
+*/
+struct VarDeclSymbol
+{
+  enum Flag
+  {
+    kConst = 1 << 0,
+    kFloating = 1 << 1,
+    kRegister = 1 << 2
+  };
+
+  clang::VarDecl *vardecl_;
+  std::string name_;
+  std::string type_;
+  unsigned flags_;
+
+  // Index of the innermost scope around vardecl_ in the scope list of its
+  // function, -1 until found.
+  int scope_index_;
+};
+
+typedef std::vector<VarDeclSymbol> VarDeclSymbolList;
+typedef std::vector<const VarDeclSymbol*> VarDeclCandidateList;
 
 // pair<range of switch statement, list of case values' string representation>
 typedef std::vector<std::pair<clang::SourceRange, std::vector<std::string>>> SwitchStmtInfoList;
@@ -80,6 +111,39 @@ public:
 	std::vector<VarDeclList>* getLocalStructVarDeclList();
 	VarDeclList* getGlobalPointerVarDeclList();
 	std::vector<VarDeclList>* getLocalPointerVarDeclList();
+
+  enum VarDeclKind
+  {
+    kScalarVarDecl,
+    kArrayVarDecl,
+    kStructVarDecl,
+    kPointerVarDecl,
+    kNumVarDeclKinds
+  };
+
+  /**
+    Local variables of kind, in function function_id, that a reference at
+    loc can be replaced with, in declaration order: declared before loc,
+    with their innermost scope in scope_list containing loc, and with none
+    of excluded_flags (VarDeclSymbol::Flag).
+
+    Variables of a function are indexed on the first lookup, so scope_list
+    must be the scope list of that function, as MusicASTVisitor builds it.
+    Candidates point into the index and stay valid.
+
+    @param  whole_decl_before_loc also stop at the first variable whose
+                                  declaration does not end before loc
+  */
+  void GetLocalVarDeclCandidates(
+      VarDeclKind kind, int function_id, clang::SourceLocation loc,
+      const std::vector<clang::SourceRange> &scope_list,
+      unsigned excluded_flags, bool whole_decl_before_loc,
+      VarDeclCandidateList &candidates);
+
+  // Global variables of kind declared before loc, without excluded_flags.
+  void GetGlobalVarDeclCandidates(
+      VarDeclKind kind, clang::SourceLocation loc, unsigned excluded_flags,
+      VarDeclCandidateList &candidates);
 	
 private:
 	// global/local number, char literals
@@ -109,6 +173,18 @@ private:
   // local_pointer_vardecl_list_ follows the same nesting rule as ScopeRangeList
   VarDeclList *global_pointer_vardecl_list_;
   std::vector<VarDeclList> *local_pointer_vardecl_list_;
+
+  // Symbols of the lists above by VarDeclKind. Global ones are built on
+  // the first lookup, local ones per function (empty until built).
+  bool has_global_symbols_[kNumVarDeclKinds];
+  VarDeclSymbolList global_symbols_[kNumVarDeclKinds];
+  std::vector<bool> has_local_symbols_[kNumVarDeclKinds];
+  std::vector<VarDeclSymbolList> local_symbols_[kNumVarDeclKinds];
+
+  VarDeclList* getGlobalVarDeclList(VarDeclKind kind);
+  std::vector<VarDeclList>* getLocalVarDeclList(VarDeclKind kind);
+  void BuildSymbols(VarDeclKind kind, const VarDeclList &vardecl_list,
+                    VarDeclSymbolList &symbols);
 };
 
 #endif	// MUSIC_SYMBOL_TABLE
\ No newline at end of file
@@ -0,0 +1,320 @@
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <fcntl.h>
+#include <fstream>
+#include <map>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+
+#include "tce.h"
+
+namespace {
+
+std::string JoinPath(const std::string &directory, const std::string &path)
+{
+  if (path.empty() || path[0] == '/' || directory.empty())
+    return path;
+
+  if (directory.back() == '/')
+    return directory + path;
+
+  return directory + "/" + path;
+}
+
+std::string GetDirectory(const std::string &path)
+{
+  size_t slash_pos = path.rfind('/');
+
+  if (slash_pos == std::string::npos)
+    return ".";
+
+  if (slash_pos == 0)
+    return "/";
+
+  return path.substr(0, slash_pos);
+}
+
+bool HasCxxExtension(const std::string &filename)
+{
+  for (const char *extension: {".cpp", ".cc", ".cxx", ".C"})
+  {
+    std::string ext{extension};
+
+    if (filename.length() >= ext.length() &&
+        filename.compare(filename.length() - ext.length(), ext.length(),
+                         ext) == 0)
+      return true;
+  }
+
+  return false;
+}
+
+// Options that write output files or name the input language, followed by
+// a separate argument.
+bool IsDroppedOptionWithValue(const std::string &arg)
+{
+  return arg == "-o" || arg == "-MF" || arg == "-MT" || arg == "-MQ" ||
+         arg == "-x";
+}
+
+bool IsDroppedOption(const std::string &arg)
+{
+  return arg == "-c" || arg == "-S" || arg == "-E" || arg == "-M" ||
+         arg == "-MM" || arg == "-MD" || arg == "-MMD" || arg == "-MP" ||
+         arg == "-MG" || (arg.compare(0, 2, "-o") == 0 && arg.length() > 2) ||
+         arg.compare(0, 3, "-MF") == 0 || arg.compare(0, 3, "-MT") == 0 ||
+         arg.compare(0, 3, "-MQ") == 0 || arg.compare(0, 2, "-x") == 0;
+}
+
+}  // namespace
+
+const char* GetTceStatusName(TceStatus status)
+{
+  switch (status)
+  {
+    case kTceUnique: return "unique";
+    case kTceEquivalent: return "equivalent";
+    case kTceDuplicate: return "duplicate";
+    case kTceUncompilable: return "uncompilable";
+  }
+
+  return "";
+}
+
+TrivialCompilerEquivalence::TrivialCompilerEquivalence(
+    const std::vector<std::string> &command_line, const std::string &directory,
+    const std::string &source_filename, unsigned num_jobs)
+  : directory_(directory), is_cxx_(HasCxxExtension(source_filename)),
+    num_jobs_(num_jobs == 0 ? 1 : num_jobs)
+{
+  source_dir_ = GetDirectory(JoinPath(directory, source_filename));
+  MakeCompilerArgs(command_line, source_filename);
+}
+
+void TrivialCompilerEquivalence::MakeCompilerArgs(
+    const std::vector<std::string> &command_line,
+    const std::string &source_filename)
+{
+  std::string source_path{JoinPath(directory_, source_filename)};
+
+  if (command_line.empty())
+    return;
+
+  compiler_args_.push_back(command_line[0]);
+
+  for (size_t i = 1; i < command_line.size(); i++)
+  {
+    const std::string &arg = command_line[i];
+
+    if (IsDroppedOptionWithValue(arg))
+    {
+      i++;
+      continue;
+    }
+
+    if (IsDroppedOption(arg) || arg == source_filename ||
+        JoinPath(directory_, arg) == source_path)
+      continue;
+
+    compiler_args_.push_back(arg);
+  }
+
+  // Input and output are added per compilation.
+  compiler_args_.push_back("-iquote");
+  compiler_args_.push_back(source_dir_);
+  compiler_args_.push_back("-g0");
+  compiler_args_.push_back("-c");
+  compiler_args_.push_back("-x");
+  compiler_args_.push_back(is_cxx_ ? "c++" : "c");
+  compiler_args_.push_back("-");
+  compiler_args_.push_back("-o");
+}
+
+bool TrivialCompilerEquivalence::Compile(const std::string &content,
+                                         unsigned job_idx,
+                                         uint64_t &object_hash)
+{
+  std::string input_filename{work_dir_ + "/" + std::to_string(job_idx) + ".in"};
+  std::string object_filename{work_dir_ + "/" + std::to_string(job_idx) + ".o"};
+
+  std::ofstream input(input_filename.data(), std::ios::binary);
+  input << content;
+  input.close();
+
+  if (!input)
+    return false;
+
+  std::vector<std::string> args{compiler_args_};
+  args.push_back(object_filename);
+
+  std::vector<char *> argv;
+
+  for (auto &arg: args)
+    argv.push_back(const_cast<char *>(arg.data()));
+
+  argv.push_back(nullptr);
+
+  pid_t pid = fork();
+
+  if (pid == 0)
+  {
+    // Only async-signal-safe calls until exec.
+    int input_fd = open(input_filename.data(), O_RDONLY);
+    int null_fd = open("/dev/null", O_WRONLY);
+
+    if (input_fd < 0 || chdir(directory_.data()) != 0)
+      _exit(127);
+
+    dup2(input_fd, STDIN_FILENO);
+    dup2(null_fd, STDOUT_FILENO);
+    dup2(null_fd, STDERR_FILENO);
+
+    execvp(argv[0], argv.data());
+    _exit(127);
+  }
+
+  if (pid < 0)
+    return false;
+
+  int status;
+
+  while (waitpid(pid, &status, 0) < 0)
+  {
+    if (errno != EINTR)
+      return false;
+  }
+
+  std::string object;
+  bool compiled = WIFEXITED(status) && WEXITSTATUS(status) == 0 &&
+                  ReadWholeFile(object_filename, object);
+
+  remove(object_filename.data());
+
+  if (compiled)
+    object_hash = HashFileContent(object);
+
+  return compiled;
+}
+
+bool TrivialCompilerEquivalence::Run(
+    const std::string &original,
+    const std::vector<std::pair<uint64_t, PatchRecord>> &mutants,
+    std::vector<TceResult> &results)
+{
+  const char *tmp_dir = getenv("TMPDIR");
+  std::string work_dir_template{tmp_dir != nullptr ? tmp_dir : "/tmp"};
+  work_dir_template += "/music_tce_XXXXXX";
+
+  if (mkdtemp(&work_dir_template[0]) == nullptr)
+    return false;
+
+  work_dir_ = work_dir_template;
+
+  uint64_t original_hash;
+  bool original_compiled = Compile(original, 0, original_hash);
+
+  std::vector<uint64_t> object_hashes(mutants.size());
+  std::vector<char> compiled(mutants.size(), 0);
+
+  if (original_compiled)
+  {
+    std::atomic<size_t> next_mutant_idx{0};
+
+    auto worker = [&](unsigned job_idx)
+    {
+      std::string mutant;
+
+      for (size_t idx = next_mutant_idx++; idx < mutants.size();
+           idx = next_mutant_idx++)
+        compiled[idx] = ApplyPatchRecord(original, mutants[idx].second,
+                                         mutant) &&
+                        Compile(mutant, job_idx, object_hashes[idx]);
+    };
+
+    std::vector<std::thread> workers;
+
+    for (unsigned i = 0; i < num_jobs_ && i < mutants.size(); i++)
+      workers.push_back(std::thread(worker, i));
+
+    for (auto &t: workers)
+      t.join();
+  }
+
+  for (unsigned i = 0; i < num_jobs_; i++)
+    remove((work_dir_ + "/" + std::to_string(i) + ".in").data());
+
+  rmdir(work_dir_.data());
+
+  if (!original_compiled)
+    return false;
+
+  // The mutant with the smallest id represents each group of identical
+  // objects.
+  std::vector<size_t> order(mutants.size());
+
+  for (size_t i = 0; i < order.size(); i++)
+    order[i] = i;
+
+  std::stable_sort(order.begin(), order.end(),
+                   [&mutants](size_t i, size_t j)
+                   { return mutants[i].first < mutants[j].first; });
+
+  std::map<uint64_t, uint64_t> first_mutant_of_hash;
+  results.assign(mutants.size(), TceResult());
+
+  for (auto idx: order)
+  {
+    TceResult &result = results[idx];
+    result.mutant_id_ = mutants[idx].first;
+    result.mutant_filename_ = mutants[idx].second.mutant_filename_;
+    result.duplicate_of_ = 0;
+
+    if (!compiled[idx])
+      result.status_ = kTceUncompilable;
+    else if (object_hashes[idx] == original_hash)
+      result.status_ = kTceEquivalent;
+    else
+    {
+      auto inserted = first_mutant_of_hash.insert(
+          std::make_pair(object_hashes[idx], result.mutant_id_));
+
+      if (inserted.second)
+        result.status_ = kTceUnique;
+      else
+      {
+        result.status_ = kTceDuplicate;
+        result.duplicate_of_ = inserted.first->second;
+      }
+    }
+  }
+
+  return true;
+}
+
+bool WriteTceResults(const std::string &filename,
+                     const std::vector<TceResult> &results)
+{
+  std::ofstream output(filename.data());
+
+  if (!output.is_open())
+    return false;
+
+  output << "Mutant Filename,Mutant Id,TCE Status,Duplicate Of\n";
+
+  for (auto &result: results)
+  {
+    output << result.mutant_filename_ << "," << result.mutant_id_ << "," <<
+              GetTceStatusName(result.status_) << ",";
+
+    if (result.status_ == kTceDuplicate)
+      output << result.duplicate_of_;
+
+    output << "\n";
+  }
+
+  return true;
+}
@@ -0,0 +1,98 @@
+#ifndef MUSIC_TCE_H_
+#define MUSIC_TCE_H_
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "patch_file.h"
+
+/**
+  Outcome of Trivial Compiler Equivalence for one mutant.
+
+  kTceEquivalent    object code is identical to the original's
+  kTceDuplicate     object code is identical to that of mutant duplicate_of_
+                    (the one with the smallest id among identical mutants)
+  kTceUnique        object code differs from the original and all others
+  kTceUncompilable  mutant does not compile with the original command
+*/
+enum TceStatus
+{
+  kTceUnique,
+  kTceEquivalent,
+  kTceDuplicate,
+  kTceUncompilable
+};
+
+struct TceResult
+{
+  uint64_t mutant_id_;
+  std::string mutant_filename_;
+  TceStatus status_;
+  uint64_t duplicate_of_;
+};
+
+const char* GetTceStatusName(TceStatus status);
+
+/**
+  Compile mutants of one source file with the command that compiles the
+  original file, and compare their object code.
+
+  Only the mutated file is compiled. Its content is given to the compiler
+  on stdin, so __FILE__ and the file symbol are the same for the original
+  and all mutants, and with -g0 appended so that debug information (e.g.
+  line numbers shifted by a mutation) does not tell objects apart.
+  Quoted includes are still searched in the directory of the original file.
+*/
+class TrivialCompilerEquivalence
+{
+public:
+  /**
+    @param  command_line compile command of original file (compiler first)
+            directory directory compile command runs in
+            source_filename source file argument of compile command
+            num_jobs number of compilers run in parallel
+  */
+  TrivialCompilerEquivalence(const std::vector<std::string> &command_line,
+                             const std::string &directory,
+                             const std::string &source_filename,
+                             unsigned num_jobs);
+
+  /**
+    @param  original content of original file
+            mutants mutant id and edit of each mutant
+            results output result of each mutant, in order of mutants
+    @return False if original file cannot be compiled
+  */
+  bool Run(const std::string &original,
+           const std::vector<std::pair<uint64_t, PatchRecord>> &mutants,
+           std::vector<TceResult> &results);
+
+private:
+  std::vector<std::string> compiler_args_;
+  std::string directory_;
+  std::string source_dir_;
+  bool is_cxx_;
+  unsigned num_jobs_;
+
+  // Directory holding sources and objects being compiled.
+  std::string work_dir_;
+
+  void MakeCompilerArgs(const std::vector<std::string> &command_line,
+                        const std::string &source_filename);
+
+  /**
+    Compile content as job job_idx and hash resulting object.
+
+    @return False if compilation fails
+  */
+  bool Compile(const std::string &content, unsigned job_idx,
+               uint64_t &object_hash);
+};
+
+// Write results as CSV. Return false if file cannot be written.
+bool WriteTceResults(const std::string &filename,
+                     const std::vector<TceResult> &results);
+
+#endif  // MUSIC_TCE_H_
@@ -0,0 +1,40 @@
+#!/bin/sh
+# music-run exits on error in which user provides invalid numbers of jobs
+# for option -j
+
+if test $# = 0; then
+    echo "Usage: sh filename.sh executable-COMUT"
+    echo "Error: no executable-COMUT file was given"
+    exit 1
+fi
+
+# DIR: the directory that this script is in
+DIR="$( cd "$( dirname "$0" )" && pwd )"
+
+# music-run is built next to COMUT
+RUN="`dirname $1`/music-run"
+
+echo "Executing $0"
+cd $DIR
+
+OUTPUT_FOLDER_NAME=output/invalid-jobs
+mkdir -p $OUTPUT_FOLDER_NAME
+
+for VALUE in "-1" "3x" "0" "4294967296" ""
+do
+    # Run music-run with the invalid value for option -j
+    $RUN -db $OUTPUT_FOLDER_NAME/test1_mut_db.csv -j "$VALUE" \
+         -r $OUTPUT_FOLDER_NAME/results.csv -- true > /dev/null 2>&1
+
+    # The test success if exit value is NOT 0
+    # and no results file is written
+    if test $? != 0 && test ! -e $OUTPUT_FOLDER_NAME/results.csv
+    then
+        echo "[SUCCESS] -j '$VALUE'"
+    else
+        echo "[FAIL] -j '$VALUE'"
+    fi
+done
+
+# Remove created output folder
+rm -R $OUTPUT_FOLDER_NAME
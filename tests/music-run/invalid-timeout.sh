@@ -0,0 +1,40 @@
+#!/bin/sh
+# music-run exits on error in which user provides invalid timeouts
+# for option -t
+
+if test $# = 0; then
+    echo "Usage: sh filename.sh executable-COMUT"
+    echo "Error: no executable-COMUT file was given"
+    exit 1
+fi
+
+# DIR: the directory that this script is in
+DIR="$( cd "$( dirname "$0" )" && pwd )"
+
+# music-run is built next to COMUT
+RUN="`dirname $1`/music-run"
+
+echo "Executing $0"
+cd $DIR
+
+OUTPUT_FOLDER_NAME=output/invalid-timeout
+mkdir -p $OUTPUT_FOLDER_NAME
+
+for VALUE in "abc" "-5" "1e3" "100ms" ""
+do
+    # Run music-run with the invalid value for option -t
+    $RUN -db $OUTPUT_FOLDER_NAME/test1_mut_db.csv -t "$VALUE" \
+         -r $OUTPUT_FOLDER_NAME/results.csv -- true > /dev/null 2>&1
+
+    # The test success if exit value is NOT 0
+    # and no results file is written
+    if test $? != 0 && test ! -e $OUTPUT_FOLDER_NAME/results.csv
+    then
+        echo "[SUCCESS] -t '$VALUE'"
+    else
+        echo "[FAIL] -t '$VALUE'"
+    fi
+done
+
+# Remove created output folder
+rm -R $OUTPUT_FOLDER_NAME
@@ -0,0 +1,71 @@
+#!/bin/sh
+# Mutants extracted from the pack archive of option -pack (and -pack-zlib)
+# by music-apply are the same as the mutant files COMUT writes without -pack.
+
+if test $# = 0; then
+    echo "Usage: sh filename.sh executable-COMUT"
+    echo "Error: no executable-COMUT file was given"
+    exit 1
+fi
+
+# DIR: the directory that this script is in
+DIR="$( cd "$( dirname "${BASH_SOURCE[0]}" )" && pwd )"
+
+# music-apply is built next to COMUT
+APPLY="`dirname $1`/music-apply"
+
+echo "Executing $0"
+cd input-src
+
+# Exit script if there is no input source file
+if test `find . -type f -name \* | wc -l` = 0 ; then
+    exit
+fi
+
+for TEST_INPUT in *
+do
+    cd $DIR
+
+    # make folder name in output directory with input source name without .c
+    OUTPUT_FOLDER_NAME=`echo "output/$TEST_INPUT" | sed 's/.\{2\}$//'`
+    PACK_NAME=`echo "$TEST_INPUT" | sed 's/.\{2\}$//'`_mut.pack
+
+    for PACK_OPTION in "-pack" "-pack -pack-zlib"
+    do
+        mkdir -p $OUTPUT_FOLDER_NAME/files $OUTPUT_FOLDER_NAME/pack \
+                 $OUTPUT_FOLDER_NAME/extracted
+
+        # Run the tool with the input source with and without the pack option,
+        # then extract all mutants of the pack archive
+        $1 input-src/${TEST_INPUT} -o $OUTPUT_FOLDER_NAME/files > /dev/null 2>&1
+        $1 input-src/${TEST_INPUT} -o $OUTPUT_FOLDER_NAME/pack $PACK_OPTION > /dev/null 2>&1
+        $APPLY -pack $OUTPUT_FOLDER_NAME/pack/$PACK_NAME \
+               -o $OUTPUT_FOLDER_NAME/extracted > /dev/null 2>&1
+
+        # The test success if music-apply succeeds, mutants are extracted
+        # and every extracted mutant is the same as the mutant file
+        RESULT=$?
+        NUM_OF_MUTANTS=`find ${OUTPUT_FOLDER_NAME}/extracted -type f -name \* | wc -l`
+
+        for MUTANT in `ls ${OUTPUT_FOLDER_NAME}/extracted`
+        do
+            if ! diff ${OUTPUT_FOLDER_NAME}/extracted/$MUTANT \
+                      ${OUTPUT_FOLDER_NAME}/files/$MUTANT > /dev/null 2>&1
+            then
+                RESULT=1
+            fi
+        done
+
+        if test $RESULT = 0 && test $NUM_OF_MUTANTS != 0
+        then
+            echo "[SUCCESS] $TEST_INPUT $PACK_OPTION round trip"
+        else
+            echo "[FAIL] $TEST_INPUT $PACK_OPTION round trip"
+        fi
+
+        # Remove created output folder for this input source file
+        rm -R $OUTPUT_FOLDER_NAME
+    done
+
+    cd input-src
+done
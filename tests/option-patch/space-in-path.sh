@@ -0,0 +1,72 @@
+#!/bin/sh
+# Mutants that music-apply produces from the patch file of option -patch are
+# the same as the mutant files COMUT writes without -patch, when the paths
+# of the input source and output directory contain spaces.
+
+if test $# = 0; then
+    echo "Usage: sh filename.sh executable-COMUT"
+    echo "Error: no executable-COMUT file was given"
+    exit 1
+fi
+
+# DIR: the directory that this script is in
+DIR="$( cd "$( dirname "$0" )" && pwd )"
+
+# music-apply is built next to COMUT
+APPLY="`dirname $1`/music-apply"
+
+echo "Executing $0"
+cd input-src
+
+# Exit script if there is no input source file
+if test `find . -type f -name \* | wc -l` = 0 ; then
+    exit
+fi
+
+for TEST_INPUT in *
+do
+    cd $DIR
+
+    # make folder name in output directory with input source name without .c
+    OUTPUT_FOLDER_NAME=`echo "output/$TEST_INPUT" | sed 's/.\{2\}$//'`
+    SOURCE="$OUTPUT_FOLDER_NAME/input dir/my $TEST_INPUT"
+    PATCH_NAME="my `echo "$TEST_INPUT" | sed 's/.\{2\}$//'`_mut.patch"
+
+    mkdir -p "$OUTPUT_FOLDER_NAME/input dir" "$OUTPUT_FOLDER_NAME/files dir" \
+             "$OUTPUT_FOLDER_NAME/patch dir" "$OUTPUT_FOLDER_NAME/extracted dir"
+    cp input-src/${TEST_INPUT} "$SOURCE"
+
+    # Run the tool with the input source with and without option -patch,
+    # then produce all mutants of the patch file
+    $1 "$SOURCE" -o "$OUTPUT_FOLDER_NAME/files dir" > /dev/null 2>&1
+    $1 "$SOURCE" -o "$OUTPUT_FOLDER_NAME/patch dir" -patch > /dev/null 2>&1
+    $APPLY "$OUTPUT_FOLDER_NAME/patch dir/$PATCH_NAME" "$SOURCE" \
+           -o "$OUTPUT_FOLDER_NAME/extracted dir" > /dev/null 2>&1
+
+    # The test success if music-apply succeeds, mutants are produced
+    # and every produced mutant is the same as the mutant file
+    RESULT=$?
+    NUM_OF_MUTANTS=`find "$OUTPUT_FOLDER_NAME/extracted dir" -type f | wc -l`
+
+    for MUTANT in "$OUTPUT_FOLDER_NAME/extracted dir"/*
+    do
+        if ! diff "$MUTANT" \
+                  "$OUTPUT_FOLDER_NAME/files dir/`basename "$MUTANT"`" \
+                  > /dev/null 2>&1
+        then
+            RESULT=1
+        fi
+    done
+
+    if test $RESULT = 0 && test $NUM_OF_MUTANTS != 0
+    then
+        echo "[SUCCESS] $TEST_INPUT space in path"
+    else
+        echo "[FAIL] $TEST_INPUT space in path"
+    fi
+
+    # Remove created output folder for this input source file
+    rm -R $OUTPUT_FOLDER_NAME
+
+    cd input-src
+done
@@ -0,0 +1,59 @@
+#!/bin/sh
+# With option -stable-ids, COMUT gives the same mutant ids to the mutants of
+# a project checked out in two different directories.
+
+if test $# = 0; then
+    echo "Usage: sh filename.sh executable-COMUT"
+    echo "Error: no executable-COMUT file was given"
+    exit 1
+fi
+
+# DIR: the directory that this script is in
+DIR="$( cd "$( dirname "${BASH_SOURCE[0]}" )" && pwd )"
+
+# The tool is run from within each checkout
+COMUT="$( cd "$( dirname "$1" )" && pwd )/`basename $1`"
+
+echo "Executing $0"
+cd input-src
+
+# Exit script if there is no input source file
+if test `find . -type f -name \* | wc -l` = 0 ; then
+    exit
+fi
+
+for TEST_INPUT in *
+do
+    cd $DIR
+
+    # make folder name in output directory with input source name without .c
+    OUTPUT_FOLDER_NAME=`echo "output/$TEST_INPUT" | sed 's/.\{2\}$//'`
+
+    for CHECKOUT in first second
+    do
+        mkdir -p $OUTPUT_FOLDER_NAME/$CHECKOUT/src $OUTPUT_FOLDER_NAME/$CHECKOUT/out
+        cp input-src/${TEST_INPUT} $OUTPUT_FOLDER_NAME/$CHECKOUT/src
+
+        # Run the tool with the input source relative to the checkout
+        (cd $OUTPUT_FOLDER_NAME/$CHECKOUT && \
+         $COMUT src/${TEST_INPUT} -o out -stable-ids > /dev/null 2>&1)
+    done
+
+    # The test success if mutants are generated
+    # and both checkouts get the same mutant files
+    NUM_OF_MUTANTS=`ls ${OUTPUT_FOLDER_NAME}/first/out | grep -c MUT`
+
+    if test $NUM_OF_MUTANTS != 0 && \
+       diff -r ${OUTPUT_FOLDER_NAME}/first/out \
+               ${OUTPUT_FOLDER_NAME}/second/out > /dev/null 2>&1
+    then
+        echo "[SUCCESS] $TEST_INPUT moved project"
+    else
+        echo "[FAIL] $TEST_INPUT moved project"
+    fi
+
+    # Remove created output folder for this input source file
+    rm -R $OUTPUT_FOLDER_NAME
+
+    cd input-src
+done
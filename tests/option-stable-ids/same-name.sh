@@ -0,0 +1,56 @@
+#!/bin/sh
+# With option -stable-ids, COMUT gives different mutant ids to the mutants
+# of two files with the same name in different directories.
+
+if test $# = 0; then
+    echo "Usage: sh filename.sh executable-COMUT"
+    echo "Error: no executable-COMUT file was given"
+    exit 1
+fi
+
+# DIR: the directory that this script is in
+DIR="$( cd "$( dirname "${BASH_SOURCE[0]}" )" && pwd )"
+
+echo "Executing $0"
+cd input-src
+
+# Exit script if there is no input source file
+if test `find . -type f -name \* | wc -l` = 0 ; then
+    exit
+fi
+
+for TEST_INPUT in *
+do
+    cd $DIR
+
+    # make folder name in output directory with input source name without .c
+    OUTPUT_FOLDER_NAME=`echo "output/$TEST_INPUT" | sed 's/.\{2\}$//'`
+    mkdir -p $OUTPUT_FOLDER_NAME/a $OUTPUT_FOLDER_NAME/b \
+             $OUTPUT_FOLDER_NAME/out-a $OUTPUT_FOLDER_NAME/out-b
+    cp input-src/${TEST_INPUT} $OUTPUT_FOLDER_NAME/a
+    cp input-src/${TEST_INPUT} $OUTPUT_FOLDER_NAME/b
+
+    # Run the tool on both copies of the input source
+    $1 $OUTPUT_FOLDER_NAME/a/${TEST_INPUT} -o $OUTPUT_FOLDER_NAME/out-a \
+       -stable-ids > /dev/null 2>&1
+    $1 $OUTPUT_FOLDER_NAME/b/${TEST_INPUT} -o $OUTPUT_FOLDER_NAME/out-b \
+       -stable-ids > /dev/null 2>&1
+
+    # The test success if mutants are generated for both copies
+    # and no mutant filename is used by both
+    NUM_OF_MUTANTS=`ls ${OUTPUT_FOLDER_NAME}/out-a | grep -c MUT`
+    NUM_OF_SHARED=`ls ${OUTPUT_FOLDER_NAME}/out-a ${OUTPUT_FOLDER_NAME}/out-b | \
+                   grep MUT | sort | uniq -d | wc -l`
+
+    if test $NUM_OF_MUTANTS != 0 && test $NUM_OF_SHARED = 0
+    then
+        echo "[SUCCESS] $TEST_INPUT same name"
+    else
+        echo "[FAIL] $TEST_INPUT same name"
+    fi
+
+    # Remove created output folder for this input source file
+    rm -R $OUTPUT_FOLDER_NAME
+
+    cd input-src
+done
@@ -0,0 +1,10 @@
+int main()
+{
+	int a = 0;
+	if (a > 0)
+	{
+		a += 1;
+	}
+	else
+		a = a * 2;
+}
\ No newline at end of file
@@ -13,6 +13,9 @@
 #include <cctype>
 #include <limits.h>
 #include <time.h>
+#include <atomic>
+#include <thread>
+#include <algorithm>
 
 #include "clang/AST/ASTConsumer.h"
 #include "clang/AST/RecursiveASTVisitor.h"
@@ -24,14 +27,19 @@
 #include "clang/Basic/TargetInfo.h"
 #include "clang/Frontend/CompilerInstance.h"
 #include "clang/Frontend/FrontendAction.h"
+#include "clang/Frontend/MultiplexConsumer.h"
 #include "clang/Lex/Preprocessor.h"
 #include "clang/Parse/ParseAST.h"
 #include "clang/Rewrite/Core/Rewriter.h"
 #include "clang/Rewrite/Frontend/Rewriters.h"
+#include "clang/Tooling/ArgumentsAdjusters.h"
 #include "clang/Tooling/CommonOptionsParser.h"
 #include "clang/Tooling/Tooling.h"
+#include "llvm/ADT/SmallString.h"
 #include "llvm/Support/CommandLine.h"
+#include "llvm/Support/FileSystem.h"
 #include "llvm/Support/Host.h"
+#include "llvm/Support/Path.h"
 #include "llvm/Support/raw_ostream.h"
 #include "llvm/ADT/IntrusiveRefCntPtr.h"
 #include "clang/Lex/HeaderSearch.h"
@@ -44,8 +52,13 @@
 #include "information_visitor.h"
 #include "information_gatherer.h"
 #include "mutant_database.h"
+#include "mutant_database_sink.h"
+#include "music_stats.h"
 #include "music_ast_consumer.h"
 #include "all_mutant_operators.h"
+#include "translation_unit_context.h"
+#include "tce.h"
+#include "unified_diff.h"
 
 // #include <cstring>
 // #include <cerrno>
@@ -261,16 +274,20 @@ void AddMutantOperator(string mutant_name,
       new_expr_operator->setRange(range);
 
     expr_operator_list.push_back(new_expr_operator);
-    cout << "added " << mutant_name << endl;
   }
 }
 
-void AddAllMutantOperator(vector<StmtMutantOperator*> &stmt_operator_list,
-                          vector<ExprMutantOperator*> &expr_operator_list)
+// Mutant operator requested by user, with its domain and range.
+// Every translation unit instantiates its own operators from these.
+struct MutantOperatorSpec
 {
+  string name;
   set<string> domain;
   set<string> range;
+};
 
+void AddAllMutantOperator(vector<MutantOperatorSpec> &spec_list)
+{
   set<string> stmt_mutant_operators{"SSDL", "OCNG"};
   set<string> expr_mutant_operators{
       "ORRN", "VTWF", "CRCR", "SANL", "SRWS", "SCSR", "VLSF", "VGSF", 
@@ -284,12 +301,26 @@ void AddAllMutantOperator(vector<StmtMutantOperator*> &stmt_operator_list,
       "OASN", "OLAN", "ORAN", "OLBN", "OLSN", "ORSN", "ORBN"};
 
   for (auto mutant_name: stmt_mutant_operators)
-    AddMutantOperator(mutant_name, domain, range, stmt_operator_list, 
-                      expr_operator_list);
+    spec_list.push_back(MutantOperatorSpec{mutant_name, {}, {}});
 
   for (auto mutant_name: expr_mutant_operators)
-    AddMutantOperator(mutant_name, domain, range, stmt_operator_list, 
+    spec_list.push_back(MutantOperatorSpec{mutant_name, {}, {}});
+}
+
+void CreateMutantOperators(const vector<MutantOperatorSpec> &spec_list,
+                           vector<StmtMutantOperator*> &stmt_operator_list,
+                           vector<ExprMutantOperator*> &expr_operator_list)
+{
+  for (auto spec: spec_list)
+  {
+    // setRange of some operators consumes predefined values from the set,
+    // so each operator gets its own copy of domain and range.
+    set<string> domain{spec.domain};
+    set<string> range{spec.range};
+
+    AddMutantOperator(spec.name, domain, range, stmt_operator_list,
                       expr_operator_list);
+  }
 }
 
 bool IsAllDigits(const string s)
@@ -473,6 +504,94 @@ static llvm::cl::list<string> OptionX(
     "x", llvm::cl::desc("Specify list of lines to exclude for mutant generation for each file"),
     llvm::cl::cat(MusicOptions));
 
+static llvm::cl::opt<unsigned int> OptionJ(
+    "j", llvm::cl::desc("Specify number of input files processed in parallel"),
+    llvm::cl::value_desc("numjobs"),
+    llvm::cl::init(1), llvm::cl::cat(MusicOptions));
+
+static llvm::cl::opt<bool> OptionPatch(
+    "patch", llvm::cl::desc("Record mutants as edits in a patch file instead of writing a source file per mutant"),
+    llvm::cl::cat(MusicOptions));
+
+static llvm::cl::opt<bool> OptionPack(
+    "pack", llvm::cl::desc("Write all mutants of each input file into one pack archive instead of writing a source file per mutant"),
+    llvm::cl::cat(MusicOptions));
+
+static llvm::cl::opt<bool> OptionPackZlib(
+    "pack-zlib", llvm::cl::desc("Compress mutants in the pack archive with zlib"),
+    llvm::cl::cat(MusicOptions));
+
+static llvm::cl::opt<string> OptionLayout(
+    "layout", llvm::cl::desc("Specify layout of mutant files in the output directory (flat, sharded)"),
+    llvm::cl::value_desc("layout"),
+    llvm::cl::init("flat"), llvm::cl::cat(MusicOptions));
+
+static llvm::cl::opt<bool> OptionStableIds(
+    "stable-ids", llvm::cl::desc("Derive each mutant id from its function, position in function, mutation operator and tokens, so that ids do not change between runs"),
+    llvm::cl::cat(MusicOptions));
+
+static llvm::cl::opt<bool> OptionSchemata(
+    "schemata", llvm::cl::desc("Write all mutants into one source file whose active mutant is chosen at runtime"),
+    llvm::cl::cat(MusicOptions));
+
+static llvm::cl::opt<bool> OptionTce(
+    "tce", llvm::cl::desc("Compile each mutant and mark mutants whose object code is identical to the original or to another mutant"),
+    llvm::cl::cat(MusicOptions));
+
+static llvm::cl::opt<unsigned int> OptionTceJobs(
+    "tce-jobs", llvm::cl::desc("Specify number of mutants compiled in parallel by -tce"),
+    llvm::cl::value_desc("numjobs"),
+    llvm::cl::init(0), llvm::cl::cat(MusicOptions));
+
+static llvm::cl::opt<bool> OptionIncremental(
+    "incremental", llvm::cl::desc("Reuse mutants of functions unchanged since the last run, recorded in a function cache in the output directory"),
+    llvm::cl::cat(MusicOptions));
+
+static llvm::cl::opt<string> OptionDiff(
+    "diff", llvm::cl::desc("Mutate only functions and lines changed by the given unified diff (implies -incremental)"),
+    llvm::cl::value_desc("difffile"),
+    llvm::cl::cat(MusicOptions));
+
+static llvm::cl::opt<string> OptionDiffBase(
+    "diff-base", llvm::cl::desc("Mutate only functions and lines changed since the given git revision (implies -incremental)"),
+    llvm::cl::value_desc("revision"),
+    llvm::cl::cat(MusicOptions));
+
+static llvm::cl::opt<unsigned long long> OptionSeed(
+    "seed", llvm::cl::desc("Specify seed of the selection of mutants by -l and -budget"),
+    llvm::cl::value_desc("seed"),
+    llvm::cl::init(0), llvm::cl::cat(MusicOptions));
+
+static llvm::cl::opt<unsigned int> OptionBudget(
+    "budget", llvm::cl::desc("Specify maximum number of mutants generated per input file"),
+    llvm::cl::value_desc("maxnum"),
+    llvm::cl::init(0), llvm::cl::cat(MusicOptions));
+
+static llvm::cl::list<string> OptionStratify(
+    "stratify", llvm::cl::desc("Share the -budget evenly between mutation operators, functions and/or lines (operator, function, line)"),
+    llvm::cl::value_desc("stratum"), llvm::cl::CommaSeparated,
+    llvm::cl::cat(MusicOptions));
+
+static llvm::cl::opt<string> OptionCountOnly(
+    "count-only", llvm::cl::desc("Write the number of mutants per file, function and mutation operator as JSON lines to the given file, without writing any other file"),
+    llvm::cl::value_desc("jsonfile"),
+    llvm::cl::cat(MusicOptions));
+
+static llvm::cl::opt<string> OptionPhaseStats(
+    "phase-stats", llvm::cl::desc("Write time spent per phase, mutation operator and function of each input file to the given JSON file"),
+    llvm::cl::value_desc("jsonfile"),
+    llvm::cl::cat(MusicOptions));
+
+static llvm::cl::opt<string> OptionPhaseStatsTrace(
+    "phase-stats-trace", llvm::cl::desc("Write time spent per phase and function of each input file to the given Chrome trace event file"),
+    llvm::cl::value_desc("tracefile"),
+    llvm::cl::cat(MusicOptions));
+
+static llvm::cl::list<string> OptionDbFormat(
+    "db-format", llvm::cl::desc("Specify format(s) of mutation database file (csv, jsonl, binary, indexed)"),
+    llvm::cl::value_desc("format"), llvm::cl::CommaSeparated,
+    llvm::cl::cat(MusicOptions));
+
 // static llvm::cl::list<unsigned int> OptionRE(
 //     "re", llvm::cl::multi_val(2),
 //     llvm::cl::cat(MusicOptions));
@@ -480,13 +599,9 @@ static llvm::cl::list<string> OptionX(
 // static llvm::cl::opt<string> OptionA("A", llvm::cl::cat(MusicOptions));
 // static llvm::cl::opt<string> OptionB("B", llvm::cl::cat(MusicOptions));
 
-InformationGatherer *g_gatherer;
-CompilerInstance *g_CI;
-Configuration *g_config;
-MutantDatabase *g_mutant_database;
-MusicContext *g_music_context;
-vector<ExprMutantOperator*> g_expr_mutant_operator_list;
-vector<StmtMutantOperator*> g_stmt_mutant_operator_list;
+// The following are set once while parsing options and only read afterwards,
+// so they are safe to share between worker threads.
+vector<MutantOperatorSpec> g_mutant_operator_specs;
 map<string, vector<int>> g_rs_list;
 map<string, vector<int>> g_re_list;
 map<string, vector<int>> g_exclude_list;
@@ -499,10 +614,48 @@ string g_output_dir = "./";
      at a location per mutant operator as possible. */
 int g_limit = UINT_MAX;
 
-string g_inputfile_name, g_mutdbfile_name;
-string g_current_inputfile_path;
-SourceLocation g_mutation_range_start;
-SourceLocation g_mutation_range_end;
+// Mutants selected by -l and -budget depend only on the seed, so runs
+// are reproducible.
+uint64_t g_sample_seed = 0;
+
+// By default, all mutants of an input file are generated.
+unsigned int g_budget = 0;
+
+// Strata the budget is shared between (option -stratify).
+bool g_stratify_by_operator = false;
+bool g_stratify_by_function = false;
+bool g_stratify_by_line = false;
+
+// By default, input files are processed one at a time.
+unsigned int g_num_jobs = 1;
+
+// Number of compilers run in parallel for each input file by option -tce.
+// Default shares the hardware threads between the -j workers, each of which
+// runs its own TCE.
+unsigned int g_tce_jobs = 1;
+
+// By default, all mutant files are written directly in the output directory.
+bool g_sharded_layout = false;
+
+// By default, mutation database is written in csv format only.
+vector<string> g_db_formats{"csv"};
+
+// Option -incremental, also turned on by -diff and -diff-base.
+bool g_incremental = false;
+
+// Changed lines of each file given by option -diff or -diff-base.
+bool g_use_diff = false;
+ChangedLineMap g_changed_lines;
+
+// Count lines of all input files with option -count-only.
+ofstream g_count_only_file;
+
+// Stats of all input files with option -phase-stats or -phase-stats-trace,
+// nullptr otherwise.
+MusicStatsCollector *g_stats = nullptr;
+
+// Path of MUSIC executable, used by clang to locate its resource directory.
+string g_main_executable;
 
 /*inline bool exists_test3 (const std::string& name) {
   struct stat buffer;   
@@ -729,16 +882,54 @@ void ParseOptionL()
   cout << "done with option l: " << g_limit << "\n";
 }
 
+void ParseOptionSampling()
+{
+  // Parse option -seed, -budget and -stratify (if provided)
+  g_sample_seed = OptionSeed;
+
+  if (OptionBudget.getNumOccurrences() != 0)
+  {
+    if (OptionBudget == 0)
+    {
+      cout << "Invalid input for -budget option, must be an positive integer smaller than 4294967296\n";
+      cout << "Usage: -budget <max>\n";
+      exit(1);
+    }
+
+    g_budget = OptionBudget;
+  }
+
+  if (!OptionStratify.empty() && g_budget == 0)
+  {
+    cout << "Option -stratify requires -budget\n";
+    exit(1);
+  }
+
+  for (auto stratum: OptionStratify)
+  {
+    if (stratum.compare("operator") == 0)
+      g_stratify_by_operator = true;
+    else if (stratum.compare("function") == 0)
+      g_stratify_by_function = true;
+    else if (stratum.compare("line") == 0)
+      g_stratify_by_line = true;
+    else
+    {
+      cout << "Invalid input for -stratify option: " << stratum << endl;
+      cout << "Usage: -stratify <operator|function|line>[,...]\n";
+      exit(1);
+    }
+  }
+
+  cout << "done with option seed: " << g_sample_seed << ", budget: " << 
+          g_budget << "\n";
+}
+
 void ParseOptionM() 
 {
   // Parse option -m (if provided)
   if (OptionM.empty())
-  {
-    AddAllMutantOperator(g_stmt_mutant_operator_list, 
-                         g_expr_mutant_operator_list);
-    cout << "done with option m\n";
-    return;
-  }
+    AddAllMutantOperator(g_mutant_operator_specs);
 
   for (auto e: OptionM)
   {
@@ -789,69 +980,346 @@ void ParseOptionM()
       }
     }
 
-    AddMutantOperator(mutant_operator[0], domain, range,
-                      g_stmt_mutant_operator_list,
-                      g_expr_mutant_operator_list);
+    g_mutant_operator_specs.push_back(
+        MutantOperatorSpec{mutant_operator[0], domain, range});
+  }
+
+  // Instantiate all operators once so that MUSIC terminates on invalid
+  // domain or range before any input file is processed.
+  vector<StmtMutantOperator*> stmt_operator_list;
+  vector<ExprMutantOperator*> expr_operator_list;
+  CreateMutantOperators(g_mutant_operator_specs, stmt_operator_list,
+                        expr_operator_list);
+
+  for (auto mutant_operator: stmt_operator_list)
+    delete mutant_operator;
+
+  for (auto mutant_operator: expr_operator_list)
+  {
+    cout << "added " << mutant_operator->getName() << endl;
+    delete mutant_operator;
   }
 
   // return 0;
   cout << "done with option m\n";
 }
 
+void ParseOptionJ()
+{
+  // Parse option -j (if provided)
+  // Given input should be a positive integer.
+  if (OptionJ == 0)
+  {
+    cout << "Invalid input for -j option, must be an positive integer smaller than 4294967296\n";
+    cout << "Usage: -j <numjobs>\n";
+    exit(1);
+  }
+
+  g_num_jobs = OptionJ;
+
+  cout << "done with option j: " << g_num_jobs << "\n";
+}
+
+void ParseOptionTceJobs()
+{
+  // Parse option -tce-jobs (if provided)
+  // Given input should be a positive integer.
+  if (OptionTceJobs.getNumOccurrences() == 0)
+  {
+    g_tce_jobs = max(1u, thread::hardware_concurrency() / g_num_jobs);
+    return;
+  }
+
+  if (OptionTceJobs == 0)
+  {
+    cout << "Invalid input for -tce-jobs option, must be an positive integer smaller than 4294967296\n";
+    cout << "Usage: -tce-jobs <numjobs>\n";
+    exit(1);
+  }
+
+  g_tce_jobs = OptionTceJobs;
+}
+
+void ParseOptionDiff()
+{
+  // Parse option -incremental, -diff and -diff-base (if provided)
+  g_incremental = OptionIncremental;
+
+  if (OptionDiff.empty() && OptionDiffBase.empty())
+    return;
+
+  if (!OptionDiff.empty() && !OptionDiffBase.empty())
+  {
+    cout << "Options -diff and -diff-base cannot be used together\n";
+    exit(1);
+  }
+
+  if (!OptionDiff.empty() && !ReadUnifiedDiffFile(OptionDiff, g_changed_lines))
+  {
+    cout << "Cannot read unified diff file: " << OptionDiff << endl;
+    exit(1);
+  }
+
+  if (!OptionDiffBase.empty() && 
+      !ReadGitDiff(OptionDiffBase, g_changed_lines))
+  {
+    cout << "Cannot get git diff against revision: " << OptionDiffBase << endl;
+    exit(1);
+  }
+
+  g_use_diff = true;
+  g_incremental = true;
+
+  cout << "done with option diff: " << g_changed_lines.size() << 
+          " changed files\n";
+}
+
+void ParseOptionLayout()
+{
+  // Parse option -layout, -pack and -pack-zlib (if provided)
+  if (OptionLayout.compare("sharded") == 0)
+    g_sharded_layout = true;
+  else if (OptionLayout.compare("flat") != 0)
+  {
+    cout << "Invalid input for -layout option: " << OptionLayout << endl;
+    cout << "Usage: -layout <flat|sharded>\n";
+    exit(1);
+  }
+
+  if (OptionPack && OptionPatch)
+  {
+    cout << "Options -pack and -patch cannot be used together\n";
+    exit(1);
+  }
+
+  if (OptionPackZlib && !OptionPack)
+  {
+    cout << "Option -pack-zlib requires -pack\n";
+    exit(1);
+  }
+
+  cout << "done with option layout: " << OptionLayout << "\n";
+}
+
+void ParseOptionCountOnly()
+{
+  // Parse option -count-only (if provided)
+  // Given file must be writable, as counts are not printed.
+  if (OptionCountOnly.empty())
+    return;
+
+  g_count_only_file.open(OptionCountOnly.data(), ios::trunc);
+
+  if (!g_count_only_file.is_open())
+  {
+    cout << "Invalid file for -count-only option: " << OptionCountOnly << endl;
+    cout << "Usage: -count-only <jsonfile>\n";
+    exit(1);
+  }
+
+  cout << "done with option count-only: " << OptionCountOnly << "\n";
+}
+
+void ParseOptionDbFormat()
+{
+  // Parse option -db-format (if provided)
+  // Every given format should be the name of a registered database sink.
+  if (OptionDbFormat.empty())
+    return;
+
+  g_db_formats.clear();
+
+  for (auto format: OptionDbFormat)
+  {
+    if (!IsMutantDatabaseSinkRegistered(format))
+    {
+      cout << "Invalid input for -db-format option: " << format << endl;
+      cout << "Supported formats:";
+      for (auto name: GetMutantDatabaseSinkNames())
+        cout << " " << name;
+      cout << endl;
+      exit(1);
+    }
+
+    if (find(g_db_formats.begin(), g_db_formats.end(), format) == \
+        g_db_formats.end())
+      g_db_formats.push_back(format);
+  }
+
+  cout << "done with option db-format\n";
+}
+
+/**
+  Hash of the options that decide which mutants are generated for an input
+  file: mutation operators with their domain and range, -l, -seed, -budget,
+  -stratify, -stable-ids, and the -rs, -re and -x of the file. Recorded in
+  the function cache, which is not reused when it differs.
+*/
+uint64_t GetMutationOptionsHash(const string &inputfile_name,
+                                const string &input_file_path)
+{
+  stringstream key;
+
+  for (auto &spec: g_mutant_operator_specs)
+  {
+    key << spec.name << ":";
+    for (auto &domain: spec.domain)
+      key << domain.length() << ":" << domain;
+    key << ":";
+    for (auto &range: spec.range)
+      key << range.length() << ":" << range;
+    key << ";";
+  }
+
+  key << "l" << g_limit << " seed" << g_sample_seed << " budget" << 
+         g_budget << " stratify" << g_stratify_by_operator << 
+         g_stratify_by_function << g_stratify_by_line << " stable" << 
+         OptionStableIds;
+
+  auto rs_iter = g_rs_list.find(inputfile_name);
+  if (rs_iter != g_rs_list.end())
+    for (auto num: rs_iter->second)
+      key << " rs" << num;
+
+  auto re_iter = g_re_list.find(inputfile_name);
+  if (re_iter != g_re_list.end())
+    for (auto num: re_iter->second)
+      key << " re" << num;
+
+  auto exclude_iter = g_exclude_list.find(inputfile_name);
+  if (exclude_iter == g_exclude_list.end())
+    exclude_iter = g_exclude_list.find(input_file_path);
+  if (exclude_iter != g_exclude_list.end())
+    for (auto line_num: exclude_iter->second)
+      key << " x" << line_num;
+
+  return HashFileContent(key.str());
+}
+
+/**
+  Path of input file relative to the directory of its compile command
+  (e.g. src/test.c for a compilation database in the project root), the
+  same wherever the project is checked out. Absolute if the file is
+  outside of that directory.
+*/
+string GetPathInBuildDirectory(const string &input_file_path)
+{
+  string file{tooling::getAbsolutePath(input_file_path)};
+  vector<tooling::CompileCommand> compile_commands = \
+      g_option_parser->getCompilations().getCompileCommands(file);
+
+  llvm::SmallString<256> path(file);
+  llvm::sys::path::remove_dots(path, true);
+
+  if (compile_commands.empty())
+    return path.str();
+
+  llvm::SmallString<256> directory(
+      tooling::getAbsolutePath(compile_commands.front().Directory));
+  llvm::sys::path::remove_dots(directory, true);
+
+  while (directory.size() > 1 &&
+         llvm::sys::path::is_separator(directory.back()))
+    directory.pop_back();
+
+  llvm::StringRef relative_path{path};
+
+  if (!relative_path.startswith(directory) ||
+      relative_path.size() <= directory.size() + 1 ||
+      !llvm::sys::path::is_separator(relative_path[directory.size()]))
+    return path.str();
+
+  return relative_path.substr(directory.size() + 1);
+}
+
+/**
+  Start a phase of stats when the AST is handed to it, that is before the
+  consumers after it in a MultiplexConsumer (options -phase-stats and
+  -phase-stats-trace).
+*/
+class StatsPhaseConsumer : public ASTConsumer
+{
+public:
+  StatsPhaseConsumer(MusicStats *stats, string phase_name)
+    : stats_(stats), phase_name_(phase_name)
+  {}
+
+  void HandleTranslationUnit(ASTContext &Context) override
+  {
+    stats_->BeginPhase(phase_name_);
+  }
+
+private:
+  MusicStats *stats_;
+  string phase_name_;
+};
+
 class GenerateMutantAction : public ASTFrontendAction
 {
+public:
+  GenerateMutantAction(TranslationUnitContext &tu_context)
+    : tu_context_(tu_context)
+  {}
+
 protected:
   void ExecuteAction() override
   {
     CompilerInstance &CI = getCompilerInstance();
     CI.getPreprocessor().createPreprocessingRecord();
     
+    // Parse once. Information gathering and mutant generation are both
+    // done by the consumer returned from CreateASTConsumer.
+    MusicStats *stats = tu_context_.getStats();
+
+    if (stats != nullptr)
+      stats->BeginPhase("parse");
+
     cout << "executing action from GenerateMutantAction\n";
     ASTFrontendAction::ExecuteAction();
     cout << "done execute action\n";
 
+    if (stats != nullptr)
+      stats->BeginPhase("export");
+
     //=================================================
     //==================== OUTPUT =====================
     //=================================================
-    /* Open the file with mode TRUNC to create the file if not existed
-    or delete content if existed. */
-    string filename{"/home/duyloc1503/comut-libtool/src/" + g_mutdbfile_name};
-
-    ofstream out_mutDb(g_mutdbfile_name.data(), ios::trunc);
-
-    if (!out_mutDb.is_open())
-      std::cerr<<"Failed to open file : "<<strerror(errno)<<std::endl;
+    // Database files are created by the sinks selected with -db-format.
+    // With -count-only, mutants are only counted.
+    if (tu_context_.getConfiguration()->getCountOnly())
+      tu_context_.getMutantDatabase()->WriteEntryCounts(g_count_only_file);
     else
-      cout << "opened file name " << g_mutdbfile_name << endl;
-
-    out_mutDb << "Mutant Filename,Mutation Operator,Line#,Before Mutation,,,,,After Mutation" << endl;
-    out_mutDb << ",,,Start Line#,Start Col#,End Line#,End Col#,Target Token,";
-    out_mutDb << "Start Line#,Start Col#,End Line#,End Col#,Mutated Token" << endl;
-    out_mutDb.close();
+      tu_context_.getMutantDatabase()->ExportAllEntries();
+    // tu_context_.getMutantDatabase()->WriteAllEntriesToDatabaseFile();
 
-    g_mutant_database->ExportAllEntries();
-    // g_mutant_database->WriteAllEntriesToDatabaseFile();
+    if (stats != nullptr)
+      stats->EndPhase();
   }
 
 public:
   virtual unique_ptr<ASTConsumer> CreateASTConsumer(
       CompilerInstance &CI, llvm::StringRef InFile)
   {
+    string inputfile_name{tu_context_.getInputFilename()};
+
     // Parse rs and re option.
     SourceManager &sm = CI.getSourceManager();
-    g_mutation_range_start = sm.getLocForStartOfFile(sm.getMainFileID());
-    g_mutation_range_end = sm.getLocForEndOfFile(sm.getMainFileID());
+    SourceLocation mutation_range_start = sm.getLocForStartOfFile(
+        sm.getMainFileID());
+    SourceLocation mutation_range_end = sm.getLocForEndOfFile(
+        sm.getMainFileID());
 
     // If user specifies range for this input file,
     // verify that the given input range start is valid before setting 
-    // g_mutation_range_start.
-    if (g_rs_list.count(g_inputfile_name))
+    // mutation_range_start.
+    auto rs_iter = g_rs_list.find(inputfile_name);
+    if (rs_iter != g_rs_list.end())
     {
-      int line_num = g_rs_list[g_inputfile_name].front();
+      int line_num = rs_iter->second.front();
       int col_num = 1;
 
-      if (g_rs_list[g_inputfile_name].size() == 2)
-        col_num = g_rs_list[g_inputfile_name].back();
+      if (rs_iter->second.size() == 2)
+        col_num = rs_iter->second.back();
 
       SourceLocation interpreted_loc = sm.translateLineCol(
           sm.getMainFileID(), line_num, col_num);
@@ -863,17 +1331,18 @@ public:
         exit(1);
       }
 
-      g_mutation_range_start = sm.translateLineCol(
+      mutation_range_start = sm.translateLineCol(
           sm.getMainFileID(), line_num, col_num);
     }
 
-    if (g_re_list.count(g_inputfile_name))
+    auto re_iter = g_re_list.find(inputfile_name);
+    if (re_iter != g_re_list.end())
     {
-      int line_num = g_re_list[g_inputfile_name].front();
+      int line_num = re_iter->second.front();
       int col_num = 1;
 
-      if (g_re_list[g_inputfile_name].size() == 2)
-        col_num = g_re_list[g_inputfile_name].back();
+      if (re_iter->second.size() == 2)
+        col_num = re_iter->second.back();
 
       SourceLocation interpreted_loc = sm.translateLineCol(
           sm.getMainFileID(), line_num, col_num);
@@ -885,97 +1354,273 @@ public:
         exit(1);
       }
 
-      g_mutation_range_end = sm.translateLineCol(
+      mutation_range_end = sm.translateLineCol(
           sm.getMainFileID(), line_num, col_num);
     }
 
-    // cout << g_inputfile_name << endl;
-    // PrintLocation(sm, g_mutation_range_start);
-    // PrintLocation(sm, g_mutation_range_end);
-
     vector<int> excluded_lines;
-    if (g_exclude_list.count(g_inputfile_name))
-      excluded_lines = vector<int>(g_exclude_list[g_inputfile_name]);
-    else
-      if (g_exclude_list.count(g_current_inputfile_path))
-        excluded_lines = vector<int>(g_exclude_list[g_current_inputfile_path]); 
+    auto exclude_iter = g_exclude_list.find(inputfile_name);
+    if (exclude_iter == g_exclude_list.end())
+      exclude_iter = g_exclude_list.find(tu_context_.getInputFilePath());
+    if (exclude_iter != g_exclude_list.end())
+      excluded_lines = exclude_iter->second;
 
     /* Create Configuration object pointer to pass as attribute 
        for MusicASTConsumer. */
-    g_config = new Configuration(
-        g_inputfile_name, g_mutdbfile_name, g_mutation_range_start, 
-        g_mutation_range_end, excluded_lines, g_output_dir, g_limit);
-
-    // for (auto e: g_config->getExcludedLines())
-    //   cout << e << endl;
-    // exit(1);
-
-    g_mutant_database = new MutantDatabase(
-        &CI, g_config->getInputFilename(),
-        g_config->getOutputDir(), g_limit);
-
-    g_music_context = new MusicContext(
-        &CI, g_config, g_gatherer->getLabelToGotoListMap(),
-        g_gatherer->getSymbolTable(), *g_mutant_database);
-
-    return unique_ptr<ASTConsumer>(new MusicASTConsumer(
-        &CI, g_gatherer->getLabelToGotoListMap(),
-        g_stmt_mutant_operator_list,
-        g_expr_mutant_operator_list, *g_music_context));
+    Configuration *config = new Configuration(
+        inputfile_name, tu_context_.getMutationDbFilename(),
+        mutation_range_start, mutation_range_end, excluded_lines,
+        g_output_dir, g_limit);
+    config->setPatchOutput(OptionPatch);
+    config->setPackOutput(OptionPack, OptionPackZlib);
+    config->setShardedLayout(g_sharded_layout);
+    config->setStableIds(OptionStableIds);
+    config->setSchemataOutput(OptionSchemata);
+    config->setTce(OptionTce);
+    config->setIncremental(g_incremental);
+    config->setCountOnly(!OptionCountOnly.empty());
+    config->setSampleSeed(g_sample_seed);
+    config->setMutantBudget(g_budget);
+    config->setStratification(g_stratify_by_operator, g_stratify_by_function,
+                              g_stratify_by_line);
+    config->setMutationOptionsHash(GetMutationOptionsHash(
+        inputfile_name, tu_context_.getInputFilePath()));
+    config->setInputFilePath(
+        GetPathInBuildDirectory(tu_context_.getInputFilePath()));
+
+    if (g_use_diff)
+    {
+      const vector<LineRange> *changed_lines = FindChangedLines(
+          g_changed_lines, 
+          tooling::getAbsolutePath(tu_context_.getInputFilePath()));
+
+      config->setChangedLines(changed_lines != nullptr ? 
+                              *changed_lines : vector<LineRange>());
+    }
+
+    config->setDatabaseFormats(g_db_formats);
+    tu_context_.setConfiguration(config);
+
+    // The gatherer needs the mutation range to skip functions outside it.
+    InformationGatherer *gatherer = new InformationGatherer(&CI, config);
+    tu_context_.setGatherer(gatherer);
+
+    MutantDatabase *mutant_database = new MutantDatabase(&CI, config);
+    tu_context_.setMutantDatabase(mutant_database);
+
+    SymbolTable *symbol_table = gatherer->getSymbolTable();
+    tu_context_.setSymbolTable(symbol_table);
+
+    MusicContext *music_context = new MusicContext(
+        &CI, config, gatherer->getLabelToGotoListMap(),
+        gatherer->getLabelIndex(), symbol_table, *mutant_database);
+    tu_context_.setMusicContext(music_context);
+
+    MusicStats *stats = tu_context_.getStats();
+    music_context->setStats(stats);
+
+    // Both consumers share the one AST of this translation unit.
+    // MultiplexConsumer runs them in order so information gathering
+    // (symbol table, label map) completes before mutation traversal starts.
+    vector<unique_ptr<ASTConsumer>> consumers;
+
+    if (stats != nullptr)
+      consumers.push_back(unique_ptr<ASTConsumer>(
+          new StatsPhaseConsumer(stats, "gather")));
+
+    consumers.push_back(unique_ptr<ASTConsumer>(gatherer));
+
+    if (stats != nullptr)
+      consumers.push_back(unique_ptr<ASTConsumer>(
+          new StatsPhaseConsumer(stats, "traverse")));
+
+    consumers.push_back(unique_ptr<ASTConsumer>(new MusicASTConsumer(
+        &CI, gatherer->getLabelToGotoListMap(),
+        tu_context_.getStmtOperatorList(),
+        tu_context_.getExprOperatorList(), *music_context)));
+
+    return unique_ptr<ASTConsumer>(new MultiplexConsumer(move(consumers)));
   }
+
+private:
+  TranslationUnitContext &tu_context_;
 };
 
-class GatherDataAction : public ASTFrontendAction
+class GenerateMutantActionFactory : public tooling::FrontendActionFactory
 {
-protected:
-  void ExecuteAction() override
+public:
+  GenerateMutantActionFactory(TranslationUnitContext &tu_context)
+    : tu_context_(tu_context)
+  {}
+
+  FrontendAction *create() override
   {
-    CompilerInstance &CI = getCompilerInstance();
-    CI.getPreprocessor().createPreprocessingRecord();
+    return new GenerateMutantAction(tu_context_);
+  }
 
-    HeaderSearchOptions &hso = CI.getHeaderSearchOpts();
+private:
+  TranslationUnitContext &tu_context_;
+};
 
-    cout << "executing action from GatherDataAction\n";
-    ASTFrontendAction::ExecuteAction();
+/**
+  Compile every mutant exported for an input file with the compile command
+  of the file, and write which mutants are equivalent to the original or
+  duplicates of another mutant to <inputfilename>_mut_db_tce.csv.
 
-    // cout << g_gatherer->getLabelToGotoListMap()->size() << endl;
+  @param  tu_context context of input file, after mutants are exported
+          compile_command compile command of input file
+*/
+void RunTceOnFile(TranslationUnitContext &tu_context,
+                  const tooling::CompileCommand &compile_command)
+{
+  MutantDatabase *mutant_database = tu_context.getMutantDatabase();
+  string original;
 
-    vector<string> source{g_current_inputfile_path};
+  if (!ReadWholeFile(tooling::getAbsolutePath(tu_context.getInputFilePath()),
+                     original))
+  {
+    cout << "TCE: cannot read " << tu_context.getInputFilePath() << endl;
+    return;
+  }
 
-    tooling::ClangTool Tool2(g_option_parser->getCompilations(),
-                             source);
+  TrivialCompilerEquivalence tce(
+      compile_command.CommandLine, compile_command.Directory,
+      compile_command.Filename, g_tce_jobs);
+  vector<TceResult> results;
 
-    Tool2.run(tooling::newFrontendActionFactory<GenerateMutantAction>().get());
+  if (!tce.Run(original, mutant_database->getExportedEdits(), results))
+  {
+    cout << "TCE: cannot compile original " << tu_context.getInputFilePath()
+         << endl;
+    return;
   }
 
-public:  
-  virtual unique_ptr<ASTConsumer> CreateASTConsumer(
-      CompilerInstance &CI, llvm::StringRef InFile)
+  string tce_filename{mutant_database->getDatabasePathPrefix() + "_tce.csv"};
+
+  if (!WriteTceResults(tce_filename, results))
   {
-    g_CI = &CI;
-    g_gatherer = new InformationGatherer(&CI);
-    return unique_ptr<ASTConsumer>(g_gatherer);
+    cout << "Failed to open file : " << tce_filename << endl;
+    return;
   }
-};
+
+  map<string, int> status_count;
+
+  for (auto &result: results)
+    status_count[GetTceStatusName(result.status_)] += 1;
+
+  cout << "TCE on " << tu_context.getInputFilename() << ":";
+
+  for (auto it: status_count)
+    cout << " " << it.second << " " << it.first;
+
+  cout << endl;
+}
+
+/**
+  Run MUSIC on a single input file with the compile command recorded for it
+  in the compilation database.
+
+  This does what ClangTool::run does for one file, except that it never
+  changes the working directory of the process. Relative paths in the compile
+  command are resolved against the command's directory by the FileManager
+  and by the driver (-working-directory), so several files can be processed
+  by different threads at the same time.
+
+  @param  tu_context context holding all state for this input file
+  @return True if clang ran successfully on the file
+          False otherwise
+*/
+bool RunMusicOnFile(TranslationUnitContext &tu_context)
+{
+  string file{tooling::getAbsolutePath(tu_context.getInputFilePath())};
+  vector<tooling::CompileCommand> compile_commands = \
+      g_option_parser->getCompilations().getCompileCommands(file);
+
+  if (compile_commands.empty())
+  {
+    llvm::errs() << "Skipping " << file << ". Compile command not found.\n";
+    return false;
+  }
+
+  tooling::ArgumentsAdjuster args_adjuster = tooling::combineAdjusters(
+      tooling::getClangStripOutputAdjuster(),
+      tooling::getClangSyntaxOnlyAdjuster());
+
+  GenerateMutantActionFactory action_factory(tu_context);
+  bool success = true;
+
+  for (auto &compile_command: compile_commands)
+  {
+    vector<string> command_line = args_adjuster(
+        compile_command.CommandLine, compile_command.Filename);
+
+    // Let clang find its builtin headers relative to MUSIC executable.
+    command_line[0] = g_main_executable;
+    command_line.insert(command_line.begin() + 1,
+                        "-working-directory=" + compile_command.Directory);
+
+    FileSystemOptions file_system_options;
+    file_system_options.WorkingDir = compile_command.Directory;
+    IntrusiveRefCntPtr<FileManager> files(
+        new FileManager(file_system_options));
+
+    tooling::ToolInvocation invocation(
+        move(command_line), action_factory.create(), files.get());
+
+    if (!invocation.run())
+      success = false;
+    else if (OptionTce && OptionCountOnly.empty() &&
+             tu_context.getMutantDatabase() != nullptr)
+    {
+      if (tu_context.getStats() != nullptr)
+        tu_context.getStats()->BeginPhase("tce");
+
+      RunTceOnFile(tu_context, compile_command);
+
+      if (tu_context.getStats() != nullptr)
+        tu_context.getStats()->EndPhase();
+    }
+  }
+
+  return success;
+}
 
 int main(int argc, const char *argv[])
 {
+  // Options are parsed and the compilation database is loaded together.
+  StatsClock::time_point start_time = StatsClock::now();
+
   g_option_parser = new tooling::CommonOptionsParser(
       argc, argv, MusicOptions/*, llvm::cl::Optional*/);
 
-  // Randomization for option -l.
-  srand (time(NULL));
+  if (!OptionPhaseStats.empty() || !OptionPhaseStatsTrace.empty())
+  {
+    g_stats = new MusicStatsCollector(start_time);
+    g_stats->AddPhase("load_compilation_database", start_time,
+                      StatsClock::now());
+  }
+
+  g_main_executable = llvm::sys::fs::getMainExecutable(
+      argv[0], reinterpret_cast<void *>(&main));
 
   ParseOptionRS();
   ParseOptionRE();
   ParseOptionX();
   ParseOptionO();
   ParseOptionL();
+  ParseOptionSampling();
   ParseOptionM();
+  ParseOptionJ();
+  ParseOptionTceJobs();
+  ParseOptionDbFormat();
+  ParseOptionCountOnly();
+  ParseOptionLayout();
+  ParseOptionDiff();
 
   // ofstream my_file("/home/duyloc1503/comut-libtool/multiple-compile-command-files.txt", ios::trunc);    
 
-  /* Run tool separately for each input file. */
+  vector<string> source_list;
+
   for (auto file: g_option_parser->getSourcePathList())
   { 
     // cout << "Running MUSIC on " << file << endl;
@@ -995,55 +1640,81 @@ int main(int argc, const char *argv[])
       continue;
     }
 
-    // Print all compilation for this file
-    // int counter = 0;
-    // for (auto e: g_option_parser->getCompilations().getCompileCommands(file))
-    // {
-    //   counter++;
-    //   cout << "==========" << counter << "==========\n";
-    //   cout << e.Directory << endl;
-    //   cout << e.Filename << endl;
-    //   for (auto command: e.CommandLine)
-    //     cout << command << " ";
-    //   cout << endl;
-    //   cout << "=====================\n";
-    // }
-
-    // getchar();  // pause the program 
-    g_current_inputfile_path = file;
-
-    // inputfile name is the string after the last slash (/)
-    // in the provided path to inputfile. 
-    string inputfile_path = file;
-    vector<string> path;
-    SplitStringIntoVector(inputfile_path, path, string("/"));
-    g_inputfile_name = path.back();
-
-    // Make mutation database file named <inputfilename>_mut_db.out
-    g_mutdbfile_name = g_output_dir;
-
-    if (g_mutdbfile_name.back() != '/')
-      g_mutdbfile_name += "/";
-
-    g_mutdbfile_name.append(g_inputfile_name, 0, g_inputfile_name.length()-2);
-    g_mutdbfile_name += "_mut_db.csv";
-
-    cout << "g_current_inputfile_path = " << g_current_inputfile_path << endl;
-    cout << "g_inputfile_name = " << g_inputfile_name << endl;
-    cout << "g_mutdbfile_name = " << g_mutdbfile_name << endl;
-
-    vector<string> source{g_current_inputfile_path};
-  
-    // Run tool
-    tooling::ClangTool Tool1(g_option_parser->getCompilations(),
-                             source);
-
-    Tool1.run(tooling::newFrontendActionFactory<GatherDataAction>().get());
-
-    cout << "Done tooling on " << file << endl;
+    source_list.push_back(file);
+  }
+
+  // Each worker repeatedly takes the next unprocessed input file and runs
+  // MUSIC on it with its own TranslationUnitContext.
+  atomic<size_t> next_file_idx{0};
+
+  auto worker = [&source_list, &next_file_idx]()
+  {
+    size_t idx;
+
+    while ((idx = next_file_idx++) < source_list.size())
+    {
+      TranslationUnitContext tu_context(source_list[idx], g_output_dir);
+
+      // Output of the last run is still valid for files the diff of option
+      // -diff does not change, if it was made with the same options.
+      FunctionCache cache;
+
+      if (g_use_diff && 
+          FindChangedLines(g_changed_lines, 
+                           tooling::getAbsolutePath(source_list[idx])) == \
+          nullptr &&
+          ReadFunctionCache(tu_context.getFunctionCacheFilename(), cache) &&
+          cache.options_hash_ == GetMutationOptionsHash(
+              tu_context.getInputFilename(), tu_context.getInputFilePath()))
+      {
+        cout << "Skipping " << source_list[idx] << ". Not changed since last run.\n";
+        continue;
+      }
+
+      CreateMutantOperators(g_mutant_operator_specs,
+                            tu_context.getStmtOperatorList(),
+                            tu_context.getExprOperatorList());
+
+      if (g_stats != nullptr)
+        tu_context.setStats(new MusicStats(source_list[idx]));
+
+      cout << "current input file path = " << tu_context.getInputFilePath() << endl;
+      cout << "input file name = " << tu_context.getInputFilename() << endl;
+      cout << "mutation database file name = " << tu_context.getMutationDbFilename() << endl;
+
+      RunMusicOnFile(tu_context);
+
+      if (g_stats != nullptr)
+        g_stats->AddFile(*tu_context.getStats());
+
+      cout << "Done tooling on " << source_list[idx] << endl;
+    }
+  };
+
+  /* Run tool separately for each input file. */
+  size_t num_workers = min<size_t>(g_num_jobs, source_list.size());
+
+  if (num_workers <= 1)
+    worker();
+  else
+  {
+    vector<thread> worker_pool;
+
+    for (size_t i = 0; i < num_workers; ++i)
+      worker_pool.push_back(thread(worker));
+
+    for (auto &t: worker_pool)
+      t.join();
   }
 
   // my_file.close();
 
+  if (!OptionPhaseStats.empty() && !g_stats->WriteJson(OptionPhaseStats))
+    cout << "Failed to open file : " << OptionPhaseStats << endl;
+
+  if (!OptionPhaseStatsTrace.empty() &&
+      !g_stats->WriteTrace(OptionPhaseStatsTrace))
+    cout << "Failed to open file : " << OptionPhaseStatsTrace << endl;
+
   return 0;
 }
@@ -0,0 +1,132 @@
+#include "music_utility.h"
+#include "translation_unit_context.h"
+
+TranslationUnitContext::TranslationUnitContext(
+    std::string inputfile_path, std::string output_dir)
+  : inputfile_path_(inputfile_path), config_(nullptr),
+    mutant_database_(nullptr), symbol_table_(nullptr),
+    music_context_(nullptr), gatherer_(nullptr), stats_(nullptr)
+{
+  // inputfile name is the string after the last slash (/)
+  // in the provided path to inputfile.
+  vector<string> path;
+  SplitStringIntoVector(inputfile_path, path, string("/"));
+  inputfile_name_ = path.back();
+
+  // Make mutation database file named <inputfilename>_mut_db.csv
+  mutdbfile_name_ = output_dir;
+
+  if (mutdbfile_name_.back() != '/')
+    mutdbfile_name_ += "/";
+
+  mutdbfile_name_.append(inputfile_name_, 0, inputfile_name_.length()-2);
+  mutdbfile_name_ += "_mut_db";
+
+  // Function cache is named <inputfilename>_mut_db.fcache
+  function_cache_name_ = mutdbfile_name_ + ".fcache";
+  mutdbfile_name_ += ".csv";
+}
+
+TranslationUnitContext::~TranslationUnitContext()
+{
+  for (auto mutant_operator: stmt_operator_list_)
+    delete mutant_operator;
+
+  for (auto mutant_operator: expr_operator_list_)
+    delete mutant_operator;
+
+  delete music_context_;
+  delete stats_;
+  delete symbol_table_;
+  delete mutant_database_;
+  delete config_;
+}
+
+std::string TranslationUnitContext::getInputFilePath() const
+{
+  return inputfile_path_;
+}
+
+std::string TranslationUnitContext::getInputFilename() const
+{
+  return inputfile_name_;
+}
+
+std::string TranslationUnitContext::getMutationDbFilename() const
+{
+  return mutdbfile_name_;
+}
+
+std::string TranslationUnitContext::getFunctionCacheFilename() const
+{
+  return function_cache_name_;
+}
+
+Configuration* TranslationUnitContext::getConfiguration()
+{
+  return config_;
+}
+
+MutantDatabase* TranslationUnitContext::getMutantDatabase()
+{
+  return mutant_database_;
+}
+
+MusicContext* TranslationUnitContext::getMusicContext()
+{
+  return music_context_;
+}
+
+InformationGatherer* TranslationUnitContext::getGatherer()
+{
+  return gatherer_;
+}
+
+MusicStats* TranslationUnitContext::getStats()
+{
+  return stats_;
+}
+
+std::vector<StmtMutantOperator*>& TranslationUnitContext::getStmtOperatorList()
+{
+  return stmt_operator_list_;
+}
+
+std::vector<ExprMutantOperator*>& TranslationUnitContext::getExprOperatorList()
+{
+  return expr_operator_list_;
+}
+
+void TranslationUnitContext::setConfiguration(Configuration *config)
+{
+  delete config_;
+  config_ = config;
+}
+
+void TranslationUnitContext::setMutantDatabase(MutantDatabase *mutant_database)
+{
+  delete mutant_database_;
+  mutant_database_ = mutant_database;
+}
+
+void TranslationUnitContext::setSymbolTable(SymbolTable *symbol_table)
+{
+  delete symbol_table_;
+  symbol_table_ = symbol_table;
+}
+
+void TranslationUnitContext::setMusicContext(MusicContext *music_context)
+{
+  delete music_context_;
+  music_context_ = music_context;
+}
+
+void TranslationUnitContext::setGatherer(InformationGatherer *gatherer)
+{
+  gatherer_ = gatherer;
+}
+
+void TranslationUnitContext::setStats(MusicStats *stats)
+{
+  stats_ = stats;
+}
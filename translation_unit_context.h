@@ -0,0 +1,74 @@
+#ifndef MUSIC_TRANSLATION_UNIT_CONTEXT_H_
+#define MUSIC_TRANSLATION_UNIT_CONTEXT_H_
+
+#include <string>
+#include <vector>
+
+#include "configuration.h"
+#include "symbol_table.h"
+#include "mutant_database.h"
+#include "music_context.h"
+#include "information_gatherer.h"
+#include "music_stats.h"
+#include "mutation_operators/expr_mutant_operator.h"
+#include "mutation_operators/stmt_mutant_operator.h"
+
+/**
+  Hold everything MUSIC creates while processing one input file, so that
+  input files can be processed concurrently without sharing state.
+
+  @param  inputfile_path_ path to input file as given on the command line
+          inputfile_name_ name of input file (string after the last slash)
+          mutdbfile_name_ name of mutation database file, with output
+                          directory prepended
+          function_cache_name_ name of function cache file of option
+                               -incremental, with output directory prepended
+          stats_ time spent on input file with option -phase-stats or
+                 -phase-stats-trace, nullptr otherwise
+*/
+class TranslationUnitContext
+{
+public:
+  TranslationUnitContext(std::string inputfile_path, std::string output_dir);
+  ~TranslationUnitContext();
+
+  // getters
+  std::string getInputFilePath() const;
+  std::string getInputFilename() const;
+  std::string getMutationDbFilename() const;
+  std::string getFunctionCacheFilename() const;
+  Configuration* getConfiguration();
+  MutantDatabase* getMutantDatabase();
+  MusicContext* getMusicContext();
+  InformationGatherer* getGatherer();
+  MusicStats* getStats();
+  std::vector<StmtMutantOperator*>& getStmtOperatorList();
+  std::vector<ExprMutantOperator*>& getExprOperatorList();
+
+  // setters. The context takes ownership of everything except the gatherer,
+  // which is owned by the ASTConsumer it is handed to.
+  void setConfiguration(Configuration *config);
+  void setMutantDatabase(MutantDatabase *mutant_database);
+  void setSymbolTable(SymbolTable *symbol_table);
+  void setMusicContext(MusicContext *music_context);
+  void setGatherer(InformationGatherer *gatherer);
+  void setStats(MusicStats *stats);
+
+private:
+  std::string inputfile_path_;
+  std::string inputfile_name_;
+  std::string mutdbfile_name_;
+  std::string function_cache_name_;
+
+  Configuration *config_;
+  MutantDatabase *mutant_database_;
+  SymbolTable *symbol_table_;
+  MusicContext *music_context_;
+  InformationGatherer *gatherer_;
+  MusicStats *stats_;
+
+  std::vector<StmtMutantOperator*> stmt_operator_list_;
+  std::vector<ExprMutantOperator*> expr_operator_list_;
+};
+
+#endif  // MUSIC_TRANSLATION_UNIT_CONTEXT_H_
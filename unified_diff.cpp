@@ -0,0 +1,253 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+#include "unified_diff.h"
+
+namespace {
+
+// Return file name of a "+++ " line, without "b/" prefix and timestamp.
+std::string GetNewFilename(const std::string &line)
+{
+  std::string filename{line.substr(4)};
+  size_t tab_pos = filename.find('\t');
+
+  if (tab_pos != std::string::npos)
+    filename.erase(tab_pos);
+
+  if (filename.compare(0, 2, "b/") == 0)
+    filename.erase(0, 2);
+
+  return filename;
+}
+
+// Parse "@@ -a[,b] +c[,d] @@" into old/new start line and line count.
+bool ParseHunkHeader(const std::string &line, int &old_count, int &new_start,
+                     int &new_count)
+{
+  int old_start;
+
+  old_count = 1;
+  new_count = 1;
+
+  if (sscanf(line.data(), "@@ -%d,%d +%d,%d @@", &old_start, &old_count,
+             &new_start, &new_count) == 4)
+    return true;
+
+  old_count = 1;
+
+  if (sscanf(line.data(), "@@ -%d +%d,%d @@", &old_start, &new_start,
+             &new_count) == 3)
+    return true;
+
+  new_count = 1;
+
+  if (sscanf(line.data(), "@@ -%d,%d +%d @@", &old_start, &old_count,
+             &new_start) == 3)
+    return true;
+
+  old_count = 1;
+  return sscanf(line.data(), "@@ -%d +%d @@", &old_start, &new_start) == 2;
+}
+
+// Sort changed lines and merge them into ranges.
+std::vector<LineRange> MakeLineRanges(std::vector<int> &lines)
+{
+  std::vector<LineRange> ranges;
+
+  std::sort(lines.begin(), lines.end());
+
+  for (auto line: lines)
+  {
+    if (!ranges.empty() && line <= ranges.back().end_line_ + 1)
+      ranges.back().end_line_ = std::max(ranges.back().end_line_, line);
+    else
+      ranges.push_back(LineRange{line, line});
+  }
+
+  return ranges;
+}
+
+std::string QuoteShellArgument(const std::string &arg)
+{
+  std::string quoted{"'"};
+
+  for (auto c: arg)
+  {
+    if (c == '\'')
+      quoted += "'\\''";
+    else
+      quoted += c;
+  }
+
+  return quoted + "'";
+}
+
+// Run command and return its standard output.
+bool ReadCommandOutput(const std::string &command, std::string &output)
+{
+  FILE *pipe = popen(command.data(), "r");
+
+  if (pipe == nullptr)
+    return false;
+
+  char buffer[4096];
+  size_t size;
+
+  output.clear();
+
+  while ((size = fread(buffer, 1, sizeof(buffer), pipe)) > 0)
+    output.append(buffer, size);
+
+  return pclose(pipe) == 0;
+}
+
+}  // namespace
+
+bool ParseUnifiedDiff(std::istream &diff, ChangedLineMap &changed_lines)
+{
+  std::map<std::string, std::vector<int>> lines_of_file;
+  std::vector<int> *lines = nullptr;
+  std::string line;
+
+  while (std::getline(diff, line))
+  {
+    if (line.compare(0, 4, "+++ ") == 0)
+    {
+      std::string filename{GetNewFilename(line)};
+
+      // Deleted file.
+      if (filename == "/dev/null")
+        lines = nullptr;
+      else
+        lines = &lines_of_file[filename];
+
+      continue;
+    }
+
+    if (line.compare(0, 3, "@@ ") != 0 || lines == nullptr)
+      continue;
+
+    int old_count, new_line, new_count;
+
+    if (!ParseHunkHeader(line, old_count, new_line, new_count))
+      return false;
+
+    // A hunk without new lines starts after the given line.
+    if (new_count == 0)
+      new_line++;
+
+    // Hunk body ends when both line counts are used up. Lines starting with
+    // "---" or "+++" inside it are removed or added lines.
+    while (old_count > 0 || new_count > 0)
+    {
+      if (!std::getline(diff, line))
+        return false;
+
+      if (line.empty() || line[0] == ' ')
+      {
+        old_count--;
+        new_count--;
+        new_line++;
+      }
+      else if (line[0] == '+')
+      {
+        lines->push_back(new_line);
+        new_count--;
+        new_line++;
+      }
+      else if (line[0] == '-')
+      {
+        if (new_line > 1)
+          lines->push_back(new_line - 1);
+
+        lines->push_back(new_line);
+        old_count--;
+      }
+      // "\ No newline at end of file"
+      else if (line[0] != '\\')
+        return false;
+    }
+  }
+
+  for (auto &it: lines_of_file)
+    changed_lines[it.first] = MakeLineRanges(it.second);
+
+  return true;
+}
+
+bool ReadUnifiedDiffFile(const std::string &diff_filename,
+                         ChangedLineMap &changed_lines)
+{
+  std::ifstream diff(diff_filename.data());
+
+  if (!diff.is_open())
+    return false;
+
+  return ParseUnifiedDiff(diff, changed_lines);
+}
+
+bool ReadGitDiff(const std::string &base_revision,
+                 ChangedLineMap &changed_lines)
+{
+  std::string top_level;
+  std::string diff_output;
+
+  // Prefixes are given explicitly, as diff.noprefix or diff.mnemonicPrefix
+  // in the user's git config would change them.
+  if (!ReadCommandOutput("git rev-parse --show-toplevel", top_level) ||
+      !ReadCommandOutput("git diff --no-color --no-ext-diff -U0 "
+                         "--src-prefix=a/ --dst-prefix=b/ " +
+                         QuoteShellArgument(base_revision) + " --",
+                         diff_output))
+    return false;
+
+  while (!top_level.empty() && top_level.back() == '\n')
+    top_level.pop_back();
+
+  ChangedLineMap relative_changed_lines;
+  std::istringstream diff(diff_output);
+
+  if (!ParseUnifiedDiff(diff, relative_changed_lines))
+    return false;
+
+  for (auto &it: relative_changed_lines)
+    changed_lines[top_level + "/" + it.first] = it.second;
+
+  return true;
+}
+
+const std::vector<LineRange>* FindChangedLines(
+    const ChangedLineMap &changed_lines, const std::string &path)
+{
+  auto exact = changed_lines.find(path);
+
+  if (exact != changed_lines.end())
+    return &exact->second;
+
+  for (auto &it: changed_lines)
+  {
+    const std::string &filename = it.first;
+
+    if (path.length() > filename.length() &&
+        path.compare(path.length() - filename.length(), filename.length(),
+                     filename) == 0 &&
+        path[path.length() - filename.length() - 1] == '/')
+      return &it.second;
+  }
+
+  return nullptr;
+}
+
+bool LinesOverlapRanges(const std::vector<LineRange> &ranges, int start_line,
+                        int end_line)
+{
+  // First range that does not end before start_line.
+  auto it = std::lower_bound(ranges.begin(), ranges.end(), start_line,
+                             [](const LineRange &range, int line)
+                             { return range.end_line_ < line; });
+
+  return it != ranges.end() && it->start_line_ <= end_line;
+}
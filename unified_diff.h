@@ -0,0 +1,62 @@
+#ifndef MUSIC_UNIFIED_DIFF_H_
+#define MUSIC_UNIFIED_DIFF_H_
+
+#include <istream>
+#include <map>
+#include <string>
+#include <vector>
+
+// Lines [start_line_, end_line_] of a file, counted from 1.
+struct LineRange
+{
+  int start_line_;
+  int end_line_;
+};
+
+// Changed lines of each file named in a diff, as sorted and disjoint ranges
+// of the new version of the file.
+typedef std::map<std::string, std::vector<LineRange>> ChangedLineMap;
+
+/**
+  Collect changed lines of the new version of each file in a unified diff
+  (as written by diff -u or git diff, with any number of context lines).
+
+  Added lines are changed lines. Where lines were only removed, the lines
+  just before and after the removal are marked changed, so that the
+  function the lines were removed from is still found. Deleted files are
+  left out. A leading "b/" is stripped from file names.
+
+  @param  diff unified diff
+          changed_lines output changed lines per file name
+  @return False if a hunk is malformed
+*/
+bool ParseUnifiedDiff(std::istream &diff, ChangedLineMap &changed_lines);
+
+// Read a unified diff file. Return false if it cannot be read or parsed.
+bool ReadUnifiedDiffFile(const std::string &diff_filename,
+                         ChangedLineMap &changed_lines);
+
+/**
+  Collect changes of the working tree against base_revision with git,
+  run in the current directory. File names are made absolute with the top
+  level directory of the git repository.
+
+  @return False if git fails
+*/
+bool ReadGitDiff(const std::string &base_revision,
+                 ChangedLineMap &changed_lines);
+
+/**
+  @param  path absolute path to a file
+  @return Changed lines of the file named path, or whose name in the diff
+          is a relative path that path ends with.
+          nullptr if the diff does not change the file
+*/
+const std::vector<LineRange>* FindChangedLines(
+    const ChangedLineMap &changed_lines, const std::string &path);
+
+// Return true if any line in [start_line, end_line] is in ranges.
+bool LinesOverlapRanges(const std::vector<LineRange> &ranges, int start_line,
+                        int end_line);
+
+#endif  // MUSIC_UNIFIED_DIFF_H_